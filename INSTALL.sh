@@ -213,6 +213,7 @@ echo "    vcf2eds            - Transform VCF to EDS/l-EDS"
 echo "  Utility tools:"
 echo "    edsparser-stats      - Show EDS statistics"
 echo "    edsparser-genpatterns - Generate random patterns"
+echo "    edsparser-index      - Build sidecar metadata indexes"
 echo ""
 if [ "$NEEDS_PATH_UPDATE" = true ]; then
     echo -e "${YELLOW}⚠ Action required:${NC} Add ~/.local/bin to PATH (see above)"
@@ -29,7 +29,7 @@ print_info() {
 }
 
 # Remove tools
-for tool in edsparser-transform edsparser-stats edsparser-genpatterns; do
+for tool in edsparser-transform edsparser-stats edsparser-genpatterns edsparser-index; do
     if [ -f "$HOME/.local/bin/$tool" ]; then
         rm -f "$HOME/.local/bin/$tool"
         print_status "Removed $tool from ~/.local/bin"
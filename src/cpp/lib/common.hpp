@@ -5,6 +5,7 @@
 #include <vector>
 #include <cstdint>
 #include <memory>
+#include <cstddef>
 
 namespace edsparser {
 
@@ -30,8 +31,10 @@ constexpr const char* EXT_VCF = ".vcf"; // Variant Call Format
 constexpr const char* EXT_EDS = ".eds"; // Elastic-Degenerate String
 constexpr const char* EXT_EDZ = ".edz"; // Sources of Elastic-Degenerate String - binary
 constexpr const char* EXT_SEDS = ".seds"; // Sources of Elastic-Degenerate String - simple
+constexpr const char* EXT_SEDZ = ".sedz"; // Sources of Elastic-Degenerate String - binary runs
 constexpr const char* EXT_LEDS = ".leds";   // Context-length limited EDS
 constexpr const char* EXT_EDP = ".edp"; // EDS Patterns
+constexpr const char* EXT_IDX = ".idx"; // Sidecar metadata index (appended to the EDS file name)
 
 // Error codes
 enum class ErrorCode {
@@ -63,6 +66,72 @@ private:
     std::unique_ptr<Impl> impl_;
 };
 
+/**
+ * Read-only memory mapping of a whole file
+ *
+ * Used by the parsers to tokenize large inputs in place instead of copying
+ * them into intermediate buffers. Empty files yield a valid mapping with
+ * data() == nullptr and size() == 0.
+ * Throws std::runtime_error if the file cannot be opened or mapped.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool is_open() const { return is_open_; }
+
+    // Hint the kernel that the mapping will be read front to back
+    void advise_sequential() const;
+
+    // Drop the resident pages of [0, end) (read-only file pages are re-read if touched again)
+    void drop_pages(size_t end) const;
+
+private:
+    void release();
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool is_open_ = false;
+};
+
+/**
+ * Read-only file opened for positional reads (pread)
+ *
+ * Used for on-demand symbol access in METADATA_ONLY mode: every read is a
+ * single pread at an absolute offset, so there is no shared seek position.
+ * Throws std::runtime_error if the file cannot be opened or read.
+ */
+class RandomAccessFile {
+public:
+    RandomAccessFile() = default;
+    explicit RandomAccessFile(const std::string& path);
+    ~RandomAccessFile();
+
+    RandomAccessFile(const RandomAccessFile&) = delete;
+    RandomAccessFile& operator=(const RandomAccessFile&) = delete;
+    RandomAccessFile(RandomAccessFile&& other) noexcept;
+    RandomAccessFile& operator=(RandomAccessFile&& other) noexcept;
+
+    bool is_open() const { return fd_ >= 0; }
+
+    // Read exactly count bytes starting at offset (throws on error or short file)
+    void read_at(uint64_t offset, void* buffer, size_t count) const;
+
+private:
+    void release();
+
+    int fd_ = -1;
+};
+
 /**
  * Get current process peak memory usage in MB
  * Returns 0.0 if unavailable (non-Linux platform or error reading /proc)
@@ -0,0 +1,70 @@
+#include "block_cache.hpp"
+#include <algorithm>
+
+namespace edsparser {
+
+template <typename Block>
+LruBlockCache<Block>::LruBlockCache(size_t budget_bytes, size_t num_shards)
+    : budget_bytes_(budget_bytes),
+      shard_budget_(budget_bytes / std::max<size_t>(num_shards, 1)),
+      shards_(std::max<size_t>(num_shards, 1)) {}
+
+template <typename Block>
+std::shared_ptr<const Block> LruBlockCache<Block>::get(size_t block_id, const Loader& load) {
+    Shard& shard = shards_[block_id % shards_.size()];
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(block_id);
+        if (it != shard.entries.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            hits_++;
+            return it->second->second;
+        }
+    }
+
+    // Decode outside the lock so that other blocks of the shard stay available
+    misses_++;
+    std::shared_ptr<const Block> block = load(block_id);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(block_id);
+    if (it != shard.entries.end()) {
+        // Another thread loaded it meanwhile
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->second;
+    }
+
+    shard.lru.emplace_front(block_id, block);
+    shard.entries.emplace(block_id, shard.lru.begin());
+    shard.bytes += block->bytes();
+
+    while (shard.bytes > shard_budget_ && shard.lru.size() > 1) {
+        const auto& victim = shard.lru.back();
+        shard.bytes -= victim.second->bytes();
+        shard.entries.erase(victim.first);
+        shard.lru.pop_back();
+        evictions_++;
+    }
+
+    return block;
+}
+
+template <typename Block>
+BlockCacheStats LruBlockCache<Block>::stats() const {
+    Stats stats{};
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.budget_bytes = budget_bytes_;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.resident_bytes += shard.bytes;
+    }
+    return stats;
+}
+
+template class LruBlockCache<SymbolBlock>;
+template class LruBlockCache<SourceBlock>;
+
+} // namespace edsparser
@@ -0,0 +1,120 @@
+#ifndef EDSPARSER_FORMATS_BLOCK_CACHE_HPP
+#define EDSPARSER_FORMATS_BLOCK_CACHE_HPP
+
+#include "../common.hpp"
+#include "source_set.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace edsparser {
+
+/**
+ * Decoded symbols of one cache block (SYMBOLS_PER_BLOCK consecutive symbols)
+ *
+ * The alternatives of all symbols are stored back to back in string-ID order,
+ * so a symbol is the range [symbol_offsets[k], symbol_offsets[k+1]) of chars
+ * split by its string lengths, string_lengths[symbol_strings[k] ..].
+ */
+struct SymbolBlock {
+    static constexpr size_t SYMBOLS_PER_BLOCK = 128;
+
+    String chars;
+    std::vector<size_t> symbol_offsets;  // Start of each symbol in chars (count+1 entries)
+    std::vector<size_t> symbol_strings;  // First string of each symbol in string_lengths (count+1 entries)
+    std::vector<Length> string_lengths;  // Lengths of all strings of the block
+
+    // Bytes charged against the cache budget
+    size_t bytes() const {
+        return sizeof(SymbolBlock) + chars.capacity() +
+               (symbol_offsets.capacity() + symbol_strings.capacity()) * sizeof(size_t) +
+               string_lengths.capacity() * sizeof(Length);
+    }
+};
+
+/**
+ * Decoded source sets of one block of consecutive strings (lazy METADATA_ONLY sources)
+ *
+ * sets[k] belongs to string block_id * SETS_PER_BLOCK + k.
+ */
+struct SourceBlock {
+    static constexpr size_t SETS_PER_BLOCK = 256;
+
+    std::vector<SourceSet> sets;
+
+    // Bytes charged against the cache budget
+    size_t bytes() const {
+        size_t total = sizeof(SourceBlock) + (sets.capacity() - sets.size()) * sizeof(SourceSet);
+        for (const auto& set : sets) {
+            total += set.bytes();
+        }
+        return total;
+    }
+};
+
+struct BlockCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t resident_bytes;
+    size_t budget_bytes;
+};
+
+/**
+ * Sharded LRU cache of decoded blocks with a byte budget
+ *
+ * Used by METADATA_ONLY EDS instances: symbol blocks when loaded with a cache
+ * budget, source blocks when sources are read on demand. Blocks are handed out
+ * as shared_ptr, so an evicted block stays valid for as long as a view still
+ * refers to it. Each shard has its own lock and an equal share of the budget;
+ * a shard always keeps its most recently used block, even if that block alone
+ * exceeds the share. Safe to use from several threads.
+ *
+ * Block must provide bytes(); instantiated for SymbolBlock and SourceBlock.
+ */
+template <typename Block>
+class LruBlockCache {
+public:
+    using Stats = BlockCacheStats;
+    using Loader = std::function<std::shared_ptr<const Block>(size_t block_id)>;
+
+    explicit LruBlockCache(size_t budget_bytes, size_t num_shards = 16);
+
+    // Cached block, or the loader's result (inserted, then least recently used blocks evicted)
+    std::shared_ptr<const Block> get(size_t block_id, const Loader& load);
+
+    Stats stats() const;
+
+private:
+    struct Shard {
+        using Entry = std::pair<size_t, std::shared_ptr<const Block>>;
+
+        mutable std::mutex mutex;
+        std::list<Entry> lru;  // Most recently used first
+        std::unordered_map<size_t, typename std::list<Entry>::iterator> entries;
+        size_t bytes = 0;
+    };
+
+    size_t budget_bytes_;
+    size_t shard_budget_;
+    std::vector<Shard> shards_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+extern template class LruBlockCache<SymbolBlock>;
+extern template class LruBlockCache<SourceBlock>;
+
+using BlockCache = LruBlockCache<SymbolBlock>;
+using SourceBlockCache = LruBlockCache<SourceBlock>;
+
+} // namespace edsparser
+
+#endif // EDSPARSER_FORMATS_BLOCK_CACHE_HPP
@@ -0,0 +1,112 @@
+#include "delimiter_scanner.hpp"
+#include "../common.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define EDSPARSER_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace edsparser {
+
+namespace {
+    inline bool is_delimiter(char ch) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        return c == static_cast<unsigned char>(SET_OPEN) ||
+               c == static_cast<unsigned char>(SET_CLOSE) ||
+               c == static_cast<unsigned char>(SET_SEPARATOR) ||
+               c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    uint64_t block_mask_scalar(const char* p) {
+        return delimiter_tail_mask(p, 64);
+    }
+
+#ifdef EDSPARSER_X86_KERNELS
+    // SSE4.2: explicit-length "equal any" compare against the delimiter set
+    __attribute__((target("sse4.2")))
+    uint64_t block_mask_sse42(const char* p) {
+        const __m128i set = _mm_setr_epi8(SET_OPEN, SET_CLOSE, SET_SEPARATOR, ' ',
+                                          '\t', '\n', '\v', '\f', '\r',
+                                          0, 0, 0, 0, 0, 0, 0);
+        constexpr int set_len = 9;
+        constexpr int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+
+        uint64_t mask = 0;
+        for (int i = 0; i < 4; i++) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+            __m128i hits = _mm_cmpestrm(set, set_len, block, 16, mode);
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_cvtsi128_si32(hits)) & 0xFFFFu) << (16 * i);
+        }
+        return mask;
+    }
+
+    // AVX2: byte-wise compares OR'ed together, 32 bytes per half
+    __attribute__((target("avx2")))
+    inline uint32_t half_mask_avx2(const char* p) {
+        const __m256i open = _mm256_set1_epi8(SET_OPEN);
+        const __m256i close = _mm256_set1_epi8(SET_CLOSE);
+        const __m256i separator = _mm256_set1_epi8(SET_SEPARATOR);
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i ctrl_span = _mm256_set1_epi8('\r' - '\t');
+
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, open), _mm256_cmpeq_epi8(block, close)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, separator), _mm256_cmpeq_epi8(block, space)));
+        // '\t'..'\r' is a contiguous range: (c - '\t') <= 4 as unsigned bytes
+        __m256i shifted = _mm256_sub_epi8(block, tab);
+        hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, ctrl_span), shifted));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+    }
+
+    __attribute__((target("avx2")))
+    uint64_t block_mask_avx2(const char* p) {
+        return static_cast<uint64_t>(half_mask_avx2(p)) |
+               (static_cast<uint64_t>(half_mask_avx2(p + 32)) << 32);
+    }
+#endif
+
+    struct KernelChoice {
+        DelimiterBlockKernel kernel;
+        const char* name;
+    };
+
+    KernelChoice select_kernel() {
+#ifdef EDSPARSER_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return {block_mask_avx2, "avx2"};
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return {block_mask_sse42, "sse4.2"};
+        }
+#endif
+        return {block_mask_scalar, "scalar"};
+    }
+
+    const KernelChoice& kernel_choice() {
+        static const KernelChoice choice = select_kernel();
+        return choice;
+    }
+} // anonymous namespace
+
+uint64_t delimiter_tail_mask(const char* p, size_t len) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (is_delimiter(p[i])) {
+            mask |= uint64_t(1) << i;
+        }
+    }
+    return mask;
+}
+
+DelimiterBlockKernel delimiter_block_kernel() {
+    return kernel_choice().kernel;
+}
+
+const char* delimiter_scanner_name() {
+    return kernel_choice().name;
+}
+
+} // namespace edsparser
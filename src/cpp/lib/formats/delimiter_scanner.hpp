@@ -0,0 +1,82 @@
+#ifndef EDSPARSER_FORMATS_DELIMITER_SCANNER_HPP
+#define EDSPARSER_FORMATS_DELIMITER_SCANNER_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace edsparser {
+
+/**
+ * Delimiter scanning kernel for EDS and sEDS tokenization
+ *
+ * Classifies input in 64-byte blocks: bit i of a block mask is set when byte i
+ * is a structural byte ('{', '}', ',') or ASCII whitespace
+ * (' ', '\t', '\n', '\v', '\f', '\r'). The block kernel is picked once at
+ * runtime from the CPU features: AVX2 (2 x 32 bytes), SSE4.2 (4 x 16 bytes)
+ * or a portable scalar loop.
+ *
+ * Dense inputs (1-bp SNP alternatives) hit a delimiter every few bytes, so the
+ * cursor walks set bits of the cached mask instead of calling a kernel per token.
+ */
+
+// Mask of delimiter bytes in p[0..63] (all 64 bytes must be readable)
+using DelimiterBlockKernel = uint64_t (*)(const char* p);
+
+// Kernel selected for this CPU and its name ("avx2", "sse4.2" or "scalar")
+DelimiterBlockKernel delimiter_block_kernel();
+const char* delimiter_scanner_name();
+
+// Mask of delimiter bytes in p[0..len-1], len < 64 (buffer tail)
+uint64_t delimiter_tail_mask(const char* p, size_t len);
+
+/**
+ * Forward cursor over the delimiters of one buffer.
+ * next() must be called with non-decreasing positions.
+ */
+class DelimiterScanner {
+public:
+    DelimiterScanner(const char* begin, const char* end)
+        : end_(end), block_(begin), kernel_(delimiter_block_kernel()) {
+        load_block();
+    }
+
+    // First delimiter or whitespace byte in [p, end), or end if there is none
+    const char* next(const char* p) {
+        while (p < end_) {
+            while (p >= block_ + 64) {
+                block_ += 64;
+                load_block();
+            }
+            uint64_t pending = mask_ & (~uint64_t(0) << (p - block_));
+            if (pending != 0) {
+                return block_ + __builtin_ctzll(pending);
+            }
+            p = block_ + 64;
+        }
+        return end_;
+    }
+
+private:
+    void load_block() {
+        size_t remaining = static_cast<size_t>(end_ - block_);
+        mask_ = remaining >= 64 ? kernel_(block_)
+                                : delimiter_tail_mask(block_, remaining);
+    }
+
+    const char* end_;
+    const char* block_;
+    uint64_t mask_ = 0;
+    DelimiterBlockKernel kernel_;
+};
+
+/**
+ * Return a pointer to the first delimiter or whitespace byte in [p, end),
+ * or end if there is none. Convenience wrapper for one-off lookups.
+ */
+inline const char* find_delimiter(const char* p, const char* end) {
+    return DelimiterScanner(p, end).next(p);
+}
+
+} // namespace edsparser
+
+#endif // EDSPARSER_FORMATS_DELIMITER_SCANNER_HPP
@@ -1,9 +1,16 @@
 #include "eds.hpp"
+#include "delimiter_scanner.hpp"
+#include "seds.hpp"
 #include <sstream>
 #include <stdexcept>
 #include <algorithm>
-#include <cctype>
 #include <random>
+#include <iterator>
+#include <charconv>
+#include <cstring>
+#include <numeric>
+#include <future>
+#include <exception>
 
 namespace edsparser {
 
@@ -37,111 +44,345 @@ EDS::EDS(const std::string& eds_string, const std::string& seds_string) : is_emp
 }
 
 void EDS::parse(std::istream& is) {
-    // Read entire input into string for easier parsing
-    std::stringstream buffer;
-    buffer << is.rdbuf();
-    std::string input = buffer.str();
+    // Streams cannot be mapped, so read them once and tokenize the buffer in place
+    std::string input{std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()};
+    parse_buffer(input.data(), input.size());
+}
 
-    // Remove whitespace
-    input.erase(std::remove_if(input.begin(), input.end(), ::isspace), input.end());
+namespace {
+    // ASCII whitespace, same set as std::isspace in the "C" locale
+    inline bool is_space(char ch) {
+        return ch == ' ' || (ch >= '\t' && ch <= '\r');
+    }
 
-    if (input.empty()) {
-        is_empty_ = true;
-        n_ = 0;
-        N_ = 0;
-        m_ = 0;
-        return;
+    // Split the bytes of one symbol (bracketed set or compact run, whitespace allowed) into its strings
+    StringSet decode_symbol_span(const char* p, const char* end, size_t symbol_size) {
+        StringSet result;
+        result.reserve(symbol_size);
+
+        while (p < end && is_space(*p)) {
+            p++;
+        }
+        bool bracketed = (p < end && *p == SET_OPEN);
+        if (bracketed) {
+            p++;
+        }
+
+        String current;
+        for (; p < end; p++) {
+            char ch = *p;
+            if (ch == SET_SEPARATOR) {
+                result.push_back(std::move(current));
+                current.clear();
+            } else if (bracketed && ch == SET_CLOSE) {
+                break;
+            } else if (!is_space(ch)) {
+                current += ch;
+            }
+        }
+        result.push_back(std::move(current));
+        return result;
     }
 
-    // Normalize compact format to full bracketed format
-    // This allows both "ACGT{A,ACA}CGT" and "{ACGT}{A,ACA}{CGT}" to work
-    input = normalize_eds_format(input);
+    // Decoded alternatives of one symbol, owned by the views that refer to it
+    struct DecodedSymbol {
+        String chars;
+        std::vector<Length> lengths;  // Only filled when the metadata is succinct
+    };
 
-    // Parse EDS format: {str1,str2,...}{str3}{str4,str5}...
-    size_t pos = 0;
-    n_ = 0;      // Number of sets
-    N_ = 0;      // Total characters
-    m_ = 0;      // Cardinality (total strings)
+    // Append the characters of one symbol span to out, returns the number of strings in it
+    size_t append_symbol_chars(const char* p, const char* end, String& out) {
+        while (p < end && is_space(*p)) {
+            p++;
+        }
+        bool bracketed = (p < end && *p == SET_OPEN);
+        if (bracketed) {
+            p++;
+        }
 
-    // Clear all data structures
-    sets_.clear();
-    metadata_.base_positions.clear();
-    metadata_.symbol_sizes.clear();
-    metadata_.string_lengths.clear();
-    metadata_.cum_set_sizes.clear();
-    metadata_.is_degenerate.clear();
+        size_t strings = 1;
+        for (; p < end; p++) {
+            char ch = *p;
+            if (ch == SET_SEPARATOR) {
+                strings++;
+            } else if (bracketed && ch == SET_CLOSE) {
+                break;
+            } else if (!is_space(ch)) {
+                out += ch;
+            }
+        }
+        return strings;
+    }
+}
 
-    while (pos < input.length()) {
-        // Record starting position of this symbol
-        std::streampos symbol_start = static_cast<std::streampos>(pos);
-        metadata_.base_positions.push_back(symbol_start);
+namespace {
+    // Symbols and strings of one chunk of a text EDS (see parse_chunk)
+    struct ParsedChunk {
+        std::vector<std::streampos> base_positions;  // Byte offsets in the whole buffer
+        std::vector<Length> symbol_byte_lengths;
+        std::vector<Length> symbol_sizes;
+        std::vector<Length> string_lengths;
+        std::vector<Length> cum_set_sizes;           // Relative to the first string of the chunk
+        std::vector<bool> is_degenerate;
+        String arena;                                // FULL mode only
+        std::vector<Position> string_offsets;        // FULL mode only, relative to the chunk arena
+        size_t chars = 0;
+    };
+
+    // Inputs smaller than this per thread are parsed in one piece
+    constexpr size_t MIN_PARSE_CHUNK = size_t(1) << 20;
 
-        // Expect '{'
-        if (input[pos] != SET_OPEN) {
-            throw std::runtime_error("Expected '{' at position " + std::to_string(pos));
+    /*
+     * Split [data, data + size) into at most `chunks` pieces that can be parsed
+     * independently. Every cut is placed on a '{': it never occurs inside a
+     * set, so it always starts a new symbol (and ends a compact run), and the
+     * sequential parse stops at it in exactly the same way, errors included.
+     */
+    std::vector<const char*> split_at_symbols(const char* data, size_t size, size_t chunks) {
+        const char* const end = data + size;
+        std::vector<const char*> bounds{data};
+        for (size_t i = 1; i < chunks; i++) {
+            const char* target = std::max(data + size / chunks * i, bounds.back());
+            const char* cut = static_cast<const char*>(std::memchr(target, SET_OPEN, end - target));
+            if (cut == nullptr) {
+                break;
+            }
+            if (cut > bounds.back()) {
+                bounds.push_back(cut);
+            }
+        }
+        bounds.push_back(end);
+        return bounds;
+    }
+
+    /*
+     * Single pass over [chunk_begin, chunk_end), no intermediate copies.
+     * Positions (base_positions, error messages) are relative to begin, the
+     * start of the whole buffer.
+     */
+    void parse_chunk(const char* begin, const char* chunk_begin, const char* end,
+                     bool store_strings, ParsedChunk& out) {
+        const char* p = chunk_begin;
+        DelimiterScanner scanner(chunk_begin, end);
+        size_t strings = 0;
+
+        if (store_strings) {
+            out.arena.reserve(end - chunk_begin);  // Input size bounds the character count
+            out.string_offsets.push_back(0);
         }
-        pos++; // Skip '{'
 
-        // Parse strings within this set
-        StringSet current_set;
-        std::string current_string;
-        size_t symbol_size = 0;
+        while (true) {
+            // Skip whitespace between symbols
+            while (p < end && is_space(*p)) {
+                p++;
+            }
+            if (p == end) {
+                break;
+            }
+
+            size_t symbol_start = static_cast<size_t>(p - begin);
+            out.base_positions.push_back(static_cast<std::streampos>(symbol_start));
+
+            // A bracketed set ends at '}'; a compact run ends before the next '{' or at EOF
+            bool bracketed = (*p == SET_OPEN);
+            if (bracketed) {
+                p++; // Skip '{'
+            } else if (*p == SET_CLOSE) {
+                throw std::runtime_error("Expected '{' at position " + std::to_string(symbol_start));
+            }
 
-        while (pos < input.length() && input[pos] != SET_CLOSE) {
-            if (input[pos] == SET_SEPARATOR) {
-                // End of current string
-                Length str_len = current_string.length();
-                metadata_.string_lengths.push_back(str_len);
-                N_ += str_len;
+            size_t symbol_size = 0;
+
+            while (true) {
+                // Scan one string up to the next separator or symbol terminator
+                const char* str_begin = p;
+                size_t whitespace = 0;
+                p = scanner.next(p);
+                while (p < end && is_space(*p)) {
+                    // Line-wrapped or padded input: whitespace is not part of the string
+                    whitespace++;
+                    p = scanner.next(p + 1);
+                }
+
+                Length str_len = static_cast<Length>((p - str_begin) - whitespace);
+                out.string_lengths.push_back(str_len);
+                out.chars += str_len;
                 symbol_size++;
 
                 // Only store string if FULL mode
-                if (mode_ == StoringMode::FULL) {
-                    current_set.push_back(current_string);
+                if (store_strings) {
+                    if (whitespace == 0) {
+                        out.arena.append(str_begin, p);
+                    } else {
+                        for (const char* c = str_begin; c < p; c++) {
+                            if (!is_space(*c)) {
+                                out.arena += *c;
+                            }
+                        }
+                    }
+                    out.string_offsets.push_back(out.arena.size());
                 }
 
-                current_string.clear();
-                pos++;
-            } else {
-                // Regular character, add to current string
-                current_string += input[pos];
-                pos++;
+                if (p < end && *p == SET_SEPARATOR) {
+                    p++;
+                    continue;
+                }
+
+                if (bracketed) {
+                    // Expect '}'
+                    if (p >= end || *p != SET_CLOSE) {
+                        throw std::runtime_error("Expected '}' at position " + std::to_string(p - begin));
+                    }
+                    p++; // Skip '}'
+                } else if (p < end && *p == SET_CLOSE) {
+                    throw std::runtime_error("Expected '{' at position " + std::to_string(p - begin));
+                }
+                break;
             }
-        }
 
-        // Add last string in set (could be empty)
-        Length str_len = current_string.length();
-        metadata_.string_lengths.push_back(str_len);
-        N_ += str_len;
-        symbol_size++;
+            // Store metadata
+            out.symbol_byte_lengths.push_back(static_cast<Length>((p - begin) - symbol_start));
+            out.symbol_sizes.push_back(symbol_size);
+            out.cum_set_sizes.push_back(strings);  // Cumulative count before adding this set
+            out.is_degenerate.push_back(symbol_size > 1);
 
-        if (mode_ == StoringMode::FULL) {
-            current_set.push_back(current_string);
+            strings += symbol_size;
         }
 
-        // Expect '}'
-        if (pos >= input.length() || input[pos] != SET_CLOSE) {
-            throw std::runtime_error("Expected '}' at position " + std::to_string(pos));
+        // Drop the slack left by delimiters and whitespace
+        if (store_strings) {
+            out.arena.shrink_to_fit();
         }
-        pos++; // Skip '}'
+    }
+}
+
+void EDS::parse_buffer(const char* data, size_t size, size_t threads) {
+    /*
+     * Accepts both formats:
+     *   "{ACGT}{A,ACA}{CGT}"  full format (every symbol bracketed)
+     *   "ACGT{A,ACA}CGT"      compact format (bare runs are non-degenerate symbols)
+     * Whitespace anywhere in the input is ignored. base_positions record the
+     * byte offset of each symbol's first character in the input.
+     * Binary .edz containers are recognized by their magic and decoded instead.
+     *
+     * With threads > 1 the input is cut at symbol boundaries, the chunks are
+     * parsed concurrently and their results stitched together: the per-chunk
+     * symbol, string and character totals are prefix-summed, then every chunk
+     * copies its arrays to its offset in parallel, shifting its string IDs
+     * and arena offsets.
+     */
 
-        // Validate set is not empty
-        if (symbol_size == 0) {
-            throw std::runtime_error("Empty set at position " + std::to_string(pos));
+    if (edz::is_edz(data, size)) {
+        parse_edz(data, size);
+        return;
+    }
+
+    bool store_strings = (mode_ == StoringMode::FULL);
+    size_t chunks = std::max<size_t>(1, std::min(threads, size / MIN_PARSE_CHUNK));
+    std::vector<const char*> bounds = split_at_symbols(data, size, chunks);
+    std::vector<ParsedChunk> parts(bounds.size() - 1);
+
+    if (parts.size() == 1) {
+        parse_chunk(data, bounds[0], bounds[1], store_strings, parts[0]);
+    } else {
+        // Rethrow the error of the first failing chunk, which is the one a sequential parse reports
+        std::vector<std::exception_ptr> errors(parts.size());
+#ifdef _OPENMP
+        #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+#endif
+        for (size_t c = 0; c < parts.size(); c++) {
+            try {
+                parse_chunk(data, bounds[c], bounds[c + 1], store_strings, parts[c]);
+            } catch (...) {
+                errors[c] = std::current_exception();
+            }
         }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    // Clear all data structures
+    arena_.clear();
+    string_offsets_.clear();
+    metadata_.base_positions.clear();
+    metadata_.symbol_byte_lengths.clear();
+    metadata_.symbol_sizes.clear();
+    metadata_.string_lengths.clear();
+    metadata_.cum_set_sizes.clear();
+    metadata_.is_degenerate.clear();
 
-        // Store metadata
-        metadata_.symbol_sizes.push_back(symbol_size);
-        metadata_.cum_set_sizes.push_back(m_);  // Cumulative count before adding this set
-        metadata_.is_degenerate.push_back(symbol_size > 1);
+    if (parts.size() == 1) {
+        // Already in global numbering
+        ParsedChunk& part = parts[0];
+        n_ = part.symbol_sizes.size();
+        m_ = part.string_lengths.size();
+        N_ = part.chars;
+        metadata_.base_positions = std::move(part.base_positions);
+        metadata_.symbol_byte_lengths = std::move(part.symbol_byte_lengths);
+        metadata_.symbol_sizes = std::move(part.symbol_sizes);
+        metadata_.string_lengths = std::move(part.string_lengths);
+        metadata_.cum_set_sizes = std::move(part.cum_set_sizes);
+        metadata_.is_degenerate = std::move(part.is_degenerate);
+        arena_ = std::move(part.arena);
+        string_offsets_ = std::move(part.string_offsets);
+    } else {
+        // Offsets of each chunk's symbols, strings and arena characters
+        std::vector<size_t> symbol_base(parts.size() + 1, 0);
+        std::vector<size_t> string_base(parts.size() + 1, 0);
+        std::vector<size_t> char_base(parts.size() + 1, 0);
+        for (size_t c = 0; c < parts.size(); c++) {
+            symbol_base[c + 1] = symbol_base[c] + parts[c].symbol_sizes.size();
+            string_base[c + 1] = string_base[c] + parts[c].string_lengths.size();
+            char_base[c + 1] = char_base[c] + parts[c].chars;
+        }
+        n_ = symbol_base.back();
+        m_ = string_base.back();
+        N_ = char_base.back();
+
+        metadata_.base_positions.resize(n_);
+        metadata_.symbol_byte_lengths.resize(n_);
+        metadata_.symbol_sizes.resize(n_);
+        metadata_.string_lengths.resize(m_);
+        metadata_.cum_set_sizes.resize(n_);
+        if (store_strings) {
+            arena_.resize(N_);
+            string_offsets_.resize(m_ + 1);
+            string_offsets_[0] = 0;
+        }
 
-        // Store full data if FULL mode
-        if (mode_ == StoringMode::FULL) {
-            sets_.push_back(current_set);
+#ifdef _OPENMP
+        #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+#endif
+        for (size_t c = 0; c < parts.size(); c++) {
+            ParsedChunk& part = parts[c];
+            std::copy(part.base_positions.begin(), part.base_positions.end(),
+                      metadata_.base_positions.begin() + symbol_base[c]);
+            std::copy(part.symbol_byte_lengths.begin(), part.symbol_byte_lengths.end(),
+                      metadata_.symbol_byte_lengths.begin() + symbol_base[c]);
+            std::copy(part.symbol_sizes.begin(), part.symbol_sizes.end(),
+                      metadata_.symbol_sizes.begin() + symbol_base[c]);
+            std::copy(part.string_lengths.begin(), part.string_lengths.end(),
+                      metadata_.string_lengths.begin() + string_base[c]);
+            for (size_t i = 0; i < part.cum_set_sizes.size(); i++) {
+                metadata_.cum_set_sizes[symbol_base[c] + i] = static_cast<Length>(part.cum_set_sizes[i] + string_base[c]);
+            }
+            if (store_strings) {
+                std::copy(part.arena.begin(), part.arena.end(), arena_.begin() + char_base[c]);
+                for (size_t i = 1; i < part.string_offsets.size(); i++) {
+                    string_offsets_[string_base[c] + i] = part.string_offsets[i] + char_base[c];
+                }
+            }
+            part = ParsedChunk();
         }
 
-        m_ += symbol_size;
-        n_++;
+        // Bits of neighbouring chunks share words, so this one is appended in order
+        metadata_.is_degenerate.reserve(n_);
+        for (size_t i = 0; i < n_; i++) {
+            metadata_.is_degenerate.push_back(metadata_.symbol_sizes[i] > 1);
+        }
     }
 
     // Validate we parsed something
@@ -150,8 +391,119 @@ void EDS::parse(std::istream& is) {
     } else {
         is_empty_ = false;
         // Calculate statistics from metadata
+        calculate_statistics(threads);
+    }
+}
+
+void EDS::parse_edz(const char* data, size_t size) {
+    edz::Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != edz::VERSION) {
+        throw std::runtime_error("EDZ: Unsupported version " + std::to_string(header.version));
+    }
+    if (header.n > size || header.m > size || header.num_escape_runs > size ||
+        header.num_source_ids > size || header.N / 4 > size) {
+        throw std::runtime_error("EDZ: Truncated file");
+    }
+
+    // Sections follow the header back to back, each padded to 8 bytes
+    size_t offset = sizeof(header);
+    auto section = [&](size_t bytes) {
+        const char* start = data + offset;
+        offset += edz::padded(bytes);
+        if (offset > size) {
+            throw std::runtime_error("EDZ: Truncated file");
+        }
+        return start;
+    };
+    // An empty vector's data() may be null, which memcpy must not get even for 0 bytes
+    auto read_array = [&](auto& vec, size_t count) {
+        vec.resize(count);
+        const char* start = section(count * sizeof(vec[0]));
+        if (count > 0) {
+            std::memcpy(vec.data(), start, count * sizeof(vec[0]));
+        }
+    };
+
+    n_ = header.n;
+    m_ = header.m;
+    N_ = header.N;
+
+    read_array(metadata_.symbol_sizes, n_);
+    read_array(metadata_.string_lengths, m_);
+
+    escapes_ = edz::EscapeRuns();
+    read_array(escapes_.starts, header.num_escape_runs);
+    read_array(escapes_.lengths, header.num_escape_runs);
+    escapes_.chars.assign(section(header.num_escape_runs), header.num_escape_runs);
+
+    if (header.flags & edz::FLAG_SOURCES) {
+        std::vector<uint32_t> counts;
+        std::vector<int32_t> ids;
+        read_array(counts, m_);
+        read_array(ids, header.num_source_ids);
+
+        try {
+            sources_ = SourceTable(counts, ids);
+        } catch (const std::invalid_argument&) {
+            throw std::runtime_error("EDZ: Inconsistent sources section");
+        }
+        has_sources_ = true;
+    }
+
+    const char* payload = section(edz::payload_bytes(N_));
+    payload_offset_ = static_cast<std::streamoff>(payload - data);
+
+    // Derive the rest of the index (base_positions become payload character offsets)
+    metadata_.base_positions.resize(n_);
+    metadata_.symbol_byte_lengths.resize(n_);
+    metadata_.cum_set_sizes.resize(n_);
+    metadata_.is_degenerate.resize(n_);
+    size_t string_id = 0;
+    Position chars = 0;
+    for (size_t i = 0; i < n_; i++) {
+        Length symbol_size = metadata_.symbol_sizes[i];
+        if (symbol_size == 0 || symbol_size > m_ - string_id) {
+            throw std::runtime_error("EDZ: Inconsistent symbol sizes");
+        }
+        metadata_.base_positions[i] = static_cast<std::streampos>(chars);
+        metadata_.cum_set_sizes[i] = string_id;
+        metadata_.is_degenerate[i] = symbol_size > 1;
+        Position symbol_start = chars;
+        for (Length j = 0; j < symbol_size; j++) {
+            chars += metadata_.string_lengths[string_id++];
+        }
+        metadata_.symbol_byte_lengths[i] = static_cast<Length>(chars - symbol_start);
+    }
+    if (string_id != m_ || chars != N_) {
+        throw std::runtime_error("EDZ: Inconsistent string lengths");
+    }
+
+    arena_.clear();
+    string_offsets_.clear();
+    if (mode_ == StoringMode::FULL) {
+        // Decode the whole payload straight into the arena
+        arena_.resize(N_);
+        edz::unpack(reinterpret_cast<const uint8_t*>(payload), 0, N_, arena_.data());
+        escapes_.apply(0, N_, arena_.data());
+        escapes_ = edz::EscapeRuns();
+
+        string_offsets_.resize(m_ + 1);
+        string_offsets_[0] = 0;
+        std::partial_sum(metadata_.string_lengths.begin(), metadata_.string_lengths.end(),
+                         string_offsets_.begin() + 1,
+                         [](Position acc, Length len) { return acc + len; });
+    } else {
+        packed_ = true;
+    }
+
+    is_empty_ = (n_ == 0);
+    if (!is_empty_) {
         calculate_statistics();
     }
+    if (has_sources_) {
+        calculate_source_statistics();
+    }
 }
 
 // ================================================================================
@@ -173,7 +525,7 @@ EDS EDS::from_string(const std::string& eds_string, const std::string& seds_stri
 // ================================================================================
 
 // Load EDS from file (with optional StoringMode)
-EDS EDS::load(const std::filesystem::path& path, StoringMode mode) {
+EDS EDS::load(const std::filesystem::path& path, StoringMode mode, size_t cache_budget, size_t threads) {
     EDS eds;
     eds.mode_ = mode;
     eds.is_empty_ = false;
@@ -184,17 +536,15 @@ EDS EDS::load(const std::filesystem::path& path, StoringMode mode) {
         eds.file_path_ = path;
     }
 
-    std::ifstream ifs(path);
-    if (!ifs) {
-        throw std::runtime_error("Failed to open file: " + path.string());
-    }
-    eds.parse(ifs);
+    eds.parse_file(path, threads);
 
-    // For METADATA_ONLY, reopen file and keep stream open
+    // For METADATA_ONLY, keep the file open for on-demand symbol reads
     if (mode == StoringMode::METADATA_ONLY) {
-        eds.stream_.open(path);
-        if (!eds.stream_) {
-            throw std::runtime_error("Failed to reopen file for streaming: " + path.string());
+        eds.file_ = RandomAccessFile(path.string());
+        if (cache_budget > 0) {
+            eds.cache_ = std::make_unique<BlockCache>(cache_budget);
+        } else if (!eds.packed_) {
+            eds.mapping_ = MappedFile(path.string());
         }
     }
 
@@ -202,7 +552,8 @@ EDS EDS::load(const std::filesystem::path& path, StoringMode mode) {
 }
 
 // Load EDS from file with sources from file (with optional StoringMode)
-EDS EDS::load(const std::filesystem::path& eds_path, const std::filesystem::path& seds_path, StoringMode mode) {
+EDS EDS::load(const std::filesystem::path& eds_path, const std::filesystem::path& seds_path, StoringMode mode,
+              size_t cache_budget, size_t threads) {
     EDS eds;
     eds.mode_ = mode;
     eds.is_empty_ = false;
@@ -213,29 +564,265 @@ EDS EDS::load(const std::filesystem::path& eds_path, const std::filesystem::path
         eds.file_path_ = eds_path;
     }
 
-    std::ifstream eds_ifs(eds_path);
-    if (!eds_ifs) {
-        throw std::runtime_error("Failed to open EDS file: " + eds_path.string());
-    }
-    eds.parse(eds_ifs);
-
-    std::ifstream seds_ifs(seds_path);
-    if (!seds_ifs) {
-        throw std::runtime_error("Failed to open sEDS file: " + seds_path.string());
+    if (mode == StoringMode::METADATA_ONLY) {
+        // Sources are indexed for on-demand decoding instead of being loaded
+        size_t source_budget = cache_budget > 0 ? cache_budget : SourceIndex::DEFAULT_CACHE_BUDGET;
+        if (threads > 1) {
+            std::future<std::unique_ptr<SourceIndex>> index = std::async(std::launch::async, [&]() {
+                return std::make_unique<SourceIndex>(seds_path, source_budget);
+            });
+            eds.parse_file(eds_path, threads - 1);
+            eds.assign_source_index(index.get());
+        } else {
+            eds.parse_file(eds_path);
+            eds.assign_source_index(std::make_unique<SourceIndex>(seds_path, source_budget));
+        }
+    } else {
+        MappedFile mapped(seds_path.string());
+        mapped.advise_sequential();
+
+        if (threads > 1) {
+            // Tokenize the sEDS on its own thread while the EDS is parsed with the others;
+            // the source count can only be checked once both are done
+            std::future<SourceTable> sources = std::async(std::launch::async, [&mapped]() {
+                return seds::parse(mapped.data(), mapped.size());
+            });
+            eds.parse_file(eds_path, threads - 1);
+            eds.assign_sources(sources.get());
+        } else {
+            eds.parse_file(eds_path);
+            eds.parse_sources_buffer(mapped.data(), mapped.size());
+        }
     }
-    eds.parse_sources(seds_ifs);
 
-    // For METADATA_ONLY, reopen file and keep stream open
+    // For METADATA_ONLY, keep the file open for on-demand symbol reads
     if (mode == StoringMode::METADATA_ONLY) {
-        eds.stream_.open(eds_path);
-        if (!eds.stream_) {
-            throw std::runtime_error("Failed to reopen file for streaming: " + eds_path.string());
+        eds.file_ = RandomAccessFile(eds_path.string());
+        if (cache_budget > 0) {
+            eds.cache_ = std::make_unique<BlockCache>(cache_budget);
+        } else if (!eds.packed_) {
+            eds.mapping_ = MappedFile(eds_path.string());
         }
     }
 
     return eds;
 }
 
+namespace {
+    // Whether data holds a complete index of the current version for a file with this stamp
+    bool read_index_header(const char* data, size_t size, const eds_index::FileStamp& stamp,
+                           eds_index::Header& header) {
+        if (size < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, eds_index::MAGIC, sizeof(eds_index::MAGIC)) != 0 ||
+            header.version != eds_index::VERSION || !(header.stamp == stamp)) {
+            return false;
+        }
+
+        // A truncated index falls back to parsing
+        size_t n = header.n;
+        size_t m = header.m;
+        if (n > size || m > size) {
+            return false;
+        }
+        size_t expected = sizeof(header) +
+            edz::padded(n * 8) + edz::padded(n * 4) + edz::padded(n * 4) + edz::padded(m * 4) +
+            edz::padded(n * 4) + edz::padded((n + 1) * 8) + edz::padded((n + 1) * 4);
+        return size == expected;
+    }
+}
+
+void EDS::parse_file(const std::filesystem::path& path, size_t threads) {
+    if (mode_ != StoringMode::METADATA_ONLY) {
+        // Tokenize the mapped file in place (no intermediate copies)
+        MappedFile mapped(path.string());
+        mapped.advise_sequential();
+        parse_buffer(mapped.data(), mapped.size(), threads);
+        return;
+    }
+
+    // METADATA_ONLY: the sidecar index replaces the scan while it matches the file
+    eds_index::FileStamp stamp = eds_index::stamp_file(path);
+    std::filesystem::path index_path = eds_index::sidecar_path(path);
+    if (load_index(index_path, stamp)) {
+        return;
+    }
+
+    {
+        MappedFile mapped(path.string());
+        mapped.advise_sequential();
+        parse_buffer(mapped.data(), mapped.size(), threads);
+    }
+
+    // .edz already loads in O(metadata), only text files get a sidecar
+    if (!packed_) {
+        try {
+            save_index(index_path, stamp);
+        } catch (const std::exception&) {
+            // Best effort: read-only directories simply keep parsing
+        }
+    }
+}
+
+bool EDS::load_index(const std::filesystem::path& index_path, const eds_index::FileStamp& stamp) {
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(index_path, ec)) {
+        return false;
+    }
+
+    MappedFile mapped;
+    try {
+        mapped = MappedFile(index_path.string());
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    const char* data = mapped.data();
+    eds_index::Header header;
+    if (!read_index_header(data, mapped.size(), stamp, header)) {
+        return false;
+    }
+    size_t n = header.n;
+    size_t m = header.m;
+
+    size_t offset = sizeof(header);
+    auto read_array = [&](auto& vec, size_t count) {
+        vec.resize(count);
+        if (count > 0) {
+            std::memcpy(vec.data(), data + offset, count * sizeof(vec[0]));
+        }
+        offset += edz::padded(count * sizeof(vec[0]));
+    };
+
+    std::vector<uint64_t> base_positions;
+    read_array(base_positions, n);
+    metadata_.base_positions.assign(base_positions.begin(), base_positions.end());
+    read_array(metadata_.symbol_byte_lengths, n);
+    read_array(metadata_.symbol_sizes, n);
+    read_array(metadata_.string_lengths, m);
+    read_array(metadata_.cum_set_sizes, n);
+    read_array(metadata_.cum_common_positions, n + 1);
+    read_array(metadata_.cum_degenerate_counts, n + 1);
+
+    metadata_.is_degenerate.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        metadata_.is_degenerate[i] = metadata_.symbol_sizes[i] > 1;
+    }
+
+    n_ = n;
+    m_ = m;
+    N_ = header.N;
+    is_empty_ = (n_ == 0);
+    metadata_.min_context_length = header.min_context_length;
+    metadata_.max_context_length = header.max_context_length;
+    metadata_.avg_context_length = header.avg_context_length;
+    metadata_.num_degenerate_symbols = header.num_degenerate_symbols;
+    metadata_.num_common_chars = header.num_common_chars;
+    metadata_.total_change_size = header.total_change_size;
+    metadata_.num_empty_strings = header.num_empty_strings;
+    if (is_empty_) {
+        metadata_.cum_common_positions.clear();
+        metadata_.cum_degenerate_counts.clear();
+    }
+
+    return true;
+}
+
+void EDS::save_index(const std::filesystem::path& index_path, const eds_index::FileStamp& stamp) const {
+    eds_index::Header header{};
+    std::memcpy(header.magic, eds_index::MAGIC, sizeof(eds_index::MAGIC));
+    header.version = eds_index::VERSION;
+    header.stamp = stamp;
+    header.n = n_;
+    header.m = m_;
+    header.N = N_;
+    if (!is_empty_) {
+        header.min_context_length = metadata_.min_context_length;
+        header.max_context_length = metadata_.max_context_length;
+        header.avg_context_length = metadata_.avg_context_length;
+        header.num_degenerate_symbols = metadata_.num_degenerate_symbols;
+        header.num_common_chars = metadata_.num_common_chars;
+        header.total_change_size = metadata_.total_change_size;
+        header.num_empty_strings = metadata_.num_empty_strings;
+    }
+
+    // Write to a unique temporary name and rename, so readers never see a partial index
+    std::filesystem::path temp_path = index_path;
+    temp_path += ".tmp" + std::to_string(std::random_device{}());
+    {
+        std::ofstream ofs(temp_path, std::ios::binary);
+        if (!ofs) {
+            throw std::runtime_error("Failed to open file for writing: " + temp_path.string());
+        }
+
+        auto write_section = [&ofs](const void* bytes, size_t size) {
+            static const char zeros[8] = {};
+            ofs.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+            ofs.write(zeros, static_cast<std::streamsize>(edz::padded(size) - size));
+        };
+
+        std::vector<uint64_t> base_positions(metadata_.base_positions.begin(), metadata_.base_positions.end());
+        std::vector<Position> cum_common_positions = metadata_.cum_common_positions;
+        std::vector<int> cum_degenerate_counts = metadata_.cum_degenerate_counts;
+        if (is_empty_) {
+            cum_common_positions.assign(1, 0);
+            cum_degenerate_counts.assign(1, 0);
+        }
+
+        write_section(&header, sizeof(header));
+        write_section(base_positions.data(), n_ * sizeof(uint64_t));
+        write_section(metadata_.symbol_byte_lengths.data(), n_ * sizeof(Length));
+        write_section(metadata_.symbol_sizes.data(), n_ * sizeof(Length));
+        write_section(metadata_.string_lengths.data(), m_ * sizeof(Length));
+        write_section(metadata_.cum_set_sizes.data(), n_ * sizeof(Length));
+        write_section(cum_common_positions.data(), (n_ + 1) * sizeof(Position));
+        write_section(cum_degenerate_counts.data(), (n_ + 1) * sizeof(int));
+
+        ofs.close();
+        if (!ofs) {
+            std::error_code ec;
+            std::filesystem::remove(temp_path, ec);
+            throw std::runtime_error("Failed to write index: " + temp_path.string());
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, index_path, ec);
+    if (ec) {
+        std::error_code ignored;
+        std::filesystem::remove(temp_path, ignored);
+        throw std::runtime_error("Failed to write index " + index_path.string() + ": " + ec.message());
+    }
+}
+
+void EDS::build_index(const std::filesystem::path& path) {
+    EDS eds;
+    eds.mode_ = StoringMode::METADATA_ONLY;
+
+    eds_index::FileStamp stamp = eds_index::stamp_file(path);
+    MappedFile mapped(path.string());
+    mapped.advise_sequential();
+    eds.parse_buffer(mapped.data(), mapped.size());
+    if (eds.packed_) {
+        throw std::invalid_argument("Binary .edz files do not need an index: " + path.string());
+    }
+
+    eds.save_index(eds_index::sidecar_path(path), stamp);
+}
+
+bool EDS::has_current_index(const std::filesystem::path& path) {
+    std::filesystem::path index_path = eds_index::sidecar_path(path);
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(index_path, ec)) {
+        return false;
+    }
+
+    MappedFile mapped(index_path.string());
+    eds_index::Header header;
+    return read_index_header(mapped.data(), mapped.size(), eds_index::stamp_file(path), header);
+}
+
 // Load sources from sEDS stream
 void EDS::load_sources(std::istream& is) {
     parse_sources(is);
@@ -243,11 +830,13 @@ void EDS::load_sources(std::istream& is) {
 
 // Load sources from sEDS file
 void EDS::load_sources(const std::filesystem::path& path) {
-    std::ifstream ifs(path);
-    if (!ifs) {
-        throw std::runtime_error("Failed to open file: " + path.string());
+    if (mode_ == StoringMode::METADATA_ONLY) {
+        assign_source_index(std::make_unique<SourceIndex>(path));
+        return;
     }
-    parse_sources(ifs);
+    MappedFile mapped(path.string());
+    mapped.advise_sequential();
+    parse_sources_buffer(mapped.data(), mapped.size());
 }
 
 // Load sources from sEDS string
@@ -266,81 +855,17 @@ void EDS::load_sources(const std::string& seds_string) {
 //          sEDS is {0}{1,3}{2}{0}{1}{2,3}
 //          where str0→{0}, str1→{1,3}, str2→{2}, str3→{0}, str4→{1}, str5→{2,3}
 void EDS::parse_sources(std::istream& is) {
-    // Read entire input into string
-    std::stringstream buffer;
-    buffer << is.rdbuf();
-    std::string input = buffer.str();
-
-    // Remove whitespace
-    input.erase(std::remove_if(input.begin(), input.end(), ::isspace), input.end());
-
-    if (input.empty()) {
-        throw std::runtime_error("sEDS input is empty");
-    }
-
-    // Parse flattened sEDS format: {path_ids}{path_ids}...
-    // One source set per string, ordered by string ID (total = cardinality m)
-    size_t pos = 0;
-    sources_.clear();
-    size_t string_count = 0;
-
-    while (pos < input.length()) {
-        // Expect '{'
-        if (input[pos] != SET_OPEN) {
-            throw std::runtime_error("sEDS: Expected '{' at position " + std::to_string(pos));
-        }
-        pos++; // Skip '{'
-
-        // Parse path IDs for this string
-        std::set<int> path_set;
-        std::string current_number;
-
-        while (pos < input.length() && input[pos] != SET_CLOSE) {
-            if (input[pos] == SET_SEPARATOR) {
-                // End of current path ID
-                if (!current_number.empty()) {
-                    int path_id = std::stoi(current_number);
-                    if (path_id < 0) {
-                        throw std::runtime_error("sEDS: Invalid path ID (must be >= 0): " + current_number);
-                    }
-                    path_set.insert(path_id);
-                    current_number.clear();
-                }
-                pos++;
-            } else if (std::isdigit(input[pos])) {
-                // Digit, add to current number
-                current_number += input[pos];
-                pos++;
-            } else {
-                throw std::runtime_error("sEDS: Invalid character '" + std::string(1, input[pos]) +
-                                       "' at position " + std::to_string(pos));
-            }
-        }
-
-        // Add last path ID if present
-        if (!current_number.empty()) {
-            int path_id = std::stoi(current_number);
-            if (path_id < 0) {
-                throw std::runtime_error("sEDS: Invalid path ID (must be >= 0): " + current_number);
-            }
-            path_set.insert(path_id);
-        }
+    std::string input{std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()};
+    parse_sources_buffer(input.data(), input.size());
+}
 
-        // Expect '}'
-        if (pos >= input.length() || input[pos] != SET_CLOSE) {
-            throw std::runtime_error("sEDS: Expected '}' at position " + std::to_string(pos));
-        }
-        pos++; // Skip '}'
+void EDS::parse_sources_buffer(const char* data, size_t size) {
+    assign_sources(seds::parse(data, size));
+}
 
-        // Validate path set is not empty (unless it's an error case we want to catch)
-        if (path_set.empty()) {
-            throw std::runtime_error("sEDS: Empty path set at string " + std::to_string(string_count));
-        }
-
-        // Store source set
-        sources_.push_back(path_set);
-        string_count++;
-    }
+void EDS::assign_sources(SourceTable sources) {
+    sources_ = std::move(sources);
+    source_index_.reset();
 
     // Validate source count matches cardinality
     if (sources_.size() != m_) {
@@ -354,11 +879,23 @@ void EDS::parse_sources(std::istream& is) {
     calculate_source_statistics();
 }
 
+void EDS::assign_source_index(std::unique_ptr<SourceIndex> index) {
+    if (index->size() != m_) {
+        throw std::runtime_error("sEDS: Source count (" + std::to_string(index->size()) +
+                               ") does not match EDS cardinality (" + std::to_string(m_) + ")");
+    }
+
+    source_index_ = std::move(index);
+    sources_ = SourceTable();
+    has_sources_ = true;
+    calculate_source_statistics();
+}
+
 // ================================================================================
 // STATISTICS & METADATA
 // ================================================================================
 
-void EDS::calculate_statistics() {
+void EDS::calculate_statistics(size_t threads) {
     if (is_empty_) {
         metadata_.min_context_length = 0;
         metadata_.max_context_length = 0;
@@ -375,57 +912,110 @@ void EDS::calculate_statistics() {
         return;
     }
 
-    // Initialize statistics in metadata
+    /*
+     * One pass per range of symbols (a single range unless threads > 1): each
+     * range reduces its statistics and writes range-local cumulative common
+     * positions and degenerate counts, which are then shifted by the totals of
+     * the preceding ranges.
+     */
+    struct RangeStats {
+        Length min_context = UINT32_MAX;
+        Length max_context = 0;
+        size_t degenerate_symbols = 0;
+        size_t change_size = 0;
+        size_t common_chars = 0;
+        size_t empty_strings = 0;
+        size_t context_blocks = 0;
+        Position common_positions = 0;
+        int degenerate_strings = 0;
+    };
+
+    size_t ranges = std::max<size_t>(1, std::min(threads, n_ / (MIN_PARSE_CHUNK / 16)));
+    std::vector<RangeStats> stats(ranges);
+    metadata_.cum_common_positions.assign(n_ + 1, 0);
+    metadata_.cum_degenerate_counts.assign(n_ + 1, 0);
+
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(ranges) schedule(static, 1)
+#endif
+    for (size_t r = 0; r < ranges; r++) {
+        RangeStats& range = stats[r];
+        size_t first = n_ / ranges * r;
+        size_t last = (r + 1 == ranges) ? n_ : n_ / ranges * (r + 1);
+        size_t string_idx = (first == 0) ? 0 : metadata_.cum_set_sizes[first];
+
+        for (size_t i = first; i < last; i++) {
+            size_t symbol_size = metadata_.symbol_sizes[i];
+
+            if (metadata_.is_degenerate[i]) {
+                range.degenerate_symbols++;
+                range.change_size += (symbol_size - 1);
+                range.degenerate_strings += symbol_size;
+            } else {
+                // Non-degenerate symbols are "context blocks"
+                // These are the common parts between degenerate positions
+                Length context_len = metadata_.string_lengths[string_idx];
+                range.min_context = std::min(range.min_context, context_len);
+                range.max_context = std::max(range.max_context, context_len);
+                range.common_chars += context_len;
+                range.context_blocks++;
+                range.common_positions += context_len;
+            }
+
+            // Count empty strings of this symbol
+            for (size_t j = 0; j < symbol_size; j++) {
+                if (metadata_.string_lengths[string_idx++] == 0) {
+                    range.empty_strings++;
+                }
+            }
+
+            // Cumulative values after this symbol (for position checking), range-local for now
+            metadata_.cum_common_positions[i + 1] = range.common_positions;
+            metadata_.cum_degenerate_counts[i + 1] = range.degenerate_strings;
+        }
+    }
+
+    // Combine the ranges
     metadata_.min_context_length = UINT32_MAX;
     metadata_.max_context_length = 0;
     metadata_.num_degenerate_symbols = 0;
     metadata_.num_common_chars = 0;
     metadata_.total_change_size = 0;
     metadata_.num_empty_strings = 0;
-
-    size_t total_context_length = 0;
     size_t num_context_blocks = 0;
-    size_t string_idx = 0;
-
-    // Iterate through each symbol using metadata only
-    for (size_t i = 0; i < n_; i++) {
-        size_t symbol_size = metadata_.symbol_sizes[i];
-        bool is_degenerate = metadata_.is_degenerate[i];
-
-        // Count degenerate symbols
-        if (is_degenerate) {
-            metadata_.num_degenerate_symbols++;
-            metadata_.total_change_size += (symbol_size - 1);
-        } else {
-            // Non-degenerate symbols are "context blocks"
-            // These are the common parts between degenerate positions
-            Length context_len = metadata_.string_lengths[string_idx];
-
-            if (context_len < metadata_.min_context_length) {
-                metadata_.min_context_length = context_len;
-            }
-            if (context_len > metadata_.max_context_length) {
-                metadata_.max_context_length = context_len;
-            }
-            total_context_length += context_len;
-            num_context_blocks++;
-
-            metadata_.num_common_chars += context_len;
+    std::vector<Position> common_before(ranges, 0);
+    std::vector<int> degenerate_before(ranges, 0);
+
+    for (size_t r = 0; r < ranges; r++) {
+        const RangeStats& range = stats[r];
+        metadata_.min_context_length = std::min(metadata_.min_context_length, range.min_context);
+        metadata_.max_context_length = std::max(metadata_.max_context_length, range.max_context);
+        metadata_.num_degenerate_symbols += range.degenerate_symbols;
+        metadata_.total_change_size += range.change_size;
+        metadata_.num_common_chars += range.common_chars;
+        metadata_.num_empty_strings += range.empty_strings;
+        num_context_blocks += range.context_blocks;
+        if (r + 1 < ranges) {
+            common_before[r + 1] = common_before[r] + range.common_positions;
+            degenerate_before[r + 1] = degenerate_before[r] + range.degenerate_strings;
         }
+    }
 
-        // Count empty strings and process all strings in this symbol
-        for (size_t j = 0; j < symbol_size; j++) {
-            Length str_len = metadata_.string_lengths[string_idx];
-            if (str_len == 0) {
-                metadata_.num_empty_strings++;
-            }
-            string_idx++;
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(ranges) schedule(static, 1)
+#endif
+    for (size_t r = 1; r < ranges; r++) {
+        size_t first = n_ / ranges * r;
+        size_t last = (r + 1 == ranges) ? n_ : n_ / ranges * (r + 1);
+        for (size_t i = first; i < last; i++) {
+            metadata_.cum_common_positions[i + 1] += common_before[r];
+            metadata_.cum_degenerate_counts[i + 1] += degenerate_before[r];
         }
     }
 
-    // Calculate average context length
+    // Calculate average context length (common characters over context blocks)
     if (num_context_blocks > 0) {
-        metadata_.avg_context_length = static_cast<double>(total_context_length) / num_context_blocks;
+        metadata_.avg_context_length = static_cast<double>(metadata_.num_common_chars) / num_context_blocks;
     } else {
         metadata_.avg_context_length = 0.0;
     }
@@ -434,39 +1024,6 @@ void EDS::calculate_statistics() {
     if (metadata_.min_context_length == UINT32_MAX) {
         metadata_.min_context_length = 0;
     }
-
-    // Calculate cumulative common positions (for position checking)
-    metadata_.cum_common_positions.clear();
-    metadata_.cum_common_positions.reserve(n_ + 1);
-
-    Position cumulative_common = 0;
-    metadata_.cum_common_positions.push_back(0);
-
-    string_idx = 0;
-    for (size_t i = 0; i < n_; i++) {
-        if (!metadata_.is_degenerate[i]) {
-            // Non-degenerate: add its length to cumulative
-            cumulative_common += metadata_.string_lengths[string_idx];
-        }
-        metadata_.cum_common_positions.push_back(cumulative_common);
-
-        // Move string_idx forward by number of strings in this symbol
-        string_idx += metadata_.symbol_sizes[i];
-    }
-
-    // Calculate cumulative degenerate counts (for position checking)
-    metadata_.cum_degenerate_counts.clear();
-    metadata_.cum_degenerate_counts.reserve(n_ + 1);
-
-    int cumulative_degenerate = 0;
-    metadata_.cum_degenerate_counts.push_back(0);
-
-    for (size_t i = 0; i < n_; i++) {
-        if (metadata_.is_degenerate[i]) {
-            cumulative_degenerate += metadata_.symbol_sizes[i];
-        }
-        metadata_.cum_degenerate_counts.push_back(cumulative_degenerate);
-    }
 }
 
 void EDS::calculate_source_statistics() {
@@ -475,31 +1032,35 @@ void EDS::calculate_source_statistics() {
     metadata_.max_paths_per_string = 0;
     metadata_.avg_paths_per_string = 0.0;
 
+    if (source_index_) {
+        // Gathered when the file was indexed
+        metadata_.num_paths = source_index_->num_paths();
+        metadata_.max_paths_per_string = source_index_->max_paths_per_string();
+        metadata_.avg_paths_per_string = source_index_->size() > 0
+            ? static_cast<double>(source_index_->total_paths()) / source_index_->size()
+            : 0.0;
+        return;
+    }
+
     if (!has_sources_ || sources_.empty()) {
         return;
     }
 
-    // Track all unique path IDs
-    std::set<int> all_paths;
     size_t total_paths = 0;
 
-    for (const auto& source_set : sources_) {
+    for (size_t i = 0; i < sources_.size(); i++) {
         // Track max paths in any single string
-        if (source_set.size() > metadata_.max_paths_per_string) {
-            metadata_.max_paths_per_string = source_set.size();
-        }
-
-        // Accumulate all unique paths
-        for (int path_id : source_set) {
-            all_paths.insert(path_id);
+        size_t paths = sources_[i].size();
+        if (paths > metadata_.max_paths_per_string) {
+            metadata_.max_paths_per_string = paths;
         }
 
         // Count total for average
-        total_paths += source_set.size();
+        total_paths += paths;
     }
 
-    // Calculate statistics
-    metadata_.num_paths = all_paths.size();
+    // Calculate statistics (distinct path IDs in use)
+    metadata_.num_paths = sources_.num_paths();
     metadata_.avg_paths_per_string = sources_.size() > 0
         ? static_cast<double>(total_paths) / sources_.size()
         : 0.0;
@@ -549,7 +1110,7 @@ void EDS::print_statistics(std::ostream& os) const {
     os << "  Empty strings:                " << stats.num_empty_strings << "\n";
     os << "\n";
     if (has_sources_) {
-        os << "Sources: Loaded (" << sources_.size() << " strings with source info)\n";
+        os << "Sources: Loaded (" << m_ << " strings with source info)\n";
     } else {
         os << "Sources: Not loaded\n";
     }
@@ -571,15 +1132,15 @@ void EDS::print(std::ostream& os) const {
 
     os << "EDS with " << n_ << " sets, " << m_ << " total strings:\n";
 
-    for (size_t i = 0; i < sets_.size(); i++) {
-        const auto& set = sets_[i];
+    for (size_t i = 0; i < n_; i++) {
+        size_t first = metadata_.cum_set_sizes[i];
 
         os << "Set " << i << ": {";
 
-        for (size_t j = 0; j < set.size(); j++) {
+        for (size_t j = 0; j < metadata_.symbol_sizes[i]; j++) {
             if (j > 0) os << ", ";
 
-            const auto& str = set[j];
+            std::string_view str = string_at(first + j);
             if (str.empty()) {
                 os << "ε";  // Epsilon for empty string
             } else {
@@ -605,9 +1166,14 @@ void EDS::save(std::ostream& os, OutputFormat format) const {
         );
     }
 
+    if (format == OutputFormat::BINARY) {
+        save_binary(os);
+        return;
+    }
+
     // Output EDS format
-    for (size_t i = 0; i < sets_.size(); i++) {
-        const auto& set = sets_[i];
+    for (size_t i = 0; i < n_; i++) {
+        size_t first_string = metadata_.cum_set_sizes[i];
 
         // Determine if we should use brackets for this set
         bool use_brackets = (format == OutputFormat::FULL) || metadata_.is_degenerate[i];
@@ -616,11 +1182,9 @@ void EDS::save(std::ostream& os, OutputFormat format) const {
             os << "{";
         }
 
-        bool first = true;
-        for (const auto& str : set) {
-            if (!first) os << ",";
-            os << str;
-            first = false;
+        for (size_t j = 0; j < metadata_.symbol_sizes[i]; j++) {
+            if (j > 0) os << ",";
+            os << string_at(first_string + j);
         }
 
         if (use_brackets) {
@@ -631,43 +1195,90 @@ void EDS::save(std::ostream& os, OutputFormat format) const {
 }
 
 void EDS::save(const std::filesystem::path& path, OutputFormat format) const {
-    std::ofstream ofs(path);
+    if (path.extension() == EXT_EDZ) {
+        format = OutputFormat::BINARY;
+    }
+
+    std::ofstream ofs(path, std::ios::binary);
     if (!ofs) {
         throw std::runtime_error("Failed to open file for writing: " + path.string());
     }
     save(ofs, format);
 }
 
-void EDS::save_sources(std::ostream& os) const {
-    if (!has_sources_) {
-        throw std::runtime_error("Cannot save sources: no sources loaded");
+void EDS::save_binary(std::ostream& os) const {
+    // Pack the arena first: the header needs the escape run count
+    edz::PayloadPacker packer;
+    packer.reserve(N_);
+    packer.append(arena_);
+    const edz::EscapeRuns& escapes = packer.escapes();
+
+    edz::Header header{};
+    std::memcpy(header.magic, edz::MAGIC, sizeof(edz::MAGIC));
+    header.version = edz::VERSION;
+    header.flags = has_sources_ ? edz::FLAG_SOURCES : 0;
+    header.n = n_;
+    header.m = m_;
+    header.N = N_;
+    header.num_escape_runs = escapes.size();
+    if (has_sources_) {
+        for (size_t i = 0; i < sources_.size(); i++) {
+            header.num_source_ids += sources_[i].size();
+        }
     }
 
-    // Output sEDS format (flattened): {path_ids}{path_ids}...
-    // One set per string, ordered by string ID
-    for (size_t i = 0; i < sources_.size(); i++) {
-        os << "{";
-        bool first = true;
-        for (int path_id : sources_[i]) {
-            if (!first) os << ",";
-            os << path_id;
-            first = false;
+    auto write_section = [&os](const void* bytes, size_t size) {
+        static const char zeros[8] = {};
+        os.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+        os.write(zeros, static_cast<std::streamsize>(edz::padded(size) - size));
+    };
+
+    write_section(&header, sizeof(header));
+    write_section(metadata_.symbol_sizes.data(), n_ * sizeof(Length));
+    write_section(metadata_.string_lengths.data(), m_ * sizeof(Length));
+    write_section(escapes.starts.data(), escapes.size() * sizeof(Position));
+    write_section(escapes.lengths.data(), escapes.size() * sizeof(Length));
+    write_section(escapes.chars.data(), escapes.size());
+
+    if (has_sources_) {
+        std::vector<uint32_t> counts;
+        std::vector<int32_t> ids;
+        counts.reserve(m_);
+        ids.reserve(header.num_source_ids);
+        for (size_t i = 0; i < sources_.size(); i++) {
+            counts.push_back(static_cast<uint32_t>(sources_[i].size()));
+            sources_.for_each_path(sources_[i], [&](int path_id) { ids.push_back(path_id); });
         }
-        os << "}";
+        write_section(counts.data(), counts.size() * sizeof(uint32_t));
+        write_section(ids.data(), ids.size() * sizeof(int32_t));
+    }
+
+    write_section(packer.bytes().data(), packer.bytes().size());
+
+    if (!os) {
+        throw std::runtime_error("Failed to write EDZ output");
     }
-    os << "\n";
+}
+
+void EDS::save_sources(std::ostream& os, SourcesFormat format) const {
+    if (!has_sources_) {
+        throw std::runtime_error("Cannot save sources: no sources loaded");
+    }
+
+    // One set per string, ordered by string ID (see seds.hpp for the encodings)
+    seds::write(os, source_index_ ? source_index_->materialize() : sources_, format);
 }
 
 // ================================================================================
 // PATTERN GENERATION & EXTRACTION
 // ================================================================================
 
-void EDS::save_sources(const std::filesystem::path& path) const {
-    std::ofstream ofs(path);
+void EDS::save_sources(const std::filesystem::path& path, SourcesFormat format) const {
+    std::ofstream ofs(path, std::ios::binary);
     if (!ofs) {
         throw std::runtime_error("Failed to open file for writing: " + path.string());
     }
-    save_sources(ofs);
+    save_sources(ofs, seds::format_for(path, format));
 }
 
 void EDS::generate_patterns(std::ostream& os, size_t count, Length pattern_length) const {
@@ -706,9 +1317,9 @@ void EDS::generate_patterns(std::ostream& os, size_t count, Length pattern_lengt
         bool first_symbol = true;
 
         // Generate pattern by randomly selecting from sets
-        // Works in both FULL and METADATA_ONLY modes via read_symbol()
+        // Works in both FULL and METADATA_ONLY modes via symbol_view()
         while (remaining_length > 0 && current_pos < n_) {
-            StringSet set = read_symbol(current_pos);
+            SymbolView set = symbol_view(current_pos);
 
             if (set.empty()) {
                 // Skip empty sets (epsilon)
@@ -720,7 +1331,7 @@ void EDS::generate_patterns(std::ostream& os, size_t count, Length pattern_lengt
             // Randomly select one string from the set
             std::uniform_int_distribution<size_t> set_dist(0, set.size() - 1);
             size_t string_idx = set_dist(gen);
-            const String& selected = set[string_idx];
+            std::string_view selected = set[string_idx];
 
             // For first symbol, start from offset; for others, start from 0
             Length start_offset = first_symbol ? offset_in_symbol : 0;
@@ -747,12 +1358,12 @@ void EDS::generate_patterns(std::ostream& os, size_t count, Length pattern_lengt
             // Try wrapping around for short EDS
             while (pattern.length() < pattern_length && n_ > 0) {
                 Position wrap_pos = pattern.length() % n_;
-                StringSet set = read_symbol(wrap_pos);
+                SymbolView set = symbol_view(wrap_pos);
 
                 if (!set.empty()) {
                     std::uniform_int_distribution<size_t> set_dist(0, set.size() - 1);
                     size_t string_idx = set_dist(gen);
-                    const String& selected = set[string_idx];
+                    std::string_view selected = set[string_idx];
 
                     Length to_take = std::min(
                         static_cast<Length>(pattern_length - pattern.length()),
@@ -806,147 +1417,465 @@ String EDS::extract(Position pos, Length len, const std::vector<int>& changes) c
         Position current_pos = pos + i;
         int change_idx = changes[i];
 
-        const StringSet& set = sets_[current_pos];
+        size_t set_size = metadata_.symbol_sizes[current_pos];
 
         // Validate change index
-        if (change_idx < 0 || static_cast<size_t>(change_idx) >= set.size()) {
+        if (change_idx < 0 || static_cast<size_t>(change_idx) >= set_size) {
             throw std::out_of_range(
                 "Change index " + std::to_string(change_idx) +
                 " at position " + std::to_string(current_pos) +
-                " is out of range (set size: " + std::to_string(set.size()) + ")"
+                " is out of range (set size: " + std::to_string(set_size) + ")"
             );
         }
 
         // Append the selected string
-        result.append(set[change_idx]);
+        result.append(string_at(metadata_.cum_set_sizes[current_pos] + change_idx));
     }
 
     return result;
 }
 
+// Batch extraction (see eds.hpp); each query only reads the arena, so ranges are independent
+std::vector<String> EDS::extract(const std::vector<ExtractQuery>& queries, size_t threads) const {
+    std::vector<String> results(queries.size());
+
+    // Position order keeps each range within a contiguous part of the arena
+    std::vector<size_t> order(queries.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&queries](size_t a, size_t b) {
+        return queries[a].pos < queries[b].pos;
+    });
+
+    size_t ranges = std::max<size_t>(1, std::min(threads, order.size()));
+    std::vector<size_t> failed(ranges, queries.size());
+    std::vector<std::exception_ptr> errors(ranges);
+
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(ranges) schedule(static, 1)
+#endif
+    for (size_t r = 0; r < ranges; r++) {
+        size_t first = order.size() / ranges * r;
+        size_t last = (r + 1 == ranges) ? order.size() : order.size() / ranges * (r + 1);
+        for (size_t k = first; k < last; k++) {
+            const ExtractQuery& query = queries[order[k]];
+            try {
+                results[order[k]] = extract(query.pos, query.len, query.changes);
+            } catch (...) {
+                if (order[k] < failed[r]) {
+                    failed[r] = order[k];
+                    errors[r] = std::current_exception();
+                }
+            }
+        }
+    }
+
+    // Rethrow the error of the first failing query (in input order)
+    size_t first_error = ranges;
+    for (size_t r = 0; r < ranges; r++) {
+        if (errors[r] && (first_error == ranges || failed[r] < failed[first_error])) {
+            first_error = r;
+        }
+    }
+    if (first_error != ranges) {
+        std::rethrow_exception(errors[first_error]);
+    }
+    return results;
+}
+
 // ================================================================================
 // STREAMING & DATA ACCESS
 // ================================================================================
 
-std::string EDS::normalize_eds_format(const std::string& input) const {
-    /*
-     * Normalize compact EDS format to full bracketed format
-     * Examples:
-     *   "ACGT{A,ACA}CGT" -> "{ACGT}{A,ACA}{CGT}"
-     *   "{ACGT}{A,ACA}{CGT}" -> "{ACGT}{A,ACA}{CGT}" (no change)
-     *   "A{C,G}T" -> "{A}{C,G}{T}"
-     */
+// Read symbol from stream (for METADATA_ONLY mode)
+StringSet EDS::read_symbol_from_stream(Position pos) const {
+    if (mode_ == StoringMode::FULL) {
+        // In FULL mode, copy the alternatives out of the arena
+        StringSet result;
+        result.reserve(get_symbol_size(pos));
+        for (size_t j = 0; j < get_symbol_size(pos); j++) {
+            result.emplace_back(string_at(first_string_of(pos) + j));
+        }
+        return result;
+    }
 
-    std::string result;
-    std::string current_string;
-    size_t i = 0;
-    int brace_depth = 0;
+    // METADATA_ONLY mode: read from file
+    if (!file_.is_open()) {
+        throw std::runtime_error("File not available for reading symbol");
+    }
+
+    if (cache_) {
+        return symbol_view(pos).to_set();
+    }
+
+    if (packed_) {
+        return read_symbol_from_payload(pos);
+    }
+
+    // One positional read covers the whole symbol (bracketed set or compact run)
+    String bytes(get_symbol_byte_length(pos), '\0');
+    file_.read_at(static_cast<uint64_t>(static_cast<std::streamoff>(get_base_position(pos))),
+                  bytes.data(), bytes.size());
+
+    StringSet result = decode_symbol_span(bytes.data(), bytes.data() + bytes.size(),
+                                          get_symbol_size(pos));
+    if (result.size() != get_symbol_size(pos)) {
+        throw std::runtime_error(
+            "Symbol " + std::to_string(pos) + " does not match the index "
+            "(file changed since it was loaded?)"
+        );
+    }
+    return result;
+}
+
+// Unpacked characters [first_char, first_char + char_count) of an .edz payload (METADATA_ONLY mode)
+String EDS::read_payload_chars(Position first_char, size_t char_count) const {
+    // Read the packed bytes covering the range
+    size_t byte_begin = static_cast<size_t>(first_char / 4);
+    size_t byte_end = edz::payload_bytes(first_char + char_count);
+    std::vector<uint8_t> packed(byte_end - byte_begin);
+    file_.read_at(static_cast<uint64_t>(payload_offset_) + byte_begin, packed.data(), packed.size());
+
+    String chars(char_count, '\0');
+    edz::unpack(packed.data(), static_cast<unsigned>(first_char % 4), char_count, chars.data());
+    escapes_.apply(first_char, char_count, chars.data());
+    return chars;
+}
+
+// Read symbol from the packed payload of an .edz file (METADATA_ONLY mode)
+StringSet EDS::read_symbol_from_payload(Position pos) const {
+    size_t first_string = first_string_of(pos);
+    size_t symbol_size = get_symbol_size(pos);
+    String chars = read_payload_chars(static_cast<Position>(get_base_position(pos)),
+                                      get_symbol_byte_length(pos));
 
-    while (i < input.length()) {
-        char ch = input[i];
+    // Split into alternatives
+    StringSet result;
+    result.reserve(symbol_size);
+    size_t offset = 0;
+    for (size_t j = 0; j < symbol_size; j++) {
+        Length len = get_string_length(first_string + j);
+        result.emplace_back(chars, offset, len);
+        offset += len;
+    }
+    return result;
+}
+
+// Public accessor for read_symbol (works in both modes)
+StringSet EDS::read_symbol(Position pos) const {
+    if (pos >= n_) {
+        throw std::out_of_range("Position " + std::to_string(pos) + " out of range");
+    }
+    return read_symbol_from_stream(pos);
+}
+
+// Zero-copy view of a symbol (works in both modes)
+SymbolView EDS::symbol_view(Position pos) const {
+    if (pos >= n_) {
+        throw std::out_of_range("Position " + std::to_string(pos) + " out of range");
+    }
+
+    size_t first_string = first_string_of(pos);
+    size_t symbol_size = get_symbol_size(pos);
+
+    if (mode_ == StoringMode::FULL) {
+        return SymbolView(arena_.data(), string_offsets_.data() + first_string,
+                          metadata_.string_lengths.data() + first_string, symbol_size);
+    }
+
+    // Cached: the view shares ownership of its block, so eviction cannot invalidate it
+    if (cache_) {
+        auto block = cache_->get(pos / SymbolBlock::SYMBOLS_PER_BLOCK,
+                                 [this](size_t block_id) { return load_block(block_id); });
+        size_t k = pos % SymbolBlock::SYMBOLS_PER_BLOCK;
+        const char* data = block->chars.data() + block->symbol_offsets[k];
+        const Length* lengths = block->string_lengths.data() + block->symbol_strings[k];
+        return SymbolView(data, lengths, symbol_size, 0, std::move(block));
+    }
+
+    // Lengths come straight from plain metadata, succinct metadata unpacks them once
+    std::shared_ptr<DecodedSymbol> decoded;
+    const Length* lengths = nullptr;
+    if (succinct_) {
+        decoded = std::make_shared<DecodedSymbol>();
+        decoded->lengths.reserve(symbol_size);
+        for (size_t j = 0; j < symbol_size; j++) {
+            decoded->lengths.push_back(get_string_length(first_string + j));
+        }
+        lengths = decoded->lengths.data();
+    } else {
+        lengths = metadata_.string_lengths.data() + first_string;
+    }
+
+    // Text file: view the mapped bytes directly unless whitespace breaks the "a,b,c" layout
+    if (mapping_.is_open()) {
+        size_t begin = static_cast<size_t>(static_cast<std::streamoff>(get_base_position(pos)));
+        size_t span = get_symbol_byte_length(pos);
+        if (begin + span <= mapping_.size() && span > 0) {
+            const char* p = mapping_.data() + begin;
+            bool bracketed = (*p == SET_OPEN);
+            size_t expected = symbol_size - 1 + (bracketed ? 2 : 0);
+            for (size_t j = 0; j < symbol_size; j++) {
+                expected += lengths[j];
+            }
+            if (span == expected) {
+                return SymbolView(p + (bracketed ? 1 : 0), lengths, symbol_size, 1, std::move(decoded));
+            }
+        }
+    }
+
+    // Fallback: decode once into a buffer owned by the view
+    if (!decoded) {
+        decoded = std::make_shared<DecodedSymbol>();
+    }
+    if (packed_) {
+        if (!file_.is_open()) {
+            throw std::runtime_error("File not available for reading symbol");
+        }
+        decoded->chars = read_payload_chars(static_cast<Position>(get_base_position(pos)),
+                                            get_symbol_byte_length(pos));
+    } else {
+        for (const String& str : read_symbol_from_stream(pos)) {
+            decoded->chars.append(str);
+        }
+    }
+    const char* data = decoded->chars.data();
+    return SymbolView(data, lengths, symbol_size, 0, std::move(decoded));
+}
+
+// Decode SYMBOLS_PER_BLOCK consecutive symbols with a single read (METADATA_ONLY mode)
+std::shared_ptr<const SymbolBlock> EDS::load_block(size_t block_id) const {
+    size_t first = block_id * SymbolBlock::SYMBOLS_PER_BLOCK;
+    size_t last = std::min(first + SymbolBlock::SYMBOLS_PER_BLOCK, n_);  // Exclusive
+
+    auto block = std::make_shared<SymbolBlock>();
+    block->symbol_offsets.reserve(last - first + 1);
+    block->symbol_strings.reserve(last - first + 1);
+
+    // String lengths travel with the block, so views never touch (possibly succinct) metadata
+    size_t first_string = first_string_of(first);
+    size_t end_string = first_string_of(last - 1) + get_symbol_size(last - 1);
+    block->string_lengths.reserve(end_string - first_string);
+    for (size_t id = first_string; id < end_string; id++) {
+        block->string_lengths.push_back(get_string_length(id));
+    }
+
+    uint64_t begin = static_cast<uint64_t>(static_cast<std::streamoff>(get_base_position(first)));
+    uint64_t end = static_cast<uint64_t>(static_cast<std::streamoff>(get_base_position(last - 1))) +
+                   get_symbol_byte_length(last - 1);
+
+    if (packed_) {
+        // Symbols are consecutive in the payload, so the block is one character range
+        block->chars = read_payload_chars(begin, static_cast<size_t>(end - begin));
+        for (size_t pos = first; pos < last; pos++) {
+            block->symbol_offsets.push_back(static_cast<size_t>(
+                static_cast<std::streamoff>(get_base_position(pos)) - static_cast<std::streamoff>(begin)));
+            block->symbol_strings.push_back(first_string_of(pos) - first_string);
+        }
+        block->symbol_offsets.push_back(block->chars.size());
+        block->symbol_strings.push_back(end_string - first_string);
+        return block;
+    }
+
+    String bytes(static_cast<size_t>(end - begin), '\0');
+    file_.read_at(begin, bytes.data(), bytes.size());
+
+    for (size_t pos = first; pos < last; pos++) {
+        size_t symbol_first = first_string_of(pos) - first_string;
+        size_t symbol_size = get_symbol_size(pos);
+        block->symbol_offsets.push_back(block->chars.size());
+        block->symbol_strings.push_back(symbol_first);
+
+        const char* p = bytes.data() + (static_cast<std::streamoff>(get_base_position(pos)) -
+                                        static_cast<std::streamoff>(begin));
+        size_t strings = append_symbol_chars(p, p + get_symbol_byte_length(pos), block->chars);
+
+        size_t expected_chars = 0;
+        for (size_t j = 0; j < symbol_size; j++) {
+            expected_chars += block->string_lengths[symbol_first + j];
+        }
+        if (strings != symbol_size ||
+            block->chars.size() - block->symbol_offsets.back() != expected_chars) {
+            throw std::runtime_error(
+                "Symbol " + std::to_string(pos) + " does not match the index "
+                "(file changed since it was loaded?)"
+            );
+        }
+    }
+    block->symbol_offsets.push_back(block->chars.size());
+    block->symbol_strings.push_back(end_string - first_string);
+    block->chars.shrink_to_fit();
+
+    return block;
+}
+
+// Replace the metadata arrays by their succinct counterparts (METADATA_ONLY mode)
+void EDS::compress_metadata() {
+    if (mode_ != StoringMode::METADATA_ONLY) {
+        throw std::runtime_error(
+            "compress_metadata() is only available in METADATA_ONLY mode "
+            "(FULL mode indexes the string arena through the plain arrays)"
+        );
+    }
+    if (succinct_) {
+        return;
+    }
 
-        if (ch == SET_OPEN) {
-            // If we have accumulated non-bracketed characters, wrap them
-            if (!current_string.empty() && brace_depth == 0) {
-                result += "{" + current_string + "}";
-                current_string.clear();
-            }
-            result += ch;
-            brace_depth++;
-            i++;
-        }
-        else if (ch == SET_CLOSE) {
-            result += ch;
-            brace_depth--;
-            i++;
-        }
-        else if (brace_depth > 0) {
-            // Inside brackets, pass through as-is
-            result += ch;
-            i++;
-        }
-        else {
-            // Outside brackets, accumulate characters
-            current_string += ch;
-            i++;
+    const Metadata& md = metadata_;
+    auto compact = std::make_unique<SuccinctMetadata>();
+
+    compact->base_positions = succinct::EliasFano::build(n_, [&](size_t i) {
+        return static_cast<uint64_t>(static_cast<std::streamoff>(md.base_positions[i]));
+    });
+    compact->symbol_byte_lengths = succinct::PackedVector::build(n_, [&](size_t i) {
+        return static_cast<uint64_t>(md.symbol_byte_lengths[i]);
+    });
+    compact->cum_set_sizes = succinct::EliasFano::build(n_ + 1, [&](size_t i) {
+        return static_cast<uint64_t>(i < n_ ? md.cum_set_sizes[i] : m_);
+    });
+    compact->string_lengths = succinct::PackedVector::build(m_, [&](size_t i) {
+        return static_cast<uint64_t>(md.string_lengths[i]);
+    });
+    compact->cum_common_positions = succinct::EliasFano::build(md.cum_common_positions.size(), [&](size_t i) {
+        return static_cast<uint64_t>(md.cum_common_positions[i]);
+    });
+    compact->cum_degenerate_counts = succinct::EliasFano::build(md.cum_degenerate_counts.size(), [&](size_t i) {
+        return static_cast<uint64_t>(md.cum_degenerate_counts[i]);
+    });
+    compact->is_degenerate = succinct::BitVector(n_);
+    for (size_t i = 0; i < n_; i++) {
+        if (md.is_degenerate[i]) {
+            compact->is_degenerate.set(i);
         }
     }
+    compact->is_degenerate.build_support();
 
-    // If there are remaining non-bracketed characters at the end, wrap them
-    if (!current_string.empty() && brace_depth == 0) {
-        result += "{" + current_string + "}";
-    }
+    succinct_ = std::move(compact);
 
-    return result;
+    // Release the plain arrays; the statistics stay in metadata_
+    std::vector<std::streampos>().swap(metadata_.base_positions);
+    std::vector<Length>().swap(metadata_.symbol_byte_lengths);
+    std::vector<Length>().swap(metadata_.symbol_sizes);
+    std::vector<Length>().swap(metadata_.string_lengths);
+    std::vector<Length>().swap(metadata_.cum_set_sizes);
+    std::vector<bool>().swap(metadata_.is_degenerate);
+    std::vector<Position>().swap(metadata_.cum_common_positions);
+    std::vector<int>().swap(metadata_.cum_degenerate_counts);
 }
 
-// Read symbol from stream (for METADATA_ONLY mode)
-StringSet EDS::read_symbol_from_stream(Position pos) const {
-    if (mode_ == StoringMode::FULL) {
-        // In FULL mode, return directly from sets_
-        return sets_[pos];
-    }
+// Resident size of the per-symbol metadata (plain arrays or succinct structures)
+size_t EDS::metadata_bytes() const {
+    if (succinct_) {
+        return succinct_->base_positions.bytes() + succinct_->symbol_byte_lengths.bytes() +
+               succinct_->cum_set_sizes.bytes() + succinct_->string_lengths.bytes() +
+               succinct_->cum_common_positions.bytes() + succinct_->cum_degenerate_counts.bytes() +
+               succinct_->is_degenerate.bytes();
+    }
+    return metadata_.base_positions.capacity() * sizeof(std::streampos) +
+           metadata_.symbol_byte_lengths.capacity() * sizeof(Length) +
+           metadata_.symbol_sizes.capacity() * sizeof(Length) +
+           metadata_.string_lengths.capacity() * sizeof(Length) +
+           metadata_.cum_set_sizes.capacity() * sizeof(Length) +
+           (metadata_.is_degenerate.capacity() + 7) / 8 +
+           metadata_.cum_common_positions.capacity() * sizeof(Position) +
+           metadata_.cum_degenerate_counts.capacity() * sizeof(int);
+}
 
-    // METADATA_ONLY mode: stream from file
-    if (!stream_.is_open()) {
-        throw std::runtime_error("File stream not available for reading symbol");
+// Cache counters (all zero when the EDS was loaded without a cache budget)
+BlockCacheStats EDS::get_source_cache_stats() const {
+    if (!source_index_) {
+        return BlockCacheStats{};
     }
+    return source_index_->cache_stats();
+}
 
-    // Seek to symbol position
-    stream_.clear();  // Clear any error flags
-    stream_.seekg(metadata_.base_positions[pos]);
-
-    if (!stream_) {
-        throw std::runtime_error("Failed to seek to position " + std::to_string(pos));
+BlockCache::Stats EDS::get_cache_stats() const {
+    if (!cache_) {
+        return BlockCache::Stats{};
     }
+    return cache_->stats();
+}
 
-    // Parse one symbol
-    StringSet result;
-    char ch;
-    std::string current_str;
+// ================================================================================
+// POSITION CHECKING & VALIDATION
+// ================================================================================
 
-    // Expect '{'
-    if (!stream_.get(ch) || ch != SET_OPEN) {
-        throw std::runtime_error("Expected '{' at position " + std::to_string(pos));
+// get_sets() with error checking (builds nested sets from the arena)
+std::vector<StringSet> EDS::get_sets() const {
+    if (mode_ == StoringMode::METADATA_ONLY) {
+        throw std::runtime_error(
+            "Cannot access sets in METADATA_ONLY mode. "
+            "Use read_symbol(pos) for on-demand access, or load with StoringMode::FULL"
+        );
     }
 
-    // Parse strings in symbol
-    while (stream_.get(ch) && ch != SET_CLOSE) {
-        if (ch == SET_SEPARATOR) {
-            result.push_back(current_str);
-            current_str.clear();
-        } else if (!std::isspace(ch)) {  // Skip whitespace
-            current_str += ch;
-        }
+    std::vector<StringSet> sets;
+    sets.reserve(n_);
+    for (Position pos = 0; pos < n_; pos++) {
+        sets.push_back(read_symbol_from_stream(pos));
     }
+    return sets;
+}
 
-    // Add last string
-    result.push_back(current_str);
+std::vector<std::set<int>> EDS::get_sources() const {
+    return source_index_ ? source_index_->materialize().to_sets() : sources_.to_sets();
+}
 
-    return result;
+const SourceTable& EDS::get_source_table() const {
+    if (source_index_) {
+        throw std::runtime_error(
+            "Sources are decoded on demand in METADATA_ONLY mode. "
+            "Use get_sources() for a copy, or load with StoringMode::FULL"
+        );
+    }
+    return sources_;
 }
 
-// Public accessor for read_symbol (works in both modes)
-StringSet EDS::read_symbol(Position pos) const {
-    if (pos >= n_) {
-        throw std::out_of_range("Position " + std::to_string(pos) + " out of range");
+std::vector<int32_t> EDS::get_string_sources(size_t string_id) const {
+    if (!has_sources_) {
+        throw std::runtime_error("get_string_sources: No sources loaded");
     }
-    return read_symbol_from_stream(pos);
+    if (string_id >= m_) {
+        throw std::out_of_range("String ID " + std::to_string(string_id) + " out of range");
+    }
+    std::shared_ptr<const SourceBlock> hold;
+    std::vector<int32_t> paths;
+    source_numbering().for_each_path(source_at(string_id, hold), [&](int id) { paths.push_back(id); });
+    return paths;
 }
 
-// ================================================================================
-// POSITION CHECKING & VALIDATION
-// ================================================================================
+// Zero-copy access to a string by global string ID
+std::string_view EDS::get_string(size_t string_id) const {
+    if (mode_ == StoringMode::METADATA_ONLY) {
+        throw std::runtime_error(
+            "Cannot access strings in METADATA_ONLY mode. "
+            "Use read_symbol(pos) for on-demand access, or load with StoringMode::FULL"
+        );
+    }
+    if (string_id >= m_) {
+        throw std::out_of_range("String ID " + std::to_string(string_id) + " out of range");
+    }
+    return string_at(string_id);
+}
 
-// get_sets() with error checking
-const std::vector<StringSet>& EDS::get_sets() const {
+// Zero-copy access to a string by symbol position and alternative index
+std::string_view EDS::get_string(Position pos, size_t local_idx) const {
+    // Before any metadata lookup: METADATA_ONLY arrays may be compressed
     if (mode_ == StoringMode::METADATA_ONLY) {
         throw std::runtime_error(
-            "Cannot access sets in METADATA_ONLY mode. "
+            "Cannot access strings in METADATA_ONLY mode. "
             "Use read_symbol(pos) for on-demand access, or load with StoringMode::FULL"
         );
     }
-    return sets_;
+    if (pos >= n_) {
+        throw std::out_of_range("Position " + std::to_string(pos) + " out of range");
+    }
+    if (local_idx >= get_symbol_size(pos)) {
+        throw std::out_of_range(
+            "Alternative " + std::to_string(local_idx) +
+            " out of range for symbol " + std::to_string(pos)
+        );
+    }
+    return get_string(first_string_of(pos) + local_idx);
 }
 
 // Check if pattern occurs at position with given degenerate string choices
@@ -974,77 +1903,124 @@ bool EDS::check_position(Position common_pos,
         return false;
     }
 
-    // Warn if too many degenerate strings provided
-    // Count expected number of degenerate symbols we'll traverse
-    size_t expected_deg_count = 0;
-    Length chars_counted = 0;
-    for (size_t i = start_symbol; i < n_ && chars_counted < pattern.length(); i++) {
-        if (metadata_.is_degenerate[i]) {
-            expected_deg_count++;
-        }
-        // Estimate how many chars this symbol contributes
-        size_t global_string_idx = metadata_.cum_set_sizes[i];
-        Length sym_len = metadata_.string_lengths[global_string_idx];
-        if (i == start_symbol) {
-            sym_len = (sym_len > offset_in_symbol) ? (sym_len - offset_in_symbol) : 0;
-        }
-        chars_counted += sym_len;
+    CheckContext context;
+    return check_resolved(start_symbol, offset_in_symbol, degenerate_strings, pattern, context, true);
+}
+
+// Position checking core, from the resolved start symbol: text first (most
+// candidates fail within a few characters), then the source intersection
+bool EDS::check_resolved(size_t start_symbol,
+                         Position offset_in_symbol,
+                         const std::vector<int>& degenerate_strings,
+                         const String& pattern,
+                         CheckContext& context,
+                         bool warn_extra) const {
+    if (!validate_choices(start_symbol, offset_in_symbol, degenerate_strings, pattern.length(), context)) {
+        return false;
+    }
+
+    size_t degenerate_used = 0;
+    if (!match_in_place(start_symbol, offset_in_symbol, pattern, context, degenerate_used)) {
+        return false;
     }
 
-    if (degenerate_strings.size() > expected_deg_count) {
+    if (warn_extra && degenerate_strings.size() > degenerate_used) {
         std::cerr << "Warning: More degenerate strings provided ("
                   << degenerate_strings.size()
-                  << ") than needed (" << expected_deg_count
+                  << ") than needed (" << degenerate_used
                   << "). Extra strings will be ignored.\n";
     }
 
-    // Source validation: check if path intersection is non-empty
-    if (has_sources_) {
-        std::set<int> path_intersection;
+    // Source validation: empty path intersection means no valid biological path exists
+    return !has_sources_ ||
+           has_path_intersection(start_symbol, offset_in_symbol,
+                                 degenerate_strings, pattern.length(), context);
+}
+
+// Batch position checks (see eds.hpp)
+void EDS::check_positions(const PositionQuery* queries, size_t count, bool* out, size_t threads) const {
+    // Resolve start symbols; trivial and out-of-range queries are answered here
+    struct Resolved {
+        size_t symbol;
+        Position offset;
+        size_t query;
+    };
+    std::vector<Resolved> order;
+    order.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        out[i] = false;
+        if (is_empty_ || n_ == 0) {
+            continue;
+        }
+        if (queries[i].pattern.empty()) {
+            out[i] = true;
+            continue;
+        }
+        Position offset = 0;
         try {
-            path_intersection = calculate_path_intersection(
-                start_symbol, offset_in_symbol,
-                degenerate_strings, pattern.length()
-            );
-        } catch (const std::exception&) {
-            // If path intersection calculation fails, propagate error
-            throw;
+            size_t symbol = find_symbol_at_common_position(queries[i].common_pos, offset);
+            order.push_back({symbol, offset, i});
+        } catch (const std::out_of_range&) {
+            // Position is beyond EDS range
         }
+    }
 
-        // Empty intersection means no valid biological path exists
-        if (path_intersection.empty()) {
-            return false;
+    // Symbol order, then choices: neighbours share symbols and intersection prefixes
+    std::sort(order.begin(), order.end(), [queries](const Resolved& a, const Resolved& b) {
+        if (a.symbol != b.symbol) {
+            return a.symbol < b.symbol;
+        }
+        const auto& da = queries[a.query].degenerate_strings;
+        const auto& db = queries[b.query].degenerate_strings;
+        if (da != db) {
+            return da < db;
+        }
+        return a.offset < b.offset;
+    });
+
+    size_t ranges = std::max<size_t>(1, std::min(threads, order.size()));
+    std::vector<size_t> failed(ranges, count);  // First failing query of each range
+    std::vector<std::exception_ptr> errors(ranges);
+
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(ranges) schedule(static, 1)
+#endif
+    for (size_t r = 0; r < ranges; r++) {
+        CheckContext context;
+        size_t first = order.size() / ranges * r;
+        size_t last = (r + 1 == ranges) ? order.size() : order.size() / ranges * (r + 1);
+
+        for (size_t k = first; k < last; k++) {
+            const Resolved& item = order[k];
+            const PositionQuery& query = queries[item.query];
+            try {
+                out[item.query] = check_resolved(item.symbol, item.offset,
+                                                 query.degenerate_strings, query.pattern, context, false);
+            } catch (...) {
+                if (item.query < failed[r]) {
+                    failed[r] = item.query;
+                    errors[r] = std::current_exception();
+                }
+            }
         }
     }
 
-    // Reconstruct string based on storage mode
-    String reconstructed;
-
-    try {
-        if (mode_ == StoringMode::FULL) {
-            reconstructed = reconstruct_from_memory(
-                start_symbol, offset_in_symbol,
-                degenerate_strings, pattern.length()
-            );
-        } else {
-            reconstructed = reconstruct_from_file(
-                start_symbol, offset_in_symbol,
-                degenerate_strings, pattern.length()
-            );
+    size_t first_error = ranges;
+    for (size_t r = 0; r < ranges; r++) {
+        if (errors[r] && (first_error == ranges || failed[r] < failed[first_error])) {
+            first_error = r;
         }
-    } catch (const std::exception&) {
-        // If reconstruction fails (e.g., validation errors),
-        // let the exception propagate
-        throw;
     }
-
-    // If we couldn't reconstruct enough characters, pattern doesn't match
-    if (reconstructed.length() < pattern.length()) {
-        return false;
+    if (first_error != ranges) {
+        std::rethrow_exception(errors[first_error]);
     }
+}
 
-    // Compare reconstructed string with pattern
-    return reconstructed == pattern;
+std::vector<bool> EDS::check_positions(const std::vector<PositionQuery>& queries, size_t threads) const {
+    std::unique_ptr<bool[]> out(new bool[queries.size()]);
+    check_positions(queries.data(), queries.size(), out.get(), threads);
+    return std::vector<bool>(out.get(), out.get() + queries.size());
 }
 
 // Position checking helper: decode absolute degenerate string number
@@ -1056,23 +2032,29 @@ std::pair<size_t, size_t> EDS::decode_degenerate_string_number(int abs_string_nu
         );
     }
 
-    // Binary search to find which symbol this string belongs to
-    auto it = std::upper_bound(
-        metadata_.cum_degenerate_counts.begin(),
-        metadata_.cum_degenerate_counts.end(),
-        abs_string_num
-    );
+    // Find which symbol this string belongs to (binary search, or select on succinct metadata)
+    size_t count;
+    if (succinct_) {
+        count = succinct_->cum_degenerate_counts.upper_bound(static_cast<uint64_t>(abs_string_num));
+    } else {
+        count = std::distance(
+            metadata_.cum_degenerate_counts.begin(),
+            std::upper_bound(metadata_.cum_degenerate_counts.begin(),
+                             metadata_.cum_degenerate_counts.end(),
+                             abs_string_num)
+        );
+    }
 
-    if (it == metadata_.cum_degenerate_counts.begin()) {
+    if (count == 0 || count > n_) {
         throw std::out_of_range(
             "Invalid degenerate string number: " + std::to_string(abs_string_num)
         );
     }
 
-    size_t symbol_idx = std::distance(metadata_.cum_degenerate_counts.begin(), it) - 1;
+    size_t symbol_idx = count - 1;
 
     // Check if this symbol is actually degenerate
-    if (!metadata_.is_degenerate[symbol_idx]) {
+    if (!degenerate_at(symbol_idx)) {
         throw std::runtime_error(
             "Internal error: degenerate string number " +
             std::to_string(abs_string_num) +
@@ -1080,14 +2062,16 @@ std::pair<size_t, size_t> EDS::decode_degenerate_string_number(int abs_string_nu
         );
     }
 
-    size_t local_idx = abs_string_num - metadata_.cum_degenerate_counts[symbol_idx];
+    size_t symbol_first = succinct_ ? static_cast<size_t>(succinct_->cum_degenerate_counts[symbol_idx])
+                                    : static_cast<size_t>(metadata_.cum_degenerate_counts[symbol_idx]);
+    size_t local_idx = abs_string_num - symbol_first;
 
     // Validate local index is within range
-    if (local_idx >= metadata_.symbol_sizes[symbol_idx]) {
+    if (local_idx >= get_symbol_size(symbol_idx)) {
         throw std::out_of_range(
             "Local index " + std::to_string(local_idx) +
             " out of range for symbol " + std::to_string(symbol_idx) +
-            " (size: " + std::to_string(metadata_.symbol_sizes[symbol_idx]) + ")"
+            " (size: " + std::to_string(get_symbol_size(symbol_idx)) + ")"
         );
     }
 
@@ -1096,23 +2080,34 @@ std::pair<size_t, size_t> EDS::decode_degenerate_string_number(int abs_string_nu
 
 // Position checking helper: find symbol containing common position
 size_t EDS::find_symbol_at_common_position(Position common_pos, Position& offset_out) const {
-    // Binary search in cum_common_positions
-    auto it = std::upper_bound(
-        metadata_.cum_common_positions.begin(),
-        metadata_.cum_common_positions.end(),
-        common_pos
-    );
+    // Last symbol starting at or before common_pos (binary search, or select on succinct metadata)
+    size_t count;
+    if (succinct_) {
+        count = succinct_->cum_common_positions.upper_bound(common_pos);
+    } else {
+        count = std::distance(
+            metadata_.cum_common_positions.begin(),
+            std::upper_bound(metadata_.cum_common_positions.begin(),
+                             metadata_.cum_common_positions.end(),
+                             common_pos)
+        );
+    }
 
-    if (it == metadata_.cum_common_positions.begin()) {
+    if (count == 0) {
         throw std::out_of_range(
             "Common position " + std::to_string(common_pos) + " is before EDS start"
         );
     }
+    if (count > n_) {
+        throw std::out_of_range(
+            "Common position " + std::to_string(common_pos) + " is past EDS end"
+        );
+    }
 
-    size_t symbol_idx = std::distance(metadata_.cum_common_positions.begin(), it) - 1;
+    size_t symbol_idx = count - 1;
 
     // This symbol must be non-degenerate (common)
-    if (metadata_.is_degenerate[symbol_idx]) {
+    if (degenerate_at(symbol_idx)) {
         throw std::out_of_range(
             "Common position " + std::to_string(common_pos) +
             " points to degenerate symbol " + std::to_string(symbol_idx)
@@ -1120,11 +2115,11 @@ size_t EDS::find_symbol_at_common_position(Position common_pos, Position& offset
     }
 
     // Calculate offset within the symbol
-    offset_out = common_pos - metadata_.cum_common_positions[symbol_idx];
+    offset_out = common_pos - (succinct_ ? succinct_->cum_common_positions[symbol_idx]
+                                         : metadata_.cum_common_positions[symbol_idx]);
 
     // Validate offset is within the symbol's length
-    size_t global_string_idx = metadata_.cum_set_sizes[symbol_idx];
-    Length symbol_length = metadata_.string_lengths[global_string_idx];
+    Length symbol_length = get_string_length(first_string_of(symbol_idx));
 
     if (offset_out >= symbol_length) {
         throw std::out_of_range(
@@ -1137,190 +2132,179 @@ size_t EDS::find_symbol_at_common_position(Position common_pos, Position& offset
     return symbol_idx;
 }
 
-// Position checking helper: reconstruct string from memory (FULL mode)
-String EDS::reconstruct_from_memory(size_t start_symbol,
-                                   Position offset_in_symbol,
-                                   const std::vector<int>& degenerate_strings,
-                                   Length pattern_length) const {
-    String result;
-    result.reserve(pattern_length);
+// Position checking helper: view of a symbol, kept in a sliding window of the last
+// symbols walked (checks are monotonic in the symbol, and sorted batches too)
+const SymbolView& EDS::window_view(size_t symbol_idx, CheckContext& context) const {
+    // Ring of CHECK_WINDOW_SYMBOLS slots holding symbols [window_first, window_first + window_count)
+    auto& window = context.window;
+    size_t window_end = context.window_first + context.window_count;
+    if (context.window_count > 0 && symbol_idx >= context.window_first && symbol_idx < window_end) {
+        return window[symbol_idx % CHECK_WINDOW_SYMBOLS];
+    }
+
+    if (window.empty()) {
+        window.resize(CHECK_WINDOW_SYMBOLS);
+    }
+    if (context.window_count > 0 && symbol_idx == window_end) {
+        if (context.window_count == CHECK_WINDOW_SYMBOLS) {
+            context.window_first++;  // Slot of the oldest symbol is reused below
+        } else {
+            context.window_count++;
+        }
+    } else {
+        context.window_first = symbol_idx;
+        context.window_count = 1;
+    }
+
+    SymbolView& slot = window[symbol_idx % CHECK_WINDOW_SYMBOLS];
+    slot = symbol_view(symbol_idx);
+    return slot;
+}
 
+// Position checking helper: validate the degenerate string choices before any
+// text is compared, so a mismatch never hides an invalid choice. Walks the
+// symbols the check covers by the chosen strings' lengths from the metadata,
+// with the messages of has_path_intersection when sources are loaded, and
+// returns false where it would (offset past the first symbol). The local index
+// of each choice is left in context.choices for match_in_place.
+bool EDS::validate_choices(size_t start_symbol,
+                           Position offset_in_symbol,
+                           const std::vector<int>& degenerate_strings,
+                           Length pattern_length,
+                           CheckContext& context) const {
     size_t deg_idx = 0;
-    bool first_symbol = true;
+    Length chars_counted = 0;
+    context.choices.clear();
 
     for (size_t symbol_idx = start_symbol;
-         symbol_idx < n_ && result.length() < pattern_length;
+         symbol_idx < n_ && chars_counted < pattern_length;
          symbol_idx++) {
 
-        String str;
+        size_t string_id = first_string_of(symbol_idx);
 
-        if (metadata_.is_degenerate[symbol_idx]) {
-            // Degenerate symbol: use specified string
+        if (degenerate_at(symbol_idx)) {
             if (deg_idx >= degenerate_strings.size()) {
-                throw std::invalid_argument(
-                    "Not enough degenerate strings provided (need at least " +
-                    std::to_string(deg_idx + 1) + ", got " +
-                    std::to_string(degenerate_strings.size()) + ")"
-                );
+                throw std::invalid_argument(has_sources_
+                    ? "Not enough degenerate strings for path intersection calculation"
+                    : "Not enough degenerate strings provided (need at least " +
+                      std::to_string(deg_idx + 1) + ", got " +
+                      std::to_string(degenerate_strings.size()) + ")");
             }
 
             int abs_string_num = degenerate_strings[deg_idx];
             auto [expected_symbol, local_idx] = decode_degenerate_string_number(abs_string_num);
-
-            // Verify this degenerate string belongs to current symbol
             if (expected_symbol != symbol_idx) {
-                throw std::invalid_argument(
-                    "Degenerate string " + std::to_string(abs_string_num) +
-                    " belongs to symbol " + std::to_string(expected_symbol) +
-                    ", but expected for symbol " + std::to_string(symbol_idx)
-                );
+                throw std::invalid_argument(has_sources_
+                    ? "Degenerate string mismatch in path intersection calculation"
+                    : "Degenerate string " + std::to_string(abs_string_num) +
+                      " belongs to symbol " + std::to_string(expected_symbol) +
+                      ", but expected for symbol " + std::to_string(symbol_idx));
             }
-
-            str = sets_[symbol_idx][local_idx];
             deg_idx++;
-
-        } else {
-            // Common symbol: use the only string
-            str = sets_[symbol_idx][0];
-
-            // Apply offset if this is the first symbol
-            if (first_symbol && offset_in_symbol > 0) {
-                if (offset_in_symbol >= str.length()) {
-                    throw std::out_of_range(
-                        "Offset " + std::to_string(offset_in_symbol) +
-                        " exceeds symbol length " + std::to_string(str.length())
-                    );
+            context.choices.push_back(local_idx);
+            string_id += local_idx;
+        } else if (symbol_idx == start_symbol && offset_in_symbol > 0) {
+            Length length = get_string_length(string_id);
+            if (offset_in_symbol >= length) {
+                if (has_sources_) {
+                    return false;
                 }
-                str = str.substr(offset_in_symbol);
-                first_symbol = false;
+                throw std::out_of_range(
+                    "Offset " + std::to_string(offset_in_symbol) +
+                    " exceeds symbol length " + std::to_string(length)
+                );
             }
+            chars_counted += std::min<Length>(length - offset_in_symbol, pattern_length - chars_counted);
+            continue;
         }
 
-        // Take only what we need
-        Length chars_to_take = std::min(
-            static_cast<Length>(str.length()),
-            static_cast<Length>(pattern_length - result.length())
-        );
-
-        result += str.substr(0, chars_to_take);
+        chars_counted += std::min<Length>(get_string_length(string_id), pattern_length - chars_counted);
     }
-
-    return result;
+    return true;
 }
 
-// Position checking helper: reconstruct string from file (METADATA_ONLY mode)
-String EDS::reconstruct_from_file(size_t start_symbol,
-                                 Position offset_in_symbol,
-                                 const std::vector<int>& degenerate_strings,
-                                 Length pattern_length) const {
-    String result;
-    result.reserve(pattern_length);
-
+// Position checking helper: compare the pattern with the chosen strings in place.
+// One walk over the symbols, no copy and no allocation in FULL mode (views of a
+// METADATA_ONLY EDS come from the context's window); returns at the first
+// mismatching slice. The choices were resolved by validate_choices.
+// `degenerate_used` is the number of choices consumed by a complete match.
+bool EDS::match_in_place(size_t start_symbol,
+                         Position offset_in_symbol,
+                         std::string_view pattern,
+                         CheckContext& context,
+                         size_t& degenerate_used) const {
+    size_t matched = 0;
     size_t deg_idx = 0;
-    bool first_symbol = true;
 
     for (size_t symbol_idx = start_symbol;
-         symbol_idx < n_ && result.length() < pattern_length;
+         symbol_idx < n_ && matched < pattern.size();
          symbol_idx++) {
 
-        // Read symbol from file using existing method
-        StringSet symbol_strings = read_symbol(symbol_idx);
-
-        String str;
-
-        if (metadata_.is_degenerate[symbol_idx]) {
-            // Degenerate symbol: use specified string
-            if (deg_idx >= degenerate_strings.size()) {
-                throw std::invalid_argument(
-                    "Not enough degenerate strings provided (need at least " +
-                    std::to_string(deg_idx + 1) + ", got " +
-                    std::to_string(degenerate_strings.size()) + ")"
-                );
-            }
-
-            int abs_string_num = degenerate_strings[deg_idx];
-            auto [expected_symbol, local_idx] = decode_degenerate_string_number(abs_string_num);
-
-            // Verify this degenerate string belongs to current symbol
-            if (expected_symbol != symbol_idx) {
-                throw std::invalid_argument(
-                    "Degenerate string " + std::to_string(abs_string_num) +
-                    " belongs to symbol " + std::to_string(expected_symbol) +
-                    ", but expected for symbol " + std::to_string(symbol_idx)
-                );
-            }
+        size_t local_idx = 0;
 
-            if (local_idx >= symbol_strings.size()) {
-                throw std::runtime_error(
-                    "Local index " + std::to_string(local_idx) +
-                    " out of range for symbol (size: " +
-                    std::to_string(symbol_strings.size()) + ")"
-                );
-            }
+        if (degenerate_at(symbol_idx)) {
+            // Degenerate symbol: use the specified string
+            local_idx = context.choices[deg_idx++];
+        }
 
-            str = symbol_strings[local_idx];
-            deg_idx++;
+        std::string_view str = (mode_ == StoringMode::FULL)
+            ? string_at(first_string_of(symbol_idx) + local_idx)
+            : window_view(symbol_idx, context)[local_idx];
 
-        } else {
-            // Common symbol: use the only string
-            if (symbol_strings.empty()) {
-                throw std::runtime_error(
-                    "Common symbol " + std::to_string(symbol_idx) + " is empty"
+        // Common symbol: apply offset if this is the first symbol
+        if (symbol_idx == start_symbol && offset_in_symbol > 0) {
+            if (offset_in_symbol >= str.size()) {
+                throw std::out_of_range(
+                    "Offset " + std::to_string(offset_in_symbol) +
+                    " exceeds symbol length " + std::to_string(str.size())
                 );
             }
-
-            str = symbol_strings[0];
-
-            // Apply offset if this is the first symbol
-            if (first_symbol && offset_in_symbol > 0) {
-                if (offset_in_symbol >= str.length()) {
-                    throw std::out_of_range(
-                        "Offset " + std::to_string(offset_in_symbol) +
-                        " exceeds symbol length " + std::to_string(str.length())
-                    );
-                }
-                str = str.substr(offset_in_symbol);
-                first_symbol = false;
-            }
+            str.remove_prefix(offset_in_symbol);
         }
 
-        // Take only what we need
-        Length chars_to_take = std::min(
-            static_cast<Length>(str.length()),
-            static_cast<Length>(pattern_length - result.length())
-        );
-
-        result += str.substr(0, chars_to_take);
+        // Compare only what we need (memcmp is vectorized by the C library)
+        size_t take = std::min(str.size(), pattern.size() - matched);
+        if (take > 0 && std::memcmp(str.data(), pattern.data() + matched, take) != 0) {
+            return false;
+        }
+        matched += take;
     }
 
-    return result;
+    degenerate_used = deg_idx;
+
+    // The EDS may end before the pattern does
+    return matched == pattern.size();
 }
 
-// Position checking helper: calculate path intersection for source validation
-std::set<int> EDS::calculate_path_intersection(size_t start_symbol,
-                                               Position offset_in_symbol,
-                                               const std::vector<int>& degenerate_strings,
-                                               Length pattern_length) const {
-    // If no sources loaded, return universal set {0}
+// Position checking helper: whether the strings walked share a path (source validation).
+// The intersection after each string is kept in the context, so a query walking the
+// same strings as the previous one resumes after their longest common prefix.
+bool EDS::has_path_intersection(size_t start_symbol,
+                                Position offset_in_symbol,
+                                const std::vector<int>& degenerate_strings,
+                                Length pattern_length,
+                                CheckContext& context) const {
+    // If no sources loaded, there is nothing to intersect
     if (!has_sources_) {
-        return {0};
+        throw std::runtime_error("has_path_intersection: No sources loaded");
     }
 
-    // Start with universal set (all paths)
-    std::set<int> intersection;
-    bool first = true;
+    auto& strings = context.path_strings;
+    auto& prefix = context.path_prefix;
+    size_t step = 0;
+    bool shared = true;  // Strings so far are those of the previous walk
 
     size_t deg_idx = 0;
     Length chars_counted = 0;
 
     for (size_t symbol_idx = start_symbol;
          symbol_idx < n_ && chars_counted < pattern_length;
-         symbol_idx++) {
+         symbol_idx++, step++) {
 
         // Determine which string is used from this symbol
         size_t global_string_idx;
 
-        if (metadata_.is_degenerate[symbol_idx]) {
+        if (degenerate_at(symbol_idx)) {
             // Degenerate symbol: use specified string
             if (deg_idx >= degenerate_strings.size()) {
                 throw std::invalid_argument(
@@ -1338,83 +2322,66 @@ std::set<int> EDS::calculate_path_intersection(size_t start_symbol,
             }
 
             // Convert to global string ID
-            global_string_idx = metadata_.cum_set_sizes[symbol_idx] + local_idx;
+            global_string_idx = first_string_of(symbol_idx) + local_idx;
             deg_idx++;
 
         } else {
             // Common symbol: use the only string
-            global_string_idx = metadata_.cum_set_sizes[symbol_idx];
+            global_string_idx = first_string_of(symbol_idx);
 
             // Apply offset for first symbol
+            Length sym_len = get_string_length(global_string_idx);
             if (symbol_idx == start_symbol && offset_in_symbol > 0) {
-                Length sym_len = metadata_.string_lengths[global_string_idx];
                 if (offset_in_symbol >= sym_len) {
                     // Offset exceeds symbol length - invalid
-                    return {};
+                    return false;
                 }
                 sym_len -= offset_in_symbol;
-                chars_counted += std::min(sym_len, static_cast<Length>(pattern_length - chars_counted));
-            } else {
-                Length sym_len = metadata_.string_lengths[global_string_idx];
-                chars_counted += std::min(sym_len, static_cast<Length>(pattern_length - chars_counted));
             }
+            chars_counted += std::min(sym_len, static_cast<Length>(pattern_length - chars_counted));
         }
 
-        // Get source set for this string
-        if (global_string_idx >= sources_.size()) {
-            throw std::runtime_error(
-                "String ID " + std::to_string(global_string_idx) +
-                " out of range for sources (size: " + std::to_string(sources_.size()) + ")"
-            );
-        }
-
-        const std::set<int>& current_sources = sources_[global_string_idx];
-
-        // Compute intersection
-        if (first) {
-            intersection = current_sources;
-            first = false;
+        // Reuse the intersection of the shared prefix, or intersect and record it
+        if (shared && step < strings.size() && strings[step] == global_string_idx) {
+            if (prefix[step].empty()) {
+                return false;
+            }
         } else {
-            // Intersection with special handling for universal marker {0}
-            std::set<int> new_intersection;
-
-            bool current_has_universal = current_sources.count(0) > 0;
-            bool accum_has_universal = intersection.count(0) > 0;
-
-            if (current_has_universal && accum_has_universal) {
-                // {0} ∩ {0} = {0}
-                new_intersection.insert(0);
-            } else if (current_has_universal) {
-                // {0} ∩ {x,y,...} = {x,y,...}
-                new_intersection = intersection;
-            } else if (accum_has_universal) {
-                // {x,y,...} ∩ {0} = {x,y,...}
-                new_intersection = current_sources;
-            } else {
-                // Regular set intersection
-                std::set_intersection(
-                    intersection.begin(), intersection.end(),
-                    current_sources.begin(), current_sources.end(),
-                    std::inserter(new_intersection, new_intersection.begin())
+            shared = false;
+            strings.resize(step);
+            prefix.resize(step);
+
+            // Get source set for this string
+            size_t source_count = source_index_ ? source_index_->size() : sources_.size();
+            if (global_string_idx >= source_count) {
+                throw std::runtime_error(
+                    "String ID " + std::to_string(global_string_idx) +
+                    " out of range for sources (size: " + std::to_string(source_count) + ")"
                 );
             }
 
-            intersection = new_intersection;
-        }
+            std::shared_ptr<const SourceBlock> hold;
+            const SourceSet& current_sources = source_at(global_string_idx, hold);
+
+            // Compute intersection (the universal marker {0} is handled by the table)
+            strings.push_back(global_string_idx);
+            prefix.push_back(step == 0 ? current_sources
+                                       : source_numbering().intersect(prefix[step - 1], current_sources));
 
-        // Early termination if intersection becomes empty
-        if (intersection.empty()) {
-            return {};
+            // Early termination if intersection becomes empty
+            if (prefix[step].empty()) {
+                return false;
+            }
         }
 
         // Update chars_counted for degenerate symbols
-        if (metadata_.is_degenerate[symbol_idx]) {
-            Length sym_len = metadata_.string_lengths[global_string_idx];
+        if (degenerate_at(symbol_idx)) {
+            Length sym_len = get_string_length(global_string_idx);
             chars_counted += std::min(sym_len, static_cast<Length>(pattern_length - chars_counted));
         }
     }
 
-    return intersection;
+    return true;
 }
 
 // ================================================================================
@@ -1433,6 +2400,10 @@ EDS EDS::merge_adjacent(size_t pos1, size_t pos2) const {
         );
     }
 
+    if (succinct_) {
+        throw std::runtime_error("merge_adjacent() needs plain metadata (EDS was compressed)");
+    }
+
     // Validation: both positions must be within bounds
     if (pos1 >= n_ || pos2 >= n_) {
         throw std::out_of_range(
@@ -1443,80 +2414,17 @@ EDS EDS::merge_adjacent(size_t pos1, size_t pos2) const {
 
     // ===== CALCULATE MERGED METADATA =====
 
-    // Get source indices for the two symbols
     size_t global_string_idx1 = metadata_.cum_set_sizes[pos1];
     size_t global_string_idx2 = metadata_.cum_set_sizes[pos2];
-    size_t set1_size = metadata_.symbol_sizes[pos1];
     size_t set2_size = metadata_.symbol_sizes[pos2];
 
-    // Calculate merged symbol size and prepare merged data
-    size_t merged_size;
-    std::vector<std::set<int>> merged_sources;
-    std::vector<Length> merged_string_lengths;
-
-    if (!has_sources_) {
-        // CARTESIAN merge: size is product
-        merged_size = set1_size * set2_size;
-
-        // Calculate string lengths for all combinations
-        for (size_t i = 0; i < set1_size; ++i) {
-            Length len1 = metadata_.string_lengths[global_string_idx1 + i];
-            for (size_t j = 0; j < set2_size; ++j) {
-                Length len2 = metadata_.string_lengths[global_string_idx2 + j];
-                merged_string_lengths.push_back(len1 + len2);
-            }
-        }
-    } else {
-        // LINEAR merge: only count valid combinations (non-empty intersection)
-        for (size_t i = 0; i < set1_size; ++i) {
-            const std::set<int>& sources1 = sources_[global_string_idx1 + i];
-            Length len1 = metadata_.string_lengths[global_string_idx1 + i];
-
-            for (size_t j = 0; j < set2_size; ++j) {
-                const std::set<int>& sources2 = sources_[global_string_idx2 + j];
-                Length len2 = metadata_.string_lengths[global_string_idx2 + j];
-
-                // Compute intersection with special handling for {0}
-                std::set<int> intersection;
-                bool sources1_has_universal = sources1.count(0) > 0;
-                bool sources2_has_universal = sources2.count(0) > 0;
-
-                if (sources1_has_universal && sources2_has_universal) {
-                    // {0} ∩ {0} = {0}
-                    intersection.insert(0);
-                } else if (sources1_has_universal) {
-                    // {0} ∩ {x,y,...} = {x,y,...}
-                    intersection = sources2;
-                } else if (sources2_has_universal) {
-                    // {x,y,...} ∩ {0} = {x,y,...}
-                    intersection = sources1;
-                } else {
-                    // Regular set intersection
-                    std::set_intersection(
-                        sources1.begin(), sources1.end(),
-                        sources2.begin(), sources2.end(),
-                        std::inserter(intersection, intersection.begin())
-                    );
-                }
-
-                // Only keep if intersection is non-empty
-                if (!intersection.empty()) {
-                    merged_sources.push_back(intersection);
-                    merged_string_lengths.push_back(len1 + len2);
-                }
-            }
-        }
-
-        merged_size = merged_sources.size();
+    MergedSymbol merged = merge_symbols(pos1, pos2);
+    size_t merged_size = merged.strings.size();
 
-        // Validation: merged set must not be empty
-        if (merged_size == 0) {
-            throw std::runtime_error(
-                "Merging positions " + std::to_string(pos1) + " and " +
-                std::to_string(pos2) + " results in empty set "
-                "(no valid source intersections)"
-            );
-        }
+    std::vector<Length> merged_string_lengths;
+    merged_string_lengths.reserve(merged_size);
+    for (const auto& str : merged.strings) {
+        merged_string_lengths.push_back(static_cast<Length>(str.size()));
     }
 
     // ===== BUILD NEW EDS =====
@@ -1531,6 +2439,7 @@ EDS EDS::merge_adjacent(size_t pos1, size_t pos2) const {
     // ===== BUILD NEW METADATA =====
 
     result.metadata_.base_positions.clear();
+    result.metadata_.symbol_byte_lengths.clear();
     result.metadata_.symbol_sizes.clear();
     result.metadata_.string_lengths.clear();
     result.metadata_.cum_set_sizes.clear();
@@ -1541,6 +2450,7 @@ EDS EDS::merge_adjacent(size_t pos1, size_t pos2) const {
     // Copy metadata for positions before pos1
     for (size_t i = 0; i < pos1; ++i) {
         result.metadata_.base_positions.push_back(metadata_.base_positions[i]);
+        result.metadata_.symbol_byte_lengths.push_back(metadata_.symbol_byte_lengths[i]);
         result.metadata_.symbol_sizes.push_back(metadata_.symbol_sizes[i]);
         result.metadata_.is_degenerate.push_back(metadata_.is_degenerate[i]);
         result.metadata_.cum_set_sizes.push_back(current_string_idx);
@@ -1557,6 +2467,8 @@ EDS EDS::merge_adjacent(size_t pos1, size_t pos2) const {
 
     // Add merged position metadata
     result.metadata_.base_positions.push_back(metadata_.base_positions[pos1]);
+    result.metadata_.symbol_byte_lengths.push_back(static_cast<Length>(
+        (metadata_.base_positions[pos2] - metadata_.base_positions[pos1]) + metadata_.symbol_byte_lengths[pos2]));
     result.metadata_.symbol_sizes.push_back(merged_size);
     result.metadata_.is_degenerate.push_back(merged_size > 1);  // Degenerate if > 1 alternative
     result.metadata_.cum_set_sizes.push_back(current_string_idx);
@@ -1570,6 +2482,7 @@ EDS EDS::merge_adjacent(size_t pos1, size_t pos2) const {
     // Copy metadata for positions after pos2
     for (size_t i = pos2 + 1; i < n_; ++i) {
         result.metadata_.base_positions.push_back(metadata_.base_positions[i]);
+        result.metadata_.symbol_byte_lengths.push_back(metadata_.symbol_byte_lengths[i]);
         result.metadata_.symbol_sizes.push_back(metadata_.symbol_sizes[i]);
         result.metadata_.is_degenerate.push_back(metadata_.is_degenerate[i]);
         result.metadata_.cum_set_sizes.push_back(current_string_idx);
@@ -1594,92 +2507,57 @@ EDS EDS::merge_adjacent(size_t pos1, size_t pos2) const {
     // ===== BUILD SOURCES (if needed) =====
 
     if (has_sources_) {
-        result.sources_.clear();
-
-        // Copy sources before pos1
-        size_t source_idx = 0;
-        for (size_t i = 0; i < pos1; ++i) {
-            for (size_t j = 0; j < metadata_.symbol_sizes[i]; ++j) {
-                result.sources_.push_back(sources_[source_idx++]);
-            }
-        }
-
-        // Add merged sources
-        for (const auto& src : merged_sources) {
-            result.sources_.push_back(src);
+        // Same path numbering as this EDS; sources outside the pair are copied as blocks
+        // (sources read on demand are decoded once for the whole result)
+        SourceTable decoded_sources;
+        if (source_index_) {
+            decoded_sources = source_index_->materialize();
         }
-
-        // Skip sources for pos1 and pos2
-        source_idx = metadata_.cum_set_sizes[pos2] + metadata_.symbol_sizes[pos2];
-
-        // Copy sources after pos2
-        for (size_t i = pos2 + 1; i < n_; ++i) {
-            for (size_t j = 0; j < metadata_.symbol_sizes[i]; ++j) {
-                result.sources_.push_back(sources_[source_idx++]);
-            }
+        const SourceTable& sources = source_index_ ? decoded_sources : sources_;
+
+        size_t end2 = global_string_idx2 + set2_size;
+        result.sources_ = sources.derive();
+        result.sources_.reserve(result.m_);
+        result.sources_.append(sources, 0, global_string_idx1);
+        for (auto& src : merged.sources) {
+            result.sources_.push_back(std::move(src));
         }
+        result.sources_.append(sources, end2, m_ - end2);
     }
 
     // ===== BUILD SETS (FULL mode only) =====
 
     if (mode_ == StoringMode::FULL) {
-        result.sets_.clear();
-
-        // Copy sets before pos1
-        for (size_t i = 0; i < pos1; ++i) {
-            result.sets_.push_back(sets_[i]);
+        // Strings outside the merged pair keep their relative layout, so both
+        // sides are copied as single blocks and only the offsets are shifted
+        size_t first1 = global_string_idx1;
+        size_t end2 = global_string_idx2 + metadata_.symbol_sizes[pos2];
+        Position prefix_bytes = string_offsets_[first1];
+        Position suffix_bytes = string_offsets_[m_] - string_offsets_[end2];
+
+        Position merged_bytes = 0;
+        for (Length len : merged_string_lengths) {
+            merged_bytes += len;
         }
 
-        // Build merged set
-        StringSet merged_set;
-        const StringSet& set1 = sets_[pos1];
-        const StringSet& set2 = sets_[pos2];
+        result.arena_.clear();
+        result.arena_.reserve(prefix_bytes + merged_bytes + suffix_bytes);
+        result.arena_.append(arena_, 0, prefix_bytes);
 
-        if (!has_sources_) {
-            // CARTESIAN: all combinations
-            for (const auto& str1 : set1) {
-                for (const auto& str2 : set2) {
-                    merged_set.push_back(str1 + str2);
-                }
-            }
-        } else {
-            // LINEAR: only valid combinations (same logic as metadata calculation)
-            for (size_t i = 0; i < set1.size(); ++i) {
-                for (size_t j = 0; j < set2.size(); ++j) {
-                    const std::set<int>& sources1 = sources_[global_string_idx1 + i];
-                    const std::set<int>& sources2 = sources_[global_string_idx2 + j];
-
-                    // Compute intersection
-                    std::set<int> intersection;
-                    bool sources1_has_universal = sources1.count(0) > 0;
-                    bool sources2_has_universal = sources2.count(0) > 0;
-
-                    if (sources1_has_universal && sources2_has_universal) {
-                        intersection.insert(0);
-                    } else if (sources1_has_universal) {
-                        intersection = sources2;
-                    } else if (sources2_has_universal) {
-                        intersection = sources1;
-                    } else {
-                        std::set_intersection(
-                            sources1.begin(), sources1.end(),
-                            sources2.begin(), sources2.end(),
-                            std::inserter(intersection, intersection.begin())
-                        );
-                    }
+        result.string_offsets_.clear();
+        result.string_offsets_.reserve(result.m_ + 1);
+        result.string_offsets_.assign(string_offsets_.begin(), string_offsets_.begin() + first1 + 1);
 
-                    if (!intersection.empty()) {
-                        merged_set.push_back(set1[i] + set2[j]);
-                    }
-                }
-            }
+        for (const auto& str : merged.strings) {
+            result.arena_.append(str);
+            result.string_offsets_.push_back(result.arena_.size());
         }
 
-        result.sets_.push_back(merged_set);
-
-        // Copy sets after pos2
-        for (size_t i = pos2 + 1; i < n_; ++i) {
-            result.sets_.push_back(sets_[i]);
+        // Copy strings after pos2, rebasing their offsets
+        Position shift = result.arena_.size();
+        result.arena_.append(arena_, string_offsets_[end2], suffix_bytes);
+        for (size_t k = end2 + 1; k <= m_; ++k) {
+            result.string_offsets_.push_back(shift + (string_offsets_[k] - string_offsets_[end2]));
         }
     }
 
@@ -1694,4 +2572,79 @@ EDS EDS::merge_adjacent(size_t pos1, size_t pos2) const {
     return result;
 }
 
+
+// Merge kernel: the merged symbol of an adjacent pair, from the two input symbols only
+EDS::MergedSymbol EDS::merge_symbols(size_t pos1, size_t pos2) const {
+    if (pos2 != pos1 + 1) {
+        throw std::invalid_argument(
+            "Positions must be adjacent: pos2 (" + std::to_string(pos2) +
+            ") must equal pos1 + 1 (" + std::to_string(pos1 + 1) + ")"
+        );
+    }
+    if (pos1 >= n_ || pos2 >= n_) {
+        throw std::out_of_range(
+            "Position out of range: pos1=" + std::to_string(pos1) +
+            ", pos2=" + std::to_string(pos2) + ", n=" + std::to_string(n_)
+        );
+    }
+
+    SymbolView set1 = symbol_view(pos1);
+    SymbolView set2 = symbol_view(pos2);
+    size_t first1 = first_string_of(pos1);
+    size_t first2 = first_string_of(pos2);
+
+    MergedSymbol merged;
+
+    auto append = [&merged](std::string_view str1, std::string_view str2) {
+        String str;
+        str.reserve(str1.size() + str2.size());
+        str.append(str1).append(str2);
+        merged.strings.push_back(std::move(str));
+    };
+
+    if (!has_sources_) {
+        // CARTESIAN merge: all combinations
+        merged.strings.reserve(set1.size() * set2.size());
+        for (std::string_view str1 : set1) {
+            for (std::string_view str2 : set2) {
+                append(str1, str2);
+            }
+        }
+        return merged;
+    }
+
+    // LINEAR merge: only combinations whose path sets intersect
+    // (the universal marker {0} is handled by the table)
+    const SourceTable& numbering = source_numbering();
+    std::shared_ptr<const SourceBlock> hold1;
+    std::shared_ptr<const SourceBlock> hold2;
+
+    size_t i = 0;
+    for (std::string_view str1 : set1) {
+        const SourceSet& sources1 = source_at(first1 + i, hold1);
+
+        size_t j = 0;
+        for (std::string_view str2 : set2) {
+            SourceSet intersection = numbering.intersect(sources1, source_at(first2 + j, hold2));
+            if (!intersection.empty()) {
+                append(str1, str2);
+                merged.sources.push_back(std::move(intersection));
+            }
+            j++;
+        }
+        i++;
+    }
+
+    // Validation: merged set must not be empty
+    if (merged.strings.empty()) {
+        throw std::runtime_error(
+            "Merging positions " + std::to_string(pos1) + " and " +
+            std::to_string(pos2) + " results in empty set "
+            "(no valid source intersections)"
+        );
+    }
+
+    return merged;
+}
+
 } // namespace edsparser
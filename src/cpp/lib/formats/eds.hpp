@@ -2,12 +2,22 @@
 #define EDSPARSER_EDS_HPP
 
 #include "../common.hpp"
+#include "edz.hpp"
+#include "eds_index.hpp"
+#include "symbol_view.hpp"
+#include "block_cache.hpp"
+#include "succinct.hpp"
+#include "source_set.hpp"
+#include "seds.hpp"
+#include "source_index.hpp"
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <set>
 #include <fstream>
 #include <filesystem>
+#include <memory>
 
 namespace edsparser {
 
@@ -18,10 +28,26 @@ namespace edsparser {
  * Format: {str1,str2,...}{str3}{str4,str5}...
  * Compact format (optional): str1{str2,str3}str4 (brackets only on degenerate symbols)
  * Empty strings are represented as empty entries between commas.
+ * Binary format (.edz): serialized metadata + 2-bit packed payload (see edz.hpp),
+ * detected by its magic bytes wherever text input is accepted.
  *
  * Storage modes:
- * - FULL: All strings loaded into RAM (default, backward compatible)
- * - METADATA_ONLY: Only metadata/index loaded, strings streamed on-demand (memory-efficient)
+ * - FULL: All strings loaded into RAM (default, backward compatible), concatenated
+ *         in a single contiguous buffer indexed by string ID
+ * - METADATA_ONLY: Only metadata/index loaded, strings streamed on-demand (memory-efficient);
+ *                  sources loaded from a file are likewise decoded on demand (see SourceIndex)
+ *
+ * Thread safety:
+ * A loaded EDS holds no mutable state apart from the optional block caches, which
+ * lock internally. METADATA_ONLY reads are positional (pread, or views into a
+ * read-only mapping), so there is no shared seek position. In both
+ * modes these const methods may be called concurrently on one EDS from any number
+ * of threads:
+ *   read_symbol, symbol_view, get_string, extract, check_position(s), generate_patterns,
+ *   merge_adjacent, get_sets, get_metadata / get_statistics and the other getters,
+ *   print, save and save_sources (each thread with its own stream or path).
+ * Non-const methods (load_sources, assignment) must not overlap with any other call.
+ * Loading the same file concurrently is safe; the sidecar index is replaced atomically.
  */
 class EDS {
 public:
@@ -34,9 +60,13 @@ public:
     // Output format options
     enum class OutputFormat {
         FULL,     // Always use brackets: {ACGT}{A,ACA}{CGT}
-        COMPACT   // Omit brackets on non-degenerate: ACGT{A,ACA}CGT
+        COMPACT,  // Omit brackets on non-degenerate: ACGT{A,ACA}CGT
+        BINARY    // Packed .edz container (includes sources if loaded)
     };
 
+    // Source (sEDS) encodings: TEXT {1,2,3}, RANGES {1-3}, BINARY .sedz runs
+    using SourcesFormat = seds::Format;
+
     // Default constructor
     EDS() : is_empty_(true), mode_(StoringMode::FULL), has_sources_(false) {}
 
@@ -49,8 +79,25 @@ public:
     EDS(const std::string& eds_string, const std::string& seds_string);
 
     // File-based loaders (with optional StoringMode for memory efficiency)
-    static EDS load(const std::filesystem::path& path, StoringMode mode = StoringMode::FULL);
-    static EDS load(const std::filesystem::path& eds_path, const std::filesystem::path& seds_path, StoringMode mode = StoringMode::FULL);
+    // cache_budget (METADATA_ONLY only): bytes of decoded symbol blocks kept in RAM
+    // (see block_cache.hpp). 0 disables the cache; symbols are then viewed in a
+    // mapping of the file (text) or decoded on every access (.edz).
+    // threads: text input is cut at symbol boundaries and parsed in that many
+    // chunks in parallel (the result is identical to a sequential parse); with
+    // an sEDS file, one of the threads tokenizes the sources meanwhile.
+    // METADATA_ONLY with an sEDS file: the sources are indexed, not loaded, and
+    // decoded on demand into a cache of cache_budget bytes
+    // (SourceIndex::DEFAULT_CACHE_BUDGET when 0).
+    static EDS load(const std::filesystem::path& path, StoringMode mode = StoringMode::FULL,
+                    size_t cache_budget = 0, size_t threads = 1);
+    static EDS load(const std::filesystem::path& eds_path, const std::filesystem::path& seds_path,
+                    StoringMode mode = StoringMode::FULL, size_t cache_budget = 0, size_t threads = 1);
+
+    // Sidecar metadata index (<file>.idx, see eds_index.hpp)
+    // METADATA_ONLY loads of text files use a current index instead of parsing,
+    // and write one (best effort) when it is missing or stale.
+    static void build_index(const std::filesystem::path& path);        // (Re)build the sidecar, throws on failure
+    static bool has_current_index(const std::filesystem::path& path);  // Sidecar exists and matches the file
 
     // Convenience factory for string construction
     static EDS from_string(const std::string& eds_string);
@@ -60,7 +107,7 @@ public:
     ~EDS() = default;
 
     // Copy and move constructors/assignments
-    // Note: Copy is deleted because of ifstream member (non-copyable in METADATA_ONLY mode)
+    // Note: Copy is deleted because of the file handle (non-copyable in METADATA_ONLY mode)
     EDS(const EDS&) = delete;
     EDS& operator=(const EDS&) = delete;
     EDS(EDS&&) = default;
@@ -78,7 +125,9 @@ public:
     // This is the core of memory-efficient streaming EDS
     struct Metadata {
         // Index data (position/size information)
-        std::vector<std::streampos> base_positions;   // Starting position of each symbol in file
+        std::vector<std::streampos> base_positions;   // Starting byte offset of each symbol in file
+                                                      // (.edz: character offset into the payload)
+        std::vector<Length> symbol_byte_lengths;      // Byte span of each symbol in file (.edz: characters)
         std::vector<Length> symbol_sizes;             // Number of strings per symbol (n entries)
         std::vector<Length> string_lengths;           // Length of each string (m entries total)
         std::vector<Length> cum_set_sizes;            // Cumulative string IDs (for mapping)
@@ -126,13 +175,14 @@ public:
     // Output methods
     void print(std::ostream& os = std::cout) const;
     void save(std::ostream& os, OutputFormat format = OutputFormat::FULL) const;
-    void save(const std::filesystem::path& path, OutputFormat format = OutputFormat::FULL) const;
-    void save_sources(std::ostream& os) const;  // Save sEDS format
-    void save_sources(const std::filesystem::path& path) const;  // Save sEDS to file
+    void save(const std::filesystem::path& path, OutputFormat format = OutputFormat::FULL) const;  // .edz paths are always BINARY
+    void save_sources(std::ostream& os, SourcesFormat format = SourcesFormat::TEXT) const;  // Save sEDS format
+    void save_sources(const std::filesystem::path& path, SourcesFormat format = SourcesFormat::TEXT) const;  // .sedz paths are always BINARY
 
     // Loading methods (sources only - EDS loading is via constructors/static load)
+    // Every sEDS encoding is accepted (text, ranges, binary), see seds.hpp
     void load_sources(std::istream& is);  // Load sources from sEDS stream
-    void load_sources(const std::filesystem::path& path);  // Load sources from sEDS file
+    void load_sources(const std::filesystem::path& path);  // Load sources from sEDS file (METADATA_ONLY: on demand)
     void load_sources(const std::string& seds_string);  // Load sources from sEDS string
 
     // Pattern generation for benchmarking
@@ -146,6 +196,27 @@ public:
                        const std::vector<int>& degenerate_strings,
                        const String& pattern) const;
 
+    // Batch queries (arguments and results as the single calls above)
+    struct PositionQuery {
+        Position common_pos = 0;
+        std::vector<int> degenerate_strings;
+        String pattern;
+    };
+    struct ExtractQuery {
+        Position pos = 0;
+        Length len = 0;
+        std::vector<int> changes;
+    };
+
+    // Queries are answered in symbol order, split into contiguous ranges over
+    // `threads`; each range reuses the symbols it viewed and the source
+    // intersection of the longest string prefix shared with the previous query.
+    // Extra degenerate strings are ignored without the warning of check_position.
+    // If queries fail, the exception of the first one (in input order) is rethrown.
+    void check_positions(const PositionQuery* queries, size_t count, bool* out, size_t threads = 1) const;
+    std::vector<bool> check_positions(const std::vector<PositionQuery>& queries, size_t threads = 1) const;
+    std::vector<String> extract(const std::vector<ExtractQuery>& queries, size_t threads = 1) const;  // FULL mode only
+
     // Merging: merge two adjacent symbols (degenerate or non-degenerate)
     // Example: {G,C} + {T} → {GT,CT}
     // Example: {T} + {A,C,G} → {TA,TC,TG}
@@ -157,16 +228,56 @@ public:
     // Throws: std::invalid_argument if positions not adjacent (pos2 != pos1 + 1)
     EDS merge_adjacent(size_t pos1, size_t pos2) const;
 
+    // Merged symbol of two adjacent positions alone, as merge_adjacent would build
+    // it: the concatenations (all of them, or with sources those whose path sets
+    // intersect) and their sources, numbered like this EDS's source table. Costs
+    // |set1| x |set2| intersections regardless of the EDS size; works in both modes.
+    struct MergedSymbol {
+        StringSet strings;
+        std::vector<SourceSet> sources;  // Empty without sources
+    };
+    MergedSymbol merge_symbols(size_t pos1, size_t pos2) const;
+
     // Access to internal data
-    const std::vector<StringSet>& get_sets() const;  // Throws if METADATA_ONLY mode
-    const std::vector<bool>& get_is_degenerate() const { return metadata_.is_degenerate; }
-    const std::vector<std::set<int>>& get_sources() const { return sources_; }
+    std::vector<StringSet> get_sets() const;  // Materialized copy; throws if METADATA_ONLY mode
+    const std::vector<bool>& get_is_degenerate() const { return metadata_.is_degenerate; }  // Empty once compressed
+    std::vector<std::set<int>> get_sources() const;  // Materialized copy (path IDs)
+    const SourceTable& get_source_table() const;     // Sources as stored; throws if they are read on demand
+    std::vector<int32_t> get_string_sources(size_t string_id) const;  // Path IDs of one string, in order (both modes)
+    bool has_lazy_sources() const { return source_index_ != nullptr; }  // Sources decoded on demand (METADATA_ONLY)
 
     // Streaming access (works in both modes)
     StringSet read_symbol(Position pos) const;  // Read symbol from file or memory
-    Length get_symbol_size(Position pos) const { return metadata_.symbol_sizes[pos]; }
-    std::streampos get_base_position(Position pos) const { return metadata_.base_positions[pos]; }
-    Length get_string_length(size_t string_id) const { return metadata_.string_lengths[string_id]; }
+    SymbolView symbol_view(Position pos) const;  // Zero-copy view of a symbol (arena or file mapping)
+    Length get_symbol_size(Position pos) const {
+        return succinct_ ? static_cast<Length>(succinct_->cum_set_sizes[pos + 1] - succinct_->cum_set_sizes[pos])
+                         : metadata_.symbol_sizes[pos];
+    }
+    std::streampos get_base_position(Position pos) const {
+        return succinct_ ? std::streampos(static_cast<std::streamoff>(succinct_->base_positions[pos]))
+                         : metadata_.base_positions[pos];
+    }
+    Length get_symbol_byte_length(Position pos) const {
+        return succinct_ ? static_cast<Length>(succinct_->symbol_byte_lengths[pos]) : metadata_.symbol_byte_lengths[pos];
+    }
+    Length get_string_length(size_t string_id) const {
+        return succinct_ ? static_cast<Length>(succinct_->string_lengths[string_id]) : metadata_.string_lengths[string_id];
+    }
+    BlockCache::Stats get_cache_stats() const;  // Hit/miss counters (all zero without a cache)
+    BlockCacheStats get_source_cache_stats() const;  // Same for lazily decoded sources
+
+    // Succinct metadata (METADATA_ONLY only, see succinct.hpp)
+    // Replaces the per-symbol arrays by Elias-Fano prefix sums, bit-packed lengths and
+    // a rank/select degenerate bit vector. All queries keep working through the getters
+    // above; get_metadata() then only carries the statistics, get_is_degenerate() is
+    // empty, and merge_adjacent() is unavailable.
+    void compress_metadata();
+    bool has_compressed_metadata() const { return succinct_ != nullptr; }
+    size_t metadata_bytes() const;  // Resident size of the per-symbol metadata
+
+    // Zero-copy string access (FULL mode only, views stay valid while the EDS is alive)
+    std::string_view get_string(size_t string_id) const;                // By global string ID
+    std::string_view get_string(Position pos, size_t local_idx) const;  // By symbol and alternative
 
 private:
     // Core state
@@ -177,44 +288,117 @@ private:
     StoringMode mode_;                  // Storage mode
 
     // Metadata (always present, contains index + statistics)
-    Metadata metadata_;
+    Metadata metadata_{};              // Value-initialized: source statistics stay 0 without sources
+
+    // Succinct replacement of the metadata arrays (after compress_metadata())
+    struct SuccinctMetadata {
+        succinct::EliasFano base_positions;          // n entries
+        succinct::PackedVector symbol_byte_lengths;  // n entries
+        succinct::EliasFano cum_set_sizes;           // n+1 entries (last = m)
+        succinct::PackedVector string_lengths;       // m entries
+        succinct::EliasFano cum_common_positions;    // n+1 entries
+        succinct::EliasFano cum_degenerate_counts;   // n+1 entries
+        succinct::BitVector is_degenerate;           // n bits
+    };
+    std::unique_ptr<SuccinctMetadata> succinct_;
 
     // String data (only if mode_ == FULL)
-    std::vector<StringSet> sets_;       // The actual EDS data
+    String arena_;                          // All strings concatenated in string-ID order
+    std::vector<Position> string_offsets_;  // Start of each string in arena_ (m+1 entries)
 
     // File streaming (only if mode_ == METADATA_ONLY)
     std::filesystem::path file_path_;
-    mutable std::ifstream stream_;      // Mutable to allow reading in const methods
+    RandomAccessFile file_;             // One pread per symbol, no shared seek position
+    MappedFile mapping_;                // Backing store of symbol views (text files, no cache)
+    std::unique_ptr<BlockCache> cache_;  // Decoded symbol blocks (if loaded with a cache budget)
+
+    // Packed payload (only for .edz input in METADATA_ONLY mode)
+    bool packed_ = false;
+    std::streamoff payload_offset_ = 0;  // File offset of the 2-bit payload
+    edz::EscapeRuns escapes_;            // Non-ACGT runs of the payload
 
     // Optional source support
     bool has_sources_;                           // Whether sources are loaded
-    std::vector<std::set<int>> sources_;         // Path IDs per string (indexed by string ID)
+    SourceTable sources_;                        // Path set per string (indexed by string ID)
+    std::unique_ptr<SourceIndex> source_index_;  // Replaces sources_ when they are read on demand
 
     // Helper methods
     void parse(std::istream& is);
+    void parse_buffer(const char* data, size_t size, size_t threads = 1);  // Chunked tokenizer (full and compact format)
     void parse_sources(std::istream& is);
-    void calculate_statistics();
+    void parse_sources_buffer(const char* data, size_t size);
+    void assign_sources(SourceTable sources);  // Validate against m and compute source statistics
+    void parse_edz(const char* data, size_t size);     // Binary container (.edz)
+    void parse_file(const std::filesystem::path& path, size_t threads = 1);  // Mapped parse, or sidecar index in METADATA_ONLY
+    bool load_index(const std::filesystem::path& index_path, const eds_index::FileStamp& stamp);
+    void save_index(const std::filesystem::path& index_path, const eds_index::FileStamp& stamp) const;
+    void save_binary(std::ostream& os) const;
+    void calculate_statistics(size_t threads = 1);
     void calculate_source_statistics();
-    std::string normalize_eds_format(const std::string& input) const;
+    void assign_source_index(std::unique_ptr<SourceIndex> index);  // Lazy counterpart of assign_sources
+
+    // Source set of a string, loaded or decoded on demand (`hold` keeps a decoded block alive)
+    const SourceSet& source_at(size_t string_id, std::shared_ptr<const SourceBlock>& hold) const {
+        return source_index_ ? source_index_->get(string_id, hold) : sources_[string_id];
+    }
+    const SourceTable& source_numbering() const { return source_index_ ? source_index_->numbering() : sources_; }
+
+    // Metadata access that works with plain and succinct metadata
+    size_t first_string_of(Position pos) const {
+        return succinct_ ? static_cast<size_t>(succinct_->cum_set_sizes[pos]) : metadata_.cum_set_sizes[pos];
+    }
+    bool degenerate_at(Position pos) const {
+        return succinct_ ? succinct_->is_degenerate[pos] : metadata_.is_degenerate[pos];
+    }
+
+    // Arena access (FULL mode, no checks)
+    std::string_view string_at(size_t string_id) const {
+        return std::string_view(arena_.data() + string_offsets_[string_id],
+                                string_offsets_[string_id + 1] - string_offsets_[string_id]);
+    }
 
     // Streaming helpers
     StringSet read_symbol_from_stream(Position pos) const;
+    StringSet read_symbol_from_payload(Position pos) const;
+    String read_payload_chars(Position first_char, size_t count) const;  // Unpacked .edz payload range
+    std::shared_ptr<const SymbolBlock> load_block(size_t block_id) const;  // One read per cache block
+
+    // State carried from one position check to the next (one per thread)
+    struct CheckContext {
+        std::vector<size_t> path_strings;   // String IDs walked by the last intersection
+        std::vector<SourceSet> path_prefix;  // Intersection after each of them
+        size_t window_first = 0;            // Oldest symbol in the window
+        size_t window_count = 0;
+        std::vector<SymbolView> window;     // METADATA_ONLY: views of the last symbols walked (ring)
+        std::vector<size_t> choices;        // Local index of each degenerate choice, once validated
+    };
+    static constexpr size_t CHECK_WINDOW_SYMBOLS = 64;
 
     // Position checking helpers
     std::pair<size_t, size_t> decode_degenerate_string_number(int abs_string_num) const;
     size_t find_symbol_at_common_position(Position common_pos, Position& offset_out) const;
-    String reconstruct_from_memory(size_t start_symbol,
-                                   Position offset_in_symbol,
-                                   const std::vector<int>& degenerate_strings,
-                                   Length pattern_length) const;
-    String reconstruct_from_file(size_t start_symbol,
-                                 Position offset_in_symbol,
-                                 const std::vector<int>& degenerate_strings,
-                                 Length pattern_length) const;
-    std::set<int> calculate_path_intersection(size_t start_symbol,
-                                              Position offset_in_symbol,
-                                              const std::vector<int>& degenerate_strings,
-                                              Length pattern_length) const;
+    bool check_resolved(size_t start_symbol,
+                        Position offset_in_symbol,
+                        const std::vector<int>& degenerate_strings,
+                        const String& pattern,
+                        CheckContext& context,
+                        bool warn_extra) const;
+    const SymbolView& window_view(size_t symbol_idx, CheckContext& context) const;
+    bool validate_choices(size_t start_symbol,
+                          Position offset_in_symbol,
+                          const std::vector<int>& degenerate_strings,
+                          Length pattern_length,
+                          CheckContext& context) const;
+    bool match_in_place(size_t start_symbol,
+                        Position offset_in_symbol,
+                        std::string_view pattern,
+                        CheckContext& context,
+                        size_t& degenerate_used) const;
+    bool has_path_intersection(size_t start_symbol,
+                               Position offset_in_symbol,
+                               const std::vector<int>& degenerate_strings,
+                               Length pattern_length,
+                               CheckContext& context) const;
 };
 
 } // namespace edsparser
@@ -0,0 +1,64 @@
+#include "eds_index.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace edsparser {
+namespace eds_index {
+
+namespace {
+    constexpr size_t SAMPLE_BYTES = 4096;
+
+    uint64_t fnv1a(const char* data, size_t size, uint64_t hash) {
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+std::filesystem::path sidecar_path(const std::filesystem::path& eds_path) {
+    std::filesystem::path path = eds_path;
+    path += EXT_IDX;
+    return path;
+}
+
+FileStamp stamp_file(const std::filesystem::path& path) {
+    std::error_code ec;
+    FileStamp stamp{};
+    stamp.size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        throw std::runtime_error("Failed to stat file: " + path.string());
+    }
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        throw std::runtime_error("Failed to stat file: " + path.string());
+    }
+    stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+
+    // Sample the head and tail so that same-size rewrites within one mtime tick are caught
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        throw std::runtime_error("Failed to open file: " + path.string());
+    }
+    std::vector<char> buffer(SAMPLE_BYTES);
+    uint64_t hash = 14695981039346656037ULL;
+
+    ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    hash = fnv1a(buffer.data(), static_cast<size_t>(ifs.gcount()), hash);
+
+    if (stamp.size > SAMPLE_BYTES) {
+        ifs.clear();
+        ifs.seekg(static_cast<std::streamoff>(stamp.size - std::min<uint64_t>(stamp.size - SAMPLE_BYTES, SAMPLE_BYTES)));
+        ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hash = fnv1a(buffer.data(), static_cast<size_t>(ifs.gcount()), hash);
+    }
+    stamp.checksum = hash;
+
+    return stamp;
+}
+
+} // namespace eds_index
+} // namespace edsparser
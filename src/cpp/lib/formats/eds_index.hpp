@@ -0,0 +1,74 @@
+#ifndef EDSPARSER_FORMATS_EDS_INDEX_HPP
+#define EDSPARSER_FORMATS_EDS_INDEX_HPP
+
+#include "../common.hpp"
+#include <cstdint>
+#include <filesystem>
+
+namespace edsparser {
+namespace eds_index {
+
+/**
+ * Sidecar metadata index (<file>.idx)
+ *
+ * Caches the EDS::Metadata arrays of a text EDS file so that METADATA_ONLY
+ * loads can skip tokenizing it. Written next to the file on the first
+ * METADATA_ONLY load (best effort) or explicitly by edsparser-index.
+ *
+ * Layout (host byte order, every section padded to 8 bytes):
+ *   Header                 see below
+ *   base_positions         n x uint64
+ *   symbol_byte_lengths    n x uint32
+ *   symbol_sizes           n x uint32
+ *   string_lengths         m x uint32
+ *   cum_set_sizes          n x uint32
+ *   cum_common_positions   (n+1) x uint64
+ *   cum_degenerate_counts  (n+1) x int32
+ *
+ * An index is only used while the size, modification time and sampled
+ * checksum recorded in its header still match the indexed file.
+ */
+
+constexpr char MAGIC[4] = {'E', 'D', 'I', '\x1a'};
+constexpr uint32_t VERSION = 2;
+
+// Identity of an indexed file at indexing time
+struct FileStamp {
+    uint64_t size;
+    int64_t mtime;       // Ticks of std::filesystem::file_time_type
+    uint64_t checksum;   // FNV-1a over the first and last 4 KiB
+
+    bool operator==(const FileStamp& other) const {
+        return size == other.size && mtime == other.mtime && checksum == other.checksum;
+    }
+};
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    FileStamp stamp;
+    uint64_t n;
+    uint64_t m;
+    uint64_t N;
+
+    // Statistics
+    uint32_t min_context_length;
+    uint32_t max_context_length;
+    double avg_context_length;
+    uint64_t num_degenerate_symbols;
+    uint64_t num_common_chars;
+    uint64_t total_change_size;
+    uint64_t num_empty_strings;
+};
+static_assert(sizeof(Header) % 8 == 0, "Index header must keep sections aligned");
+
+// Sidecar path for an EDS file: "<file>.idx"
+std::filesystem::path sidecar_path(const std::filesystem::path& eds_path);
+
+// Current identity of a file. Throws std::runtime_error if it cannot be read.
+FileStamp stamp_file(const std::filesystem::path& path);
+
+} // namespace eds_index
+} // namespace edsparser
+
+#endif // EDSPARSER_FORMATS_EDS_INDEX_HPP
@@ -0,0 +1,190 @@
+#include "eds_stream.hpp"
+#include "delimiter_scanner.hpp"
+#include "edz.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace edsparser {
+
+namespace {
+    // ASCII whitespace, same set as the EDS tokenizer
+    inline bool is_space(char ch) {
+        return ch == ' ' || (ch >= '\t' && ch <= '\r');
+    }
+}
+
+void EDSStreamParser::feed(const char* data, size_t size) {
+    if (finished_) {
+        throw std::runtime_error("EDS stream: feed() after finish()");
+    }
+
+    // Pull mode: the queue starts over once every queued symbol has been taken
+    if (queue_next_ == queue_.size()) {
+        queue_.clear();
+        queue_chars_.clear();
+        queue_lengths_.clear();
+        queue_next_ = 0;
+    }
+
+    // .edz is a random-access container, it cannot be parsed on the fly
+    for (size_t i = 0; edz_prefix_ && i < size && offset_ + i < sizeof(edz::MAGIC); i++) {
+        edz_prefix_ = (data[i] == edz::MAGIC[offset_ + i]);
+        if (edz_prefix_ && offset_ + i + 1 == sizeof(edz::MAGIC)) {
+            throw std::runtime_error("EDS stream: Binary .edz input cannot be streamed");
+        }
+    }
+
+    const char* const begin = data;
+    const char* const end = data + size;
+    const char* p = begin;
+    DelimiterScanner scanner(begin, end);
+    auto stream_offset = [&](const char* at) { return offset_ + static_cast<Position>(at - begin); };
+
+    while (p < end) {
+        if (!in_symbol_) {
+            // Skip whitespace between symbols
+            if (is_space(*p)) {
+                p++;
+                continue;
+            }
+
+            // A bracketed set ends at '}'; a compact run ends before the next '{' or at EOF
+            symbol_start_ = stream_offset(p);
+            chars_.clear();
+            lengths_.clear();
+            string_begin_ = 0;
+            bracketed_ = (*p == SET_OPEN);
+            if (bracketed_) {
+                p++; // Skip '{'
+            } else if (*p == SET_CLOSE) {
+                throw std::runtime_error("Expected '{' at position " + std::to_string(symbol_start_));
+            }
+            in_symbol_ = true;
+            continue;
+        }
+
+        // Characters up to the next delimiter belong to the current string
+        const char* delimiter = scanner.next(p);
+        chars_.append(p, delimiter);
+        p = delimiter;
+        if (p == end) {
+            break;
+        }
+
+        char ch = *p;
+        if (is_space(ch)) {
+            // Line-wrapped or padded input: whitespace is not part of the string
+            p++;
+        } else if (ch == SET_SEPARATOR) {
+            end_string();
+            p++;
+        } else if (ch == SET_CLOSE) {
+            if (!bracketed_) {
+                throw std::runtime_error("Expected '{' at position " + std::to_string(stream_offset(p)));
+            }
+            p++; // Skip '}'
+            end_string();
+            emit(stream_offset(p));
+        } else {
+            // '{' inside a set is an error; it ends a compact run and starts the next symbol
+            if (bracketed_) {
+                throw std::runtime_error("Expected '}' at position " + std::to_string(stream_offset(p)));
+            }
+            end_string();
+            emit(stream_offset(p));
+        }
+    }
+
+    offset_ += size;
+    track_buffers();
+}
+
+void EDSStreamParser::finish() {
+    if (finished_) {
+        return;
+    }
+    if (in_symbol_) {
+        if (bracketed_) {
+            throw std::runtime_error("Expected '}' at position " + std::to_string(offset_));
+        }
+        end_string();
+        emit(offset_);
+        track_buffers();
+    }
+    finished_ = true;
+}
+
+bool EDSStreamParser::next(StreamedSymbol& symbol) {
+    if (queue_next_ == queue_.size()) {
+        return false;
+    }
+    const QueuedSymbol& queued = queue_[queue_next_++];
+    symbol.index = queued.index;
+    symbol.byte_offset = queued.byte_offset;
+    symbol.byte_length = queued.byte_length;
+    symbol.strings = SymbolView(queue_chars_.data() + queued.chars_begin,
+                                queue_lengths_.data() + queued.lengths_begin, queued.count, 0);
+    return true;
+}
+
+EDS::Statistics EDSStreamParser::get_statistics() const {
+    EDS::Statistics stats = stats_;
+    if (stats.min_context_length == UINT32_MAX) {
+        stats.min_context_length = 0;  // No context blocks
+    }
+    stats.avg_context_length = num_context_blocks_ > 0
+        ? static_cast<double>(stats.num_common_chars) / num_context_blocks_
+        : 0.0;
+    return stats;
+}
+
+void EDSStreamParser::end_string() {
+    lengths_.push_back(static_cast<Length>(chars_.size() - string_begin_));
+    string_begin_ = chars_.size();
+}
+
+void EDSStreamParser::emit(Position end_offset) {
+    size_t symbol_size = lengths_.size();
+
+    // Same definitions as EDS::calculate_statistics
+    if (symbol_size > 1) {
+        stats_.num_degenerate_symbols++;
+        stats_.total_change_size += symbol_size - 1;
+    } else {
+        Length context_len = lengths_[0];
+        stats_.min_context_length = std::min(stats_.min_context_length, context_len);
+        stats_.max_context_length = std::max(stats_.max_context_length, context_len);
+        stats_.num_common_chars += context_len;
+        num_context_blocks_++;
+    }
+    stats_.num_empty_strings += std::count(lengths_.begin(), lengths_.end(), Length(0));
+
+    StreamedSymbol symbol;
+    symbol.index = n_;
+    symbol.byte_offset = symbol_start_;
+    symbol.byte_length = static_cast<Length>(end_offset - symbol_start_);
+
+    n_++;
+    m_ += symbol_size;
+    N_ += chars_.size();
+    in_symbol_ = false;
+
+    if (on_symbol_) {
+        symbol.strings = SymbolView(chars_.data(), lengths_.data(), symbol_size, 0);
+        on_symbol_(symbol);
+    } else {
+        queue_.push_back({symbol.index, symbol.byte_offset, symbol.byte_length,
+                          queue_chars_.size(), queue_lengths_.size(), symbol_size});
+        queue_chars_ += chars_;
+        queue_lengths_.insert(queue_lengths_.end(), lengths_.begin(), lengths_.end());
+    }
+}
+
+void EDSStreamParser::track_buffers() {
+    size_t bytes = chars_.capacity() + lengths_.capacity() * sizeof(Length) +
+                   queue_chars_.capacity() + queue_lengths_.capacity() * sizeof(Length) +
+                   queue_.capacity() * sizeof(QueuedSymbol);
+    peak_buffer_bytes_ = std::max(peak_buffer_bytes_, bytes);
+}
+
+} // namespace edsparser
@@ -0,0 +1,112 @@
+#ifndef EDSPARSER_FORMATS_EDS_STREAM_HPP
+#define EDSPARSER_FORMATS_EDS_STREAM_HPP
+
+#include "../common.hpp"
+#include "eds.hpp"
+#include "symbol_view.hpp"
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace edsparser {
+
+// One complete symbol reported by EDSStreamParser
+struct StreamedSymbol {
+    Position index;         // Symbol number in the stream
+    Position byte_offset;   // Stream offset of the symbol's first byte (as EDS::get_base_position)
+    Length byte_length;     // Bytes spanned by the symbol (as EDS::get_symbol_byte_length)
+    SymbolView strings;     // Alternatives, valid until the parser is fed again (push: until the callback returns)
+};
+
+/**
+ * Incremental parser for text EDS arriving in chunks (pipes, sockets, stdin)
+ *
+ * The caller pushes byte chunks of any size with feed() and calls finish()
+ * at the end of the input. Every symbol is reported as soon as its last byte
+ * has been seen; bracketed sets and compact runs may span any number of
+ * chunks. Only the symbol under construction is buffered, so memory is bounded
+ * by the largest symbol, not by the stream.
+ *
+ * Symbols are delivered either
+ * - push: to the callback given to the constructor, from inside feed()/finish()
+ * - pull: without a callback, completed symbols queue up and are taken with
+ *   next() (the queue holds at most the symbols completed by one feed())
+ *
+ * Input, offsets and error messages are those of EDS::load: full and compact
+ * format, whitespace ignored, std::runtime_error on malformed input. Binary
+ * .edz input cannot be streamed and is rejected.
+ *
+ * Structure counters and the statistics of EDS::get_statistics() are kept
+ * on the fly (source statistics stay zero).
+ */
+class EDSStreamParser {
+public:
+    using SymbolCallback = std::function<void(const StreamedSymbol&)>;
+
+    EDSStreamParser() = default;                                        // Pull mode
+    explicit EDSStreamParser(SymbolCallback on_symbol) : on_symbol_(std::move(on_symbol)) {}  // Push mode
+
+    void feed(const char* data, size_t size);
+    void feed(std::string_view chunk) { feed(chunk.data(), chunk.size()); }
+    void finish();  // End of input: completes a trailing compact run, throws on an open set
+
+    // Pull mode: next completed symbol, false when none is queued
+    bool next(StreamedSymbol& symbol);
+
+    bool finished() const { return finished_; }
+    Position bytes() const { return offset_; }         // Bytes fed so far
+    Position length() const { return n_; }            // Symbols completed (n)
+    Position cardinality() const { return m_; }       // Strings completed (m)
+    Position size() const { return N_; }              // Characters completed (N)
+    EDS::Statistics get_statistics() const;
+
+    // Largest buffer capacity used so far (current symbol + pull queue), in bytes
+    size_t peak_buffer_bytes() const { return peak_buffer_bytes_; }
+
+private:
+    // Pull queue entry: symbol metadata plus its range in queue_chars_ / queue_lengths_
+    struct QueuedSymbol {
+        Position index;
+        Position byte_offset;
+        Length byte_length;
+        size_t chars_begin;
+        size_t lengths_begin;
+        size_t count;
+    };
+
+    void end_string();
+    void emit(Position end_offset);
+    void track_buffers();
+
+    SymbolCallback on_symbol_;
+    bool finished_ = false;
+    Position offset_ = 0;   // Stream offset of the next byte fed
+    bool edz_prefix_ = true; // Bytes seen so far match the .edz magic
+
+    // Symbol under construction
+    bool in_symbol_ = false;
+    bool bracketed_ = false;
+    Position symbol_start_ = 0;
+    String chars_;
+    std::vector<Length> lengths_;
+    size_t string_begin_ = 0;  // Start of the current string in chars_
+
+    // Pull queue
+    std::vector<QueuedSymbol> queue_;
+    String queue_chars_;
+    std::vector<Length> queue_lengths_;
+    size_t queue_next_ = 0;
+
+    // Counters and running statistics
+    Position n_ = 0;
+    Position m_ = 0;
+    Position N_ = 0;
+    EDS::Statistics stats_{UINT32_MAX, 0, 0.0, 0, 0, 0, 0, 0, 0, 0.0};
+    size_t num_context_blocks_ = 0;
+    size_t peak_buffer_bytes_ = 0;
+};
+
+} // namespace edsparser
+
+#endif // EDSPARSER_FORMATS_EDS_STREAM_HPP
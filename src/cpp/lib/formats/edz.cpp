@@ -0,0 +1,108 @@
+#include "edz.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace edsparser {
+namespace edz {
+
+namespace {
+    constexpr char BASES[4] = {'A', 'C', 'G', 'T'};
+
+    // 2-bit code per byte, -1 for characters that need an escape
+    constexpr std::array<int8_t, 256> make_codes() {
+        std::array<int8_t, 256> codes{};
+        for (auto& c : codes) {
+            c = -1;
+        }
+        codes['A'] = 0;
+        codes['C'] = 1;
+        codes['G'] = 2;
+        codes['T'] = 3;
+        return codes;
+    }
+    constexpr std::array<int8_t, 256> CODES = make_codes();
+
+    // Four decoded characters per packed byte (lowest bits first)
+    struct DecodeTable {
+        char chars[256][4];
+        DecodeTable() {
+            for (int b = 0; b < 256; b++) {
+                for (int k = 0; k < 4; k++) {
+                    chars[b][k] = BASES[(b >> (2 * k)) & 3];
+                }
+            }
+        }
+    };
+    const DecodeTable DECODE;
+}
+
+bool is_edz(const char* data, size_t size) {
+    return size >= sizeof(Header) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void EscapeRuns::apply(Position first, size_t count, char* out) const {
+    Position last = first + count;
+
+    // First run that ends after `first`
+    auto it = std::upper_bound(starts.begin(), starts.end(), first);
+    size_t r = static_cast<size_t>(it - starts.begin());
+    if (r > 0 && starts[r - 1] + lengths[r - 1] > first) {
+        r--;
+    }
+
+    for (; r < starts.size() && starts[r] < last; r++) {
+        Position from = std::max(starts[r], first);
+        Position to = std::min(starts[r] + lengths[r], last);
+        std::memset(out + (from - first), chars[r], static_cast<size_t>(to - from));
+    }
+}
+
+void PayloadPacker::append(std::string_view chars) {
+    bytes_.resize(payload_bytes(count_ + chars.size()), '\0');
+
+    for (char ch : chars) {
+        int8_t code = CODES[static_cast<unsigned char>(ch)];
+        if (code < 0) {
+            // Extend the previous run if it is the same character and adjacent
+            size_t e = escapes_.size();
+            if (e > 0 && escapes_.chars[e - 1] == ch &&
+                escapes_.starts[e - 1] + escapes_.lengths[e - 1] == count_) {
+                escapes_.lengths[e - 1]++;
+            } else {
+                escapes_.starts.push_back(count_);
+                escapes_.lengths.push_back(1);
+                escapes_.chars.push_back(ch);
+            }
+            code = 0;
+        }
+        bytes_[count_ / 4] |= static_cast<char>(code << (2 * (count_ % 4)));
+        count_++;
+    }
+}
+
+void unpack(const uint8_t* bytes, unsigned skip, size_t count, char* out) {
+    // Leading codes of a partially used byte
+    while (skip != 0 && count > 0) {
+        *out++ = BASES[(*bytes >> (2 * skip)) & 3];
+        count--;
+        if (++skip == 4) {
+            skip = 0;
+            bytes++;
+        }
+    }
+
+    // Whole bytes
+    for (; count >= 4; count -= 4) {
+        std::memcpy(out, DECODE.chars[*bytes++], 4);
+        out += 4;
+    }
+
+    // Trailing codes
+    for (unsigned k = 0; k < count; k++) {
+        *out++ = BASES[(*bytes >> (2 * k)) & 3];
+    }
+}
+
+} // namespace edz
+} // namespace edsparser
@@ -0,0 +1,98 @@
+#ifndef EDSPARSER_FORMATS_EDZ_HPP
+#define EDSPARSER_FORMATS_EDZ_HPP
+
+#include "../common.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace edsparser {
+namespace edz {
+
+/**
+ * Binary EDS container (.edz)
+ *
+ * Layout (all integers in host byte order, every section padded to 8 bytes):
+ *   Header          64 bytes, see below
+ *   symbol_sizes    n x uint32
+ *   string_lengths  m x uint32
+ *   escape runs     e x uint64 start, e x uint32 length, e x uint8 character
+ *   sources         m x uint32 count, then the path IDs as int32 (FLAG_SOURCES only)
+ *   payload         ceil(N / 4) bytes, 2 bits per character (A=0, C=1, G=2, T=3)
+ *
+ * Characters of all strings are concatenated in string-ID order before packing.
+ * Anything other than uppercase ACGT is stored as 0 in the payload and restored
+ * from the escape runs (maximal runs of one repeated character), so N blocks and
+ * IUPAC codes cost one run each. The payload is last so that metadata can be read
+ * without touching it.
+ */
+
+constexpr char MAGIC[4] = {'E', 'D', 'Z', '\x1a'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t FLAG_SOURCES = 1u << 0;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t n;                  // Number of symbols
+    uint64_t m;                  // Number of strings
+    uint64_t N;                  // Number of characters
+    uint64_t num_escape_runs;
+    uint64_t num_source_ids;     // Total path IDs over all strings
+    uint64_t reserved2;
+};
+static_assert(sizeof(Header) == 64, "EDZ header must be 64 bytes");
+
+// Whether the buffer starts with the .edz magic
+bool is_edz(const char* data, size_t size);
+
+// Round a section size up to the 8-byte alignment used by the container
+inline size_t padded(size_t bytes) { return (bytes + 7) & ~size_t(7); }
+
+// Byte size of a payload holding count characters
+inline size_t payload_bytes(Position count) { return static_cast<size_t>((count + 3) / 4); }
+
+/**
+ * Runs of non-ACGT characters, sorted by start position
+ */
+struct EscapeRuns {
+    std::vector<Position> starts;
+    std::vector<Length> lengths;
+    std::string chars;
+
+    size_t size() const { return starts.size(); }
+
+    // Overwrite out[0..count) (characters first..first+count) with escaped characters
+    void apply(Position first, size_t count, char* out) const;
+};
+
+/**
+ * Incremental 2-bit packer
+ */
+class PayloadPacker {
+public:
+    void reserve(Position count) { bytes_.reserve(payload_bytes(count)); }
+    void append(std::string_view chars);
+
+    const std::string& bytes() const { return bytes_; }
+    const EscapeRuns& escapes() const { return escapes_; }
+    Position count() const { return count_; }
+
+private:
+    std::string bytes_;
+    EscapeRuns escapes_;
+    Position count_ = 0;
+};
+
+// Decode count characters starting at 2-bit code `skip` (0..3) of bytes[0].
+// Escaped positions come out as 'A'; EscapeRuns::apply restores them.
+void unpack(const uint8_t* bytes, unsigned skip, size_t count, char* out);
+
+} // namespace edz
+} // namespace edsparser
+
+#endif // EDSPARSER_FORMATS_EDZ_HPP
@@ -0,0 +1,525 @@
+#include "seds.hpp"
+#include "delimiter_scanner.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace edsparser {
+namespace seds {
+
+namespace {
+    // ASCII whitespace, same set as the EDS tokenizer
+    inline bool is_space(char ch) {
+        return ch == ' ' || (ch >= '\t' && ch <= '\r');
+    }
+
+    void put_varint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    uint64_t get_varint(const uint8_t*& p, const uint8_t* end) {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (p == end) {
+                throw std::runtime_error("sEDS: Truncated binary input");
+            }
+            uint8_t byte = *p++;
+            value |= uint64_t(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("sEDS: Invalid varint in binary input");
+    }
+
+    // Maximal runs of consecutive path IDs of one set, as (first, last)
+    template <typename F>
+    void for_each_run(const SourceTable& sources, const SourceSet& set, F f) {
+        bool open = false;
+        int first = 0;
+        int last = 0;
+        sources.for_each_path(set, [&](int path_id) {
+            if (open && path_id == last + 1) {
+                last = path_id;
+                return;
+            }
+            if (open) {
+                f(first, last);
+            }
+            first = last = path_id;
+            open = true;
+        });
+        if (open) {
+            f(first, last);
+        }
+    }
+
+    /*
+     * Set visitors: every set's path IDs (as written) are appended to `ids`, then
+     * on_set(offset, set_begin) is called with the offset of the set's encoding
+     * in the buffer and the start of the set in `ids`. The caller decides whether
+     * `ids` keeps growing (parse) or is cleared per set (scan).
+     */
+
+    // Text sEDS (plain and with ranges): {path_ids}{path_ids}...
+    // One source set per string, ordered by string ID (total = cardinality m)
+    // (`base_offset` and `first_string` only shift the positions in error messages)
+    template <typename OnSet>
+    size_t visit_text(const char* data, size_t size, std::vector<int32_t>& ids, OnSet on_set,
+                      size_t base_offset = 0, size_t first_string = 0) {
+        const char* const begin = data;
+        const char* const end = data + size;
+        const char* p = begin;
+        DelimiterScanner scanner(begin, end);
+        auto position = [&](const char* at) { return std::to_string(base_offset + (at - begin)); };
+
+        auto skip_whitespace = [&]() {
+            while (p < end && is_space(*p)) {
+                p++;
+            }
+        };
+
+        size_t string_count = 0;
+
+        while (true) {
+            skip_whitespace();
+            if (p == end) {
+                break;
+            }
+
+            // Expect '{'
+            if (*p != SET_OPEN) {
+                throw std::runtime_error("sEDS: Expected '{' at position " + position(p));
+            }
+            size_t set_offset = static_cast<size_t>(p - begin);
+            p++; // Skip '{'
+
+            // Parse path IDs for this string
+            size_t set_begin = ids.size();
+
+            while (true) {
+                skip_whitespace();
+
+                if (p < end && std::isdigit(static_cast<unsigned char>(*p))) {
+                    // Number or first-last range, up to the next delimiter
+                    const char* token_end = scanner.next(p);
+                    int first = 0;
+                    auto [ptr, ec] = std::from_chars(p, token_end, first);
+                    int last = first;
+                    if (ec == std::errc() && ptr + 1 < token_end && *ptr == '-' &&
+                        std::isdigit(static_cast<unsigned char>(ptr[1]))) {
+                        auto [range_ptr, range_ec] = std::from_chars(ptr + 1, token_end, last);
+                        ptr = range_ptr;
+                        ec = range_ec;
+                    }
+                    if (ec != std::errc() || ptr != token_end) {
+                        throw std::runtime_error("sEDS: Invalid path ID '" + std::string(p, token_end) +
+                                               "' at position " + position(p));
+                    }
+                    if (last < first) {
+                        throw std::runtime_error("sEDS: Invalid range '" + std::string(p, token_end) +
+                                               "' at position " + position(p));
+                    }
+                    for (int64_t id = first; id <= last; id++) {
+                        ids.push_back(static_cast<int32_t>(id));
+                    }
+                    p = token_end;
+                    skip_whitespace();
+                }
+
+                if (p >= end) {
+                    throw std::runtime_error("sEDS: Expected '}' at position " + position(p));
+                }
+                if (*p == SET_SEPARATOR) {
+                    p++;
+                    continue;
+                }
+                if (*p == SET_CLOSE) {
+                    p++;
+                    break;
+                }
+                throw std::runtime_error("sEDS: Invalid character '" + std::string(1, *p) +
+                                       "' at position " + position(p));
+            }
+
+            // Validate path set is not empty (unless it's an error case we want to catch)
+            if (ids.size() == set_begin) {
+                throw std::runtime_error("sEDS: Empty path set at string " +
+                                       std::to_string(first_string + string_count));
+            }
+
+            on_set(set_offset, set_begin);
+            string_count++;
+        }
+
+        return string_count;
+    }
+
+    // Binary runs of consecutive sets in [data, end), up to max_sets sets or the end of the
+    // data; `data` is left after the last visited set
+    template <typename OnSet>
+    size_t visit_binary(const char*& data, const char* data_end, uint64_t max_sets, uint64_t max_ids,
+                        std::vector<int32_t>& ids, OnSet on_set) {
+        const uint8_t* const begin = reinterpret_cast<const uint8_t*>(data);
+        const uint8_t* const end = reinterpret_cast<const uint8_t*>(data_end);
+        const uint8_t* p = begin;
+        uint64_t total_ids = 0;
+
+        uint64_t s = 0;
+        for (; s < max_sets && p < end; s++) {
+            size_t set_offset = static_cast<size_t>(p - begin);
+            uint64_t runs = get_varint(p, end);
+            if (runs == 0) {
+                throw std::runtime_error("sEDS: Empty path set at string " + std::to_string(s));
+            }
+            size_t set_begin = ids.size();
+            uint64_t next = 0;  // End of the previous run
+            for (uint64_t r = 0; r < runs; r++) {
+                uint64_t gap = get_varint(p, end);
+                uint64_t length = get_varint(p, end) + 1;
+                uint64_t first = next + std::min<uint64_t>(gap, uint64_t(INT32_MAX) + 1);
+                if (first > uint64_t(INT32_MAX) || length == 0 || length > uint64_t(INT32_MAX) - first + 1 ||
+                    total_ids + length > max_ids) {
+                    throw std::runtime_error("sEDS: Invalid run in binary input at string " + std::to_string(s));
+                }
+                for (uint64_t id = first; id < first + length; id++) {
+                    ids.push_back(static_cast<int32_t>(id));
+                }
+                total_ids += length;
+                next = first + length;
+            }
+            on_set(set_offset, set_begin);
+        }
+        data = reinterpret_cast<const char*>(p);
+        return static_cast<size_t>(s);
+    }
+
+    // Header of a binary sEDS buffer (validated against the buffer size)
+    Header read_header(const char* data, size_t size) {
+        Header header;
+        std::memcpy(&header, data, sizeof(Header));
+        if (header.version != VERSION) {
+            throw std::runtime_error("sEDS: Unsupported binary version " + std::to_string(header.version));
+        }
+        if (header.payload_bytes != size - sizeof(Header)) {
+            throw std::runtime_error("sEDS: Binary payload size does not match the file");
+        }
+        if (header.num_sets == 0) {
+            throw std::runtime_error("sEDS input is empty");
+        }
+        return header;
+    }
+
+    // Visit every set of a complete buffer (any encoding); offsets are relative to data
+    template <typename OnSet>
+    void visit_all(const char* data, size_t size, std::vector<int32_t>& ids, OnSet on_set) {
+        if (!is_binary(data, size)) {
+            if (visit_text(data, size, ids, on_set) == 0) {
+                throw std::runtime_error("sEDS input is empty");
+            }
+            return;
+        }
+
+        Header header = read_header(data, size);
+        const char* payload = data + sizeof(Header);
+        uint64_t visited_ids = 0;
+        size_t visited = visit_binary(payload, data + size, header.num_sets, header.num_ids, ids,
+            [&](size_t offset, size_t set_begin) {
+                visited_ids += ids.size() - set_begin;
+                on_set(sizeof(Header) + offset, set_begin);
+            });
+        if (visited != header.num_sets || visited_ids != header.num_ids || payload != data + size) {
+            throw std::runtime_error("sEDS: Binary input does not match its header");
+        }
+    }
+
+    void write_text(std::ostream& os, const SourceTable& sources, bool ranges) {
+        std::string out;
+        char digits[16];
+        auto put_id = [&](int path_id) {
+            auto [ptr, ec] = std::to_chars(digits, digits + sizeof(digits), path_id);
+            out.append(digits, ptr);
+        };
+
+        for (size_t i = 0; i < sources.size(); i++) {
+            out.push_back(SET_OPEN);
+            bool first_entry = true;
+            auto separate = [&]() {
+                if (!first_entry) out.push_back(SET_SEPARATOR);
+                first_entry = false;
+            };
+            if (ranges) {
+                // Runs of 3+ IDs as first-last; a pair is no longer as "a,b"
+                for_each_run(sources, sources[i], [&](int first, int last) {
+                    separate();
+                    put_id(first);
+                    if (last - first >= 2) {
+                        out.push_back('-');
+                        put_id(last);
+                    } else if (last != first) {
+                        out.push_back(SET_SEPARATOR);
+                        put_id(last);
+                    }
+                });
+            } else {
+                sources.for_each_path(sources[i], [&](int path_id) {
+                    separate();
+                    put_id(path_id);
+                });
+            }
+            out.push_back(SET_CLOSE);
+
+            if (out.size() >= (1u << 16)) {
+                os.write(out.data(), static_cast<std::streamsize>(out.size()));
+                out.clear();
+            }
+        }
+        out.push_back('\n');
+        os.write(out.data(), static_cast<std::streamsize>(out.size()));
+    }
+
+    void write_binary(std::ostream& os, const SourceTable& sources) {
+        std::string payload;
+        uint64_t num_ids = 0;
+        std::vector<std::pair<int, int>> runs;
+        for (size_t i = 0; i < sources.size(); i++) {
+            runs.clear();
+            for_each_run(sources, sources[i], [&](int first, int last) { runs.emplace_back(first, last); });
+            put_varint(payload, runs.size());
+            uint64_t next = 0;
+            for (const auto& [first, last] : runs) {
+                put_varint(payload, static_cast<uint64_t>(first) - next);
+                put_varint(payload, static_cast<uint64_t>(last - first));
+                next = static_cast<uint64_t>(last) + 1;
+            }
+            num_ids += sources[i].size();
+        }
+
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.num_sets = sources.size();
+        header.num_ids = num_ids;
+        header.payload_bytes = payload.size();
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    }
+}
+
+bool is_binary(const char* data, size_t size) {
+    return size >= sizeof(Header) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+SourceTable parse(const char* data, size_t size) {
+    // Flattened path IDs of all strings, numbered densely by SourceTable at the end
+    std::vector<uint32_t> counts;
+    std::vector<int32_t> ids;
+    visit_all(data, size, ids, [&](size_t, size_t set_begin) {
+        counts.push_back(static_cast<uint32_t>(ids.size() - set_begin));
+    });
+    return SourceTable(counts, ids);
+}
+
+void scan(const char* data, size_t size, const SetVisitor& visit) {
+    std::vector<int32_t> ids;
+    visit_all(data, size, ids, [&](size_t offset, size_t) {
+        visit(offset, ids.data(), ids.size());
+        ids.clear();
+    });
+}
+
+void scan_slice(const char* data, size_t size, bool binary, const SetVisitor& visit) {
+    std::vector<int32_t> ids;
+    auto on_set = [&](size_t offset, size_t) {
+        visit(offset, ids.data(), ids.size());
+        ids.clear();
+    };
+    if (binary) {
+        const char* p = data;
+        visit_binary(p, data + size, UINT64_MAX, UINT64_MAX, ids, on_set);
+    } else {
+        visit_text(data, size, ids, on_set);
+    }
+}
+
+bool StreamReader::fill() {
+    if (eof_) {
+        return false;
+    }
+    // Drop the decoded prefix before growing the buffer
+    if (pos_ > 0) {
+        buffer_.erase(0, pos_);
+        consumed_ += pos_;
+        pos_ = 0;
+    }
+    size_t old_size = buffer_.size();
+    buffer_.resize(old_size + CHUNK_BYTES);
+    is_.read(&buffer_[old_size], static_cast<std::streamsize>(CHUNK_BYTES));
+    size_t got = static_cast<size_t>(is_.gcount());
+    buffer_.resize(old_size + got);
+    if (got == 0) {
+        eof_ = true;
+        return false;
+    }
+    return true;
+}
+
+void StreamReader::decode_text() {
+    // Complete sets end at the last '}' of the buffer
+    size_t last_close = buffer_.rfind(SET_CLOSE);
+    if (last_close == std::string::npos || last_close < pos_) {
+        return;
+    }
+    sets_decoded_ += visit_text(buffer_.data() + pos_, last_close + 1 - pos_, queue_ids_,
+                                [&](size_t, size_t set_begin) {
+                                    queue_counts_.push_back(static_cast<uint32_t>(queue_ids_.size() - set_begin));
+                                },
+                                consumed_ + pos_, sets_decoded_);
+    pos_ = last_close + 1;
+}
+
+void StreamReader::decode_binary() {
+    // Extent of the complete sets: varint run count, then two varints per run
+    const uint8_t* const begin = reinterpret_cast<const uint8_t*>(buffer_.data() + pos_);
+    const uint8_t* const end = reinterpret_cast<const uint8_t*>(buffer_.data() + buffer_.size());
+    const uint8_t* p = begin;
+    const uint8_t* complete = begin;
+    auto skip_varint = [&](uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; p < end; shift += 7) {
+            uint8_t byte = *p++;
+            if (shift < 64) {
+                value |= uint64_t(byte & 0x7f) << shift;
+            }
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+    uint64_t remaining = header_.num_sets - sets_decoded_;
+    for (uint64_t s = 0; s < remaining; s++) {
+        uint64_t runs = 0;
+        uint64_t value = 0;
+        bool whole = skip_varint(runs);
+        for (uint64_t r = 0; whole && r < 2 * runs; r++) {
+            whole = skip_varint(value);
+        }
+        if (!whole) {
+            break;
+        }
+        complete = p;
+    }
+    if (complete == begin) {
+        return;
+    }
+
+    const char* data = buffer_.data() + pos_;
+    size_t decoded = visit_binary(data, reinterpret_cast<const char*>(complete),
+                                  remaining, header_.num_ids - ids_read_, queue_ids_,
+                                  [&](size_t, size_t set_begin) {
+                                      uint32_t count = static_cast<uint32_t>(queue_ids_.size() - set_begin);
+                                      queue_counts_.push_back(count);
+                                      ids_read_ += count;
+                                  });
+    sets_decoded_ += decoded;
+    pos_ = static_cast<size_t>(data - buffer_.data());
+}
+
+bool StreamReader::next(std::vector<int32_t>& path_ids) {
+    if (!started_) {
+        // Binary input is recognized by its header
+        while (buffer_.size() < sizeof(Header) && fill()) {
+        }
+        started_ = true;
+        binary_ = is_binary(buffer_.data(), buffer_.size());
+        if (binary_) {
+            std::memcpy(&header_, buffer_.data(), sizeof(Header));
+            if (header_.version != VERSION) {
+                throw std::runtime_error("sEDS: Unsupported binary version " + std::to_string(header_.version));
+            }
+            if (header_.num_sets == 0) {
+                throw std::runtime_error("sEDS input is empty");
+            }
+            pos_ = sizeof(Header);
+        }
+    }
+
+    while (queue_set_ == queue_counts_.size()) {
+        queue_ids_.clear();
+        queue_counts_.clear();
+        queue_set_ = 0;
+        queue_pos_ = 0;
+
+        if (binary_) {
+            decode_binary();
+        } else {
+            decode_text();
+        }
+        if (!queue_counts_.empty()) {
+            break;
+        }
+        if (fill()) {
+            continue;
+        }
+
+        // End of the stream: anything left is malformed
+        if (binary_) {
+            uint64_t payload = consumed_ + pos_ - sizeof(Header);
+            if (sets_decoded_ != header_.num_sets || ids_read_ != header_.num_ids ||
+                pos_ != buffer_.size() || payload != header_.payload_bytes) {
+                throw std::runtime_error("sEDS: Binary input does not match its header");
+            }
+        } else {
+            size_t rest = pos_;
+            while (rest < buffer_.size() && is_space(buffer_[rest])) {
+                rest++;
+            }
+            if (rest < buffer_.size()) {
+                // Unterminated set: the parser reports it
+                visit_text(buffer_.data() + rest, buffer_.size() - rest, queue_ids_,
+                           [](size_t, size_t) {}, consumed_ + rest, sets_decoded_);
+            }
+            if (sets_read_ == 0) {
+                throw std::runtime_error("sEDS input is empty");
+            }
+        }
+        return false;
+    }
+
+    uint32_t count = queue_counts_[queue_set_++];
+    path_ids.assign(queue_ids_.begin() + queue_pos_, queue_ids_.begin() + queue_pos_ + count);
+    queue_pos_ += count;
+    sets_read_++;
+    return true;
+}
+
+void write(std::ostream& os, const SourceTable& sources, Format format) {
+    if (format == Format::BINARY) {
+        write_binary(os, sources);
+    } else {
+        write_text(os, sources, format == Format::RANGES);
+    }
+}
+
+Format format_for(const std::filesystem::path& path, Format fallback) {
+    return path.extension() == EXT_SEDZ ? Format::BINARY : fallback;
+}
+
+Format parse_format(const std::string& name) {
+    if (name == "text") return Format::TEXT;
+    if (name == "ranges") return Format::RANGES;
+    if (name == "binary") return Format::BINARY;
+    throw std::invalid_argument("Unknown sEDS format '" + name + "' (expected text, ranges or binary)");
+}
+
+} // namespace seds
+} // namespace edsparser
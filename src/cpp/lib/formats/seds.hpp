@@ -0,0 +1,127 @@
+#ifndef EDSPARSER_FORMATS_SEDS_HPP
+#define EDSPARSER_FORMATS_SEDS_HPP
+
+#include "../common.hpp"
+#include "source_set.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace edsparser {
+namespace seds {
+
+/**
+ * Source (sEDS) encodings
+ *
+ * All encodings hold one non-empty set of path IDs per string, in string-ID order.
+ *
+ * TEXT     {0}{1,3}{2}...           one ID per entry
+ * RANGES   {0}{1-500,502}{2}...     runs of 3 or more consecutive IDs as first-last
+ *                                   (a superset of TEXT, read by the same parser)
+ * BINARY   .sedz container, layout (integers in host byte order):
+ *            Header   32 bytes, see below
+ *            sets     per set: varint run count, then per run varint gap from the
+ *                     end of the previous run (0 before the first) and varint
+ *                     run length - 1
+ *          Varints are LEB128 (7 bits per byte, low bits first).
+ *
+ * Large cohorts carry sample sets that are mostly runs of consecutive IDs, which
+ * both RANGES and BINARY store in a few bytes regardless of the run length.
+ */
+enum class Format {
+    TEXT,
+    RANGES,
+    BINARY
+};
+
+constexpr char MAGIC[4] = {'S', 'D', 'Z', '\x1a'};
+constexpr uint32_t VERSION = 1;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t num_sets;        // Number of strings (m)
+    uint64_t num_ids;         // Total path IDs over all sets
+    uint64_t payload_bytes;   // Bytes of run data after the header
+};
+static_assert(sizeof(Header) == 32, "sEDS binary header must be 32 bytes");
+
+// Whether the buffer starts with the binary sEDS magic
+bool is_binary(const char* data, size_t size);
+
+// Parse any encoding (binary detected by its magic); throws std::runtime_error on malformed input
+SourceTable parse(const char* data, size_t size);
+
+// Called once per set with the offset of its encoding in the scanned buffer and its
+// path IDs as written (any order, duplicates possible)
+using SetVisitor = std::function<void(uint64_t offset, const int32_t* path_ids, size_t count)>;
+
+// Visit every set of a buffer in string-ID order, with the validation of parse()
+void scan(const char* data, size_t size, const SetVisitor& visit);
+
+// Visit the sets of a slice of a scanned buffer that starts at a set's offset and ends
+// at another set's offset or the end of the buffer (binary: slice of the payload)
+void scan_slice(const char* data, size_t size, bool binary, const SetVisitor& visit);
+
+/**
+ * Sequential reader of an sEDS stream (any encoding), one set at a time
+ *
+ * Reads the stream in chunks and decodes the complete sets of each chunk, so
+ * memory is bounded by the chunk and the largest set, not by the stream.
+ * Validation and error messages are those of parse(); a binary stream is
+ * checked against its header when the end is reached.
+ */
+class StreamReader {
+public:
+    static constexpr size_t CHUNK_BYTES = size_t(1) << 20;
+
+    explicit StreamReader(std::istream& is) : is_(is) {}
+
+    // Path IDs of the next set as written (any order, duplicates possible);
+    // false at the end of the stream. Throws std::runtime_error on malformed input.
+    bool next(std::vector<int32_t>& path_ids);
+
+    uint64_t sets_read() const { return sets_read_; }
+
+private:
+    bool fill();          // Append a chunk to the buffer, false at the end of the stream
+    void decode_text();   // Queue the complete text sets of the buffer
+    void decode_binary(); // Queue the complete binary sets of the buffer
+
+    std::istream& is_;
+    std::string buffer_;
+    size_t pos_ = 0;              // First byte of the buffer not decoded yet
+    uint64_t consumed_ = 0;       // Stream offset of buffer_[0]
+    bool started_ = false;
+    bool eof_ = false;
+    bool binary_ = false;
+    Header header_{};
+    uint64_t ids_read_ = 0;
+
+    // Decoded sets not returned yet
+    std::vector<int32_t> queue_ids_;
+    std::vector<uint32_t> queue_counts_;
+    size_t queue_set_ = 0;
+    size_t queue_pos_ = 0;
+    uint64_t sets_read_ = 0;      // Sets returned
+    uint64_t sets_decoded_ = 0;   // Sets queued
+};
+
+// Write sources in the given encoding
+void write(std::ostream& os, const SourceTable& sources, Format format);
+
+// Encoding implied by a file name: .sedz is BINARY, anything else keeps `fallback`
+Format format_for(const std::filesystem::path& path, Format fallback);
+
+// "text", "ranges" or "binary" (std::invalid_argument otherwise)
+Format parse_format(const std::string& name);
+
+} // namespace seds
+} // namespace edsparser
+
+#endif // EDSPARSER_FORMATS_SEDS_HPP
@@ -0,0 +1,105 @@
+#include "source_index.hpp"
+#include "seds.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace edsparser {
+
+SourceIndex::SourceIndex(const std::filesystem::path& path, size_t cache_budget) {
+    MappedFile mapped(path.string());
+    mapped.advise_sequential();
+    binary_ = seds::is_binary(mapped.data(), mapped.size());
+
+    // One validating pass: set offsets, path IDs in use and the statistics
+    std::vector<uint64_t> offsets;
+    std::vector<bool> used;
+    std::vector<int32_t> distinct;
+    // Pages already scanned are dropped as the scan goes, so it does not pin the whole file
+    constexpr uint64_t DROP_INTERVAL = uint64_t(64) << 20;
+    uint64_t dropped = 0;
+    seds::scan(mapped.data(), mapped.size(), [&](uint64_t offset, const int32_t* ids, size_t count) {
+        if (offset - dropped >= DROP_INTERVAL) {
+            mapped.drop_pages(offset);
+            dropped = offset;
+        }
+        offsets.push_back(offset);
+        distinct.assign(ids, ids + count);
+        std::sort(distinct.begin(), distinct.end());
+        distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+        for (int32_t id : distinct) {
+            if (static_cast<size_t>(id) >= used.size()) {
+                used.resize(std::max(static_cast<size_t>(id) + 1, used.size() * 2));
+            }
+            used[id] = true;
+        }
+        max_paths_per_string_ = std::max(max_paths_per_string_, distinct.size());
+        total_paths_ += distinct.size();
+    });
+    offsets.push_back(mapped.size());
+
+    std::vector<int> paths;
+    for (size_t id = 0; id < used.size(); id++) {
+        if (used[id]) {
+            paths.push_back(static_cast<int>(id));
+        }
+    }
+    numbering_ = SourceTable::with_paths(std::move(paths));
+    offsets_ = succinct::EliasFano::build(offsets.size(), [&](size_t i) { return offsets[i]; });
+
+    file_ = RandomAccessFile(path.string());
+    cache_ = std::make_unique<SourceBlockCache>(cache_budget);
+}
+
+const SourceSet& SourceIndex::get(size_t string_id, std::shared_ptr<const SourceBlock>& hold) const {
+    if (string_id >= size()) {
+        throw std::out_of_range("String ID " + std::to_string(string_id) + " out of range for sources (size: " +
+                                std::to_string(size()) + ")");
+    }
+    hold = cache_->get(string_id / SourceBlock::SETS_PER_BLOCK,
+                       [this](size_t block_id) { return load_block(block_id); });
+    return hold->sets[string_id % SourceBlock::SETS_PER_BLOCK];
+}
+
+std::shared_ptr<const SourceBlock> SourceIndex::load_block(size_t block_id) const {
+    size_t first = block_id * SourceBlock::SETS_PER_BLOCK;
+    size_t last = std::min(size(), first + SourceBlock::SETS_PER_BLOCK);
+    uint64_t begin = offsets_[first];
+    uint64_t end = offsets_[last];
+
+    std::string bytes(static_cast<size_t>(end - begin), '\0');
+    file_.read_at(begin, bytes.data(), bytes.size());
+
+    auto block = std::make_shared<SourceBlock>();
+    block->sets.reserve(last - first);
+    std::vector<int32_t> path_ids;
+    seds::scan_slice(bytes.data(), bytes.size(), binary_, [&](uint64_t, const int32_t* ids, size_t count) {
+        path_ids.assign(ids, ids + count);
+        block->sets.push_back(numbering_.make(std::move(path_ids)));
+    });
+    if (block->sets.size() != last - first) {
+        throw std::runtime_error("sEDS: Source file changed since it was indexed");
+    }
+    return block;
+}
+
+SourceTable SourceIndex::materialize() const {
+    SourceTable table = numbering_.derive();
+    table.reserve(size());
+
+    // Block by block, without going through the cache
+    for (size_t block_id = 0; block_id * SourceBlock::SETS_PER_BLOCK < size(); block_id++) {
+        std::shared_ptr<const SourceBlock> block = load_block(block_id);
+        for (const auto& set : block->sets) {
+            table.push_back(set);
+        }
+    }
+    return table;
+}
+
+size_t SourceIndex::bytes() const {
+    return sizeof(SourceIndex) + offsets_.bytes() + numbering_.bytes();
+}
+
+} // namespace edsparser
@@ -0,0 +1,66 @@
+#ifndef EDSPARSER_FORMATS_SOURCE_INDEX_HPP
+#define EDSPARSER_FORMATS_SOURCE_INDEX_HPP
+
+#include "../common.hpp"
+#include "block_cache.hpp"
+#include "source_set.hpp"
+#include "succinct.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+namespace edsparser {
+
+/**
+ * On-demand sources of a METADATA_ONLY EDS
+ *
+ * Opening scans the sEDS file once (any encoding, see seds.hpp) to validate it,
+ * record where each set starts (Elias-Fano, m+1 offsets) and collect the source
+ * statistics; no set is kept. Sets are then decoded by blocks of
+ * SourceBlock::SETS_PER_BLOCK strings with one pread each, and the blocks are
+ * kept in a SourceBlockCache bounded by the cache budget. Resident memory is the
+ * offsets, the path numbering (one int per distinct path ID) and the cache.
+ *
+ * All sets use numbering(), a table with the distinct path IDs of the file and
+ * no sets of its own, so numbering().intersect() applies to them.
+ * Safe to query from several threads.
+ */
+class SourceIndex {
+public:
+    static constexpr size_t DEFAULT_CACHE_BUDGET = size_t(4) << 20;
+
+    // Throws std::runtime_error if the file cannot be read or is malformed
+    SourceIndex(const std::filesystem::path& path, size_t cache_budget = DEFAULT_CACHE_BUDGET);
+
+    size_t size() const { return offsets_.size() - 1; }  // Number of sets (m)
+    const SourceTable& numbering() const { return numbering_; }
+
+    // Set of one string; `hold` keeps its decoded block alive while the reference is used
+    const SourceSet& get(size_t string_id, std::shared_ptr<const SourceBlock>& hold) const;
+
+    // All sets decoded in one pass, in numbering() (for whole-table operations)
+    SourceTable materialize() const;
+
+    // Statistics gathered while opening (as EDS::calculate_source_statistics)
+    size_t num_paths() const { return numbering_.path_count(); }
+    size_t max_paths_per_string() const { return max_paths_per_string_; }
+    size_t total_paths() const { return total_paths_; }
+
+    BlockCacheStats cache_stats() const { return cache_->stats(); }
+    size_t bytes() const;  // Resident size without the cache
+
+private:
+    std::shared_ptr<const SourceBlock> load_block(size_t block_id) const;
+
+    RandomAccessFile file_;
+    bool binary_ = false;
+    succinct::EliasFano offsets_;   // File offset of each set, last = end of the sets
+    SourceTable numbering_;
+    size_t max_paths_per_string_ = 0;
+    size_t total_paths_ = 0;
+    std::unique_ptr<SourceBlockCache> cache_;
+};
+
+} // namespace edsparser
+
+#endif // EDSPARSER_FORMATS_SOURCE_INDEX_HPP
@@ -0,0 +1,280 @@
+#include "source_set.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define EDSPARSER_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace edsparser {
+
+namespace {
+    // out = a & b over `words` words, returns the number of set bits in out
+    using AndCountKernel = size_t (*)(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words);
+
+    size_t and_count_scalar(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+        size_t count = 0;
+        for (size_t i = 0; i < words; i++) {
+            out[i] = a[i] & b[i];
+            count += static_cast<size_t>(__builtin_popcountll(out[i]));
+        }
+        return count;
+    }
+
+#ifdef EDSPARSER_X86_KERNELS
+    // AVX2: 256-bit AND, popcount of the four 64-bit lanes
+    __attribute__((target("avx2,popcnt")))
+    size_t and_count_avx2(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 4 <= words; i += 4) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            __m256i v = _mm256_and_si256(va, vb);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+            count += static_cast<size_t>(_mm_popcnt_u64(static_cast<uint64_t>(_mm256_extract_epi64(v, 0))) +
+                                         _mm_popcnt_u64(static_cast<uint64_t>(_mm256_extract_epi64(v, 1))) +
+                                         _mm_popcnt_u64(static_cast<uint64_t>(_mm256_extract_epi64(v, 2))) +
+                                         _mm_popcnt_u64(static_cast<uint64_t>(_mm256_extract_epi64(v, 3))));
+        }
+        for (; i < words; i++) {
+            out[i] = a[i] & b[i];
+            count += static_cast<size_t>(_mm_popcnt_u64(out[i]));
+        }
+        return count;
+    }
+#endif
+
+    AndCountKernel select_kernel() {
+#ifdef EDSPARSER_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+            return and_count_avx2;
+        }
+#endif
+        return and_count_scalar;
+    }
+
+    // Kernel for this CPU, picked on first use
+    size_t and_count(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+        static const AndCountKernel kernel = select_kernel();
+        return kernel(a, b, out, words);
+    }
+
+    // Bitset over `universe` paths pays off once members would take more room as 4-byte indices
+    inline bool prefer_dense(size_t count, uint32_t universe) {
+        return universe > 0 && count * 32 >= universe;
+    }
+}
+
+// ================================================================================
+// SOURCE SET
+// ================================================================================
+
+bool SourceSet::contains(uint32_t index) const {
+    if (dense_) {
+        return index / 64 < bits_.size() && ((bits_[index / 64] >> (index % 64)) & 1);
+    }
+    return std::binary_search(members_.begin(), members_.end(), index);
+}
+
+bool SourceSet::operator==(const SourceSet& other) const {
+    if (count_ != other.count_) {
+        return false;
+    }
+    if (dense_ == other.dense_) {
+        return dense_ ? bits_ == other.bits_ : members_ == other.members_;
+    }
+    const SourceSet& sparse = dense_ ? other : *this;
+    const SourceSet& dense = dense_ ? *this : other;
+    return std::all_of(sparse.members_.begin(), sparse.members_.end(),
+                       [&](uint32_t index) { return dense.contains(index); });
+}
+
+// ================================================================================
+// SOURCE TABLE
+// ================================================================================
+
+SourceTable::SourceTable(const std::vector<std::set<int>>& sets) {
+    std::vector<uint32_t> counts;
+    std::vector<int32_t> ids;
+    counts.reserve(sets.size());
+    for (const auto& set : sets) {
+        counts.push_back(static_cast<uint32_t>(set.size()));
+        ids.insert(ids.end(), set.begin(), set.end());
+    }
+    build(counts, ids);
+}
+
+SourceTable::SourceTable(const std::vector<uint32_t>& counts, const std::vector<int32_t>& ids) {
+    build(counts, ids);
+}
+
+void SourceTable::build(const std::vector<uint32_t>& counts, const std::vector<int32_t>& ids) {
+    // Dense numbering in increasing ID order (so path 0, if present, is index 0)
+    auto paths = std::make_shared<std::vector<int>>(ids.begin(), ids.end());
+    std::sort(paths->begin(), paths->end());
+    paths->erase(std::unique(paths->begin(), paths->end()), paths->end());
+    paths_ = std::move(paths);
+
+    sets_.clear();
+    sets_.reserve(counts.size());
+    size_t next = 0;
+    std::vector<uint32_t> indices;
+    for (uint32_t count : counts) {
+        if (count > ids.size() - next) {
+            throw std::invalid_argument("SourceTable: counts exceed the number of path IDs");
+        }
+        indices.clear();
+        for (size_t k = next; k < next + count; k++) {
+            auto it = std::lower_bound(paths_->begin(), paths_->end(), ids[k]);
+            indices.push_back(static_cast<uint32_t>(it - paths_->begin()));
+        }
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+        sets_.push_back(make_set(indices));
+        next += count;
+    }
+}
+
+SourceSet SourceTable::make_set(std::vector<uint32_t> sorted_indices) const {
+    SourceSet set;
+    set.count_ = static_cast<uint32_t>(sorted_indices.size());
+    set.universal_ = !sorted_indices.empty() && sorted_indices[0] == 0 && (*paths_)[0] == 0;
+    if (prefer_dense(sorted_indices.size(), universe())) {
+        set.dense_ = true;
+        set.bits_.assign((universe() + 63) / 64, 0);
+        for (uint32_t index : sorted_indices) {
+            set.bits_[index / 64] |= uint64_t(1) << (index % 64);
+        }
+    } else {
+        set.members_ = std::move(sorted_indices);
+    }
+    return set;
+}
+
+SourceTable SourceTable::with_paths(std::vector<int> path_ids) {
+    SourceTable table;
+    table.paths_ = std::make_shared<const std::vector<int>>(std::move(path_ids));
+    return table;
+}
+
+SourceTable SourceTable::derive() const {
+    SourceTable table;
+    table.paths_ = paths_;
+    return table;
+}
+
+void SourceTable::append(const SourceTable& from, size_t first, size_t count) {
+    sets_.insert(sets_.end(), from.sets_.begin() + first, from.sets_.begin() + first + count);
+}
+
+SourceSet SourceTable::make(std::vector<int32_t> path_ids) const {
+    std::sort(path_ids.begin(), path_ids.end());
+    path_ids.erase(std::unique(path_ids.begin(), path_ids.end()), path_ids.end());
+
+    static const std::vector<int> no_paths;
+    const std::vector<int>& paths = paths_ ? *paths_ : no_paths;
+
+    std::vector<uint32_t> indices;
+    indices.reserve(path_ids.size());
+    auto it = paths.begin();
+    for (int32_t path_id : path_ids) {
+        it = std::lower_bound(it, paths.end(), path_id);
+        if (it == paths.end() || *it != path_id) {
+            throw std::invalid_argument("SourceTable: Path ID " + std::to_string(path_id) + " is not numbered");
+        }
+        indices.push_back(static_cast<uint32_t>(it - paths.begin()));
+    }
+    return make_set(std::move(indices));
+}
+
+SourceSet SourceTable::intersect(const SourceSet& a, const SourceSet& b) const {
+    // Universal marker {0}: identity for the other set, {0} ∩ {0} = {0}
+    if (a.universal_ && b.universal_) {
+        return make_set({0});
+    }
+    if (a.universal_) {
+        return b;
+    }
+    if (b.universal_) {
+        return a;
+    }
+
+    if (a.dense_ && b.dense_) {
+        SourceSet result;
+        result.bits_.resize(a.bits_.size());
+        size_t count = and_count(a.bits_.data(), b.bits_.data(), result.bits_.data(), a.bits_.size());
+        if (prefer_dense(count, universe())) {
+            result.dense_ = true;
+            result.count_ = static_cast<uint32_t>(count);
+            return result;
+        }
+        std::vector<uint32_t> indices;
+        indices.reserve(count);
+        result.dense_ = true;
+        result.for_each([&](uint32_t index) { indices.push_back(index); });
+        return make_set(std::move(indices));
+    }
+
+    std::vector<uint32_t> indices;
+    if (a.dense_ || b.dense_) {
+        // Probe the bitset with the members of the sorted set
+        const SourceSet& sparse = a.dense_ ? b : a;
+        const SourceSet& dense = a.dense_ ? a : b;
+        indices.reserve(sparse.members_.size());
+        for (uint32_t index : sparse.members_) {
+            if ((dense.bits_[index / 64] >> (index % 64)) & 1) {
+                indices.push_back(index);
+            }
+        }
+    } else {
+        indices.reserve(std::min(a.members_.size(), b.members_.size()));
+        std::set_intersection(a.members_.begin(), a.members_.end(),
+                              b.members_.begin(), b.members_.end(),
+                              std::back_inserter(indices));
+    }
+    return make_set(std::move(indices));
+}
+
+std::set<int> SourceTable::to_set(size_t string_id) const {
+    std::set<int> result;
+    for_each_path(sets_[string_id], [&](int path_id) { result.insert(result.end(), path_id); });
+    return result;
+}
+
+std::vector<std::set<int>> SourceTable::to_sets() const {
+    std::vector<std::set<int>> result;
+    result.reserve(sets_.size());
+    for (size_t i = 0; i < sets_.size(); i++) {
+        result.push_back(to_set(i));
+    }
+    return result;
+}
+
+size_t SourceTable::num_paths() const {
+    std::vector<bool> used(universe(), false);
+    size_t distinct = 0;
+    for (const auto& set : sets_) {
+        set.for_each([&](uint32_t index) {
+            if (!used[index]) {
+                used[index] = true;
+                distinct++;
+            }
+        });
+    }
+    return distinct;
+}
+
+size_t SourceTable::bytes() const {
+    size_t total = sets_.capacity() * sizeof(SourceSet) + (paths_ ? paths_->capacity() * sizeof(int) : 0);
+    for (const auto& set : sets_) {
+        total += set.bytes() - sizeof(SourceSet);
+    }
+    return total;
+}
+
+} // namespace edsparser
@@ -0,0 +1,129 @@
+#ifndef EDSPARSER_FORMATS_SOURCE_SET_HPP
+#define EDSPARSER_FORMATS_SOURCE_SET_HPP
+
+#include "../common.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace edsparser {
+
+/**
+ * Paths (sources) of one EDS string, as dense path indices of a SourceTable
+ *
+ * Each set picks its layout by density, like a roaring container: a sorted
+ * array of indices when sparse, a bitset over all paths of the table when
+ * 4 bytes per member would take more room than the bitset. Path ID 0 is the
+ * universal marker: a set containing it is compatible with every path
+ * (see SourceTable::intersect). Sets are only meaningful together with the
+ * table that numbered them.
+ */
+class SourceSet {
+public:
+    SourceSet() = default;  // Empty set
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    bool is_universal() const { return universal_; }  // Contains path ID 0
+    bool is_dense() const { return dense_; }          // Bitset layout
+
+    bool contains(uint32_t index) const;
+
+    // Call f(index) for every member, in increasing order
+    template <typename F>
+    void for_each(F f) const {
+        if (!dense_) {
+            for (uint32_t index : members_) {
+                f(index);
+            }
+            return;
+        }
+        for (size_t w = 0; w < bits_.size(); w++) {
+            for (uint64_t word = bits_[w]; word != 0; word &= word - 1) {
+                f(static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+            }
+        }
+    }
+
+    bool operator==(const SourceSet& other) const;
+    bool operator!=(const SourceSet& other) const { return !(*this == other); }
+
+    size_t bytes() const { return sizeof(SourceSet) + bits_.capacity() * sizeof(uint64_t) + members_.capacity() * sizeof(uint32_t); }
+
+private:
+    friend class SourceTable;
+
+    std::vector<uint64_t> bits_;     // Bitset layout: bit i is path index i
+    std::vector<uint32_t> members_;  // Sorted layout
+    uint32_t count_ = 0;
+    bool universal_ = false;
+    bool dense_ = false;
+};
+
+/**
+ * Source sets of all strings of an EDS (sEDS), indexed by string ID
+ *
+ * Path IDs are renumbered densely (0..num_paths-1 in increasing ID order) on
+ * construction; tables derived from one another (merges) share the numbering.
+ * Intersections of two bitsets AND and popcount whole words, with an AVX2
+ * kernel picked at runtime when the CPU has it.
+ */
+class SourceTable {
+public:
+    SourceTable() = default;
+    explicit SourceTable(const std::vector<std::set<int>>& sets);
+
+    // Flattened lists: set i holds the next counts[i] entries of ids (any order, duplicates allowed)
+    SourceTable(const std::vector<uint32_t>& counts, const std::vector<int32_t>& ids);
+
+    size_t size() const { return sets_.size(); }
+    bool empty() const { return sets_.empty(); }
+    const SourceSet& operator[](size_t string_id) const { return sets_[string_id]; }
+
+    // Empty table numbering exactly these path IDs (sorted, distinct), filled with push_back
+    static SourceTable with_paths(std::vector<int> path_ids);
+
+    // Empty table with the same path numbering, filled with push_back / append
+    SourceTable derive() const;
+    void reserve(size_t count) { sets_.reserve(count); }
+    void push_back(SourceSet set) { sets_.push_back(std::move(set)); }
+    void append(const SourceTable& from, size_t first, size_t count);
+
+    // Set of the given path IDs (any order, duplicates allowed) in this table's
+    // numbering; throws std::invalid_argument for an ID the table does not number
+    SourceSet make(std::vector<int32_t> path_ids) const;
+
+    /*
+     * Paths compatible with both sets: a universal set is the identity
+     * ({0} ∩ X = X), two universal sets give {0}, otherwise the plain
+     * intersection. Both sets must come from this table's numbering.
+     */
+    SourceSet intersect(const SourceSet& a, const SourceSet& b) const;
+
+    // Call f(path_id) for every path of the set, in increasing ID order
+    template <typename F>
+    void for_each_path(const SourceSet& set, F f) const {
+        set.for_each([&](uint32_t index) { f((*paths_)[index]); });
+    }
+
+    std::set<int> to_set(size_t string_id) const;   // Original path IDs
+    std::vector<std::set<int>> to_sets() const;
+
+    size_t num_paths() const;  // Distinct path IDs used by the sets
+    size_t path_count() const { return universe(); }  // Path IDs in the numbering
+    size_t bytes() const;
+
+private:
+    void build(const std::vector<uint32_t>& counts, const std::vector<int32_t>& ids);
+    SourceSet make_set(std::vector<uint32_t> sorted_indices) const;
+    uint32_t universe() const { return paths_ ? static_cast<uint32_t>(paths_->size()) : 0; }
+
+    std::shared_ptr<const std::vector<int>> paths_;  // Dense index -> path ID (increasing)
+    std::vector<SourceSet> sets_;
+};
+
+} // namespace edsparser
+
+#endif // EDSPARSER_FORMATS_SOURCE_SET_HPP
@@ -0,0 +1,180 @@
+#include "succinct.hpp"
+
+namespace edsparser {
+namespace succinct {
+
+namespace {
+    inline unsigned popcount(uint64_t word) {
+        return static_cast<unsigned>(__builtin_popcountll(word));
+    }
+
+    // Position of the k-th set bit of word (k >= 1, word has at least k set bits)
+    inline unsigned select_in_word(uint64_t word, size_t k) {
+        for (size_t i = 1; i < k; i++) {
+            word &= word - 1;
+        }
+        return static_cast<unsigned>(__builtin_ctzll(word));
+    }
+}
+
+// ================================================================================
+// PackedVector
+// ================================================================================
+
+PackedVector::PackedVector(size_t size, unsigned width)
+    : words_((size * width + 63) / 64 + 1, 0), size_(size), width_(width) {}
+
+unsigned PackedVector::bits_for(uint64_t value) {
+    return value == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(value));
+}
+
+void PackedVector::set(size_t i, uint64_t value) {
+    if (width_ == 0) {
+        return;
+    }
+    size_t bit = i * width_;
+    size_t word = bit >> 6;
+    unsigned offset = static_cast<unsigned>(bit & 63);
+    uint64_t mask = width_ == 64 ? ~uint64_t(0) : (uint64_t(1) << width_) - 1;
+    value &= mask;
+
+    words_[word] = (words_[word] & ~(mask << offset)) | (value << offset);
+    if (offset + width_ > 64) {
+        unsigned spill = 64 - offset;
+        words_[word + 1] = (words_[word + 1] & ~(mask >> spill)) | (value >> spill);
+    }
+}
+
+// ================================================================================
+// BitVector
+// ================================================================================
+
+BitVector::BitVector(size_t size)
+    : words_((size + 63) / 64, 0), size_(size) {}
+
+void BitVector::set(size_t i) {
+    words_[i >> 6] |= uint64_t(1) << (i & 63);
+}
+
+void BitVector::build_support() {
+    size_t blocks = (words_.size() + WORDS_PER_BLOCK - 1) / WORDS_PER_BLOCK;
+    block_ranks_.assign(blocks + 1, 0);
+    select1_samples_.clear();
+    select0_samples_.clear();
+
+    size_t ones = 0;
+    size_t zeros = 0;
+    for (size_t b = 0; b < blocks; b++) {
+        block_ranks_[b] = ones;
+
+        size_t block_ones = 0;
+        size_t block_bits = 0;
+        for (size_t w = b * WORDS_PER_BLOCK; w < std::min(words_.size(), (b + 1) * WORDS_PER_BLOCK); w++) {
+            block_ones += popcount(words_[w]);
+            block_bits += 64;
+        }
+        // Padding after the last bit is not a zero of the vector
+        if (b + 1 == blocks) {
+            block_bits -= words_.size() * 64 - size_;
+        }
+        size_t block_zeros = block_bits - block_ones;
+
+        // Sample every block in which a sampled one/zero falls
+        while (select1_samples_.size() * SELECT_SAMPLE < ones + block_ones) {
+            select1_samples_.push_back(static_cast<uint32_t>(b));
+        }
+        while (select0_samples_.size() * SELECT_SAMPLE < zeros + block_zeros) {
+            select0_samples_.push_back(static_cast<uint32_t>(b));
+        }
+
+        ones += block_ones;
+        zeros += block_zeros;
+    }
+    block_ranks_[blocks] = ones;
+    ones_ = ones;
+}
+
+size_t BitVector::rank1(size_t i) const {
+    size_t word = i >> 6;
+    size_t block = word / WORDS_PER_BLOCK;
+    size_t rank = block_ranks_[block];
+    for (size_t w = block * WORDS_PER_BLOCK; w < word; w++) {
+        rank += popcount(words_[w]);
+    }
+    if ((i & 63) != 0) {
+        rank += popcount(words_[word] & ((uint64_t(1) << (i & 63)) - 1));
+    }
+    return rank;
+}
+
+size_t BitVector::select1(size_t k) const {
+    size_t block = select1_samples_[(k - 1) / SELECT_SAMPLE];
+    while (block_ranks_[block + 1] < k) {
+        block++;
+    }
+
+    size_t remaining = k - block_ranks_[block];
+    for (size_t w = block * WORDS_PER_BLOCK;; w++) {
+        unsigned count = popcount(words_[w]);
+        if (remaining <= count) {
+            return w * 64 + select_in_word(words_[w], remaining);
+        }
+        remaining -= count;
+    }
+}
+
+size_t BitVector::select0(size_t k) const {
+    size_t block = select0_samples_[(k - 1) / SELECT_SAMPLE];
+    size_t blocks = block_ranks_.size() - 1;
+    while (block + 1 < blocks && zeros_before_block(block + 1) < k) {
+        block++;
+    }
+
+    size_t remaining = k - zeros_before_block(block);
+    for (size_t w = block * WORDS_PER_BLOCK;; w++) {
+        unsigned count = popcount(~words_[w]);
+        if (remaining <= count) {
+            return w * 64 + select_in_word(~words_[w], remaining);
+        }
+        remaining -= count;
+    }
+}
+
+size_t BitVector::bytes() const {
+    return words_.capacity() * sizeof(uint64_t) +
+           block_ranks_.capacity() * sizeof(uint64_t) +
+           (select1_samples_.capacity() + select0_samples_.capacity()) * sizeof(uint32_t);
+}
+
+// ================================================================================
+// EliasFano
+// ================================================================================
+
+size_t EliasFano::upper_bound(uint64_t value) const {
+    if (size_ == 0) {
+        return 0;
+    }
+    if (value >= last_) {
+        return size_;
+    }
+
+    // Skip the buckets of smaller high parts with one select0
+    uint64_t high = value >> low_bits_;
+    size_t pos = 0;
+    size_t k = 0;
+    if (high > 0) {
+        pos = highs_.select0(high) + 1;
+        k = pos - high;
+    }
+
+    // Scan the bucket of equal high part
+    uint64_t low = low_bits_ == 0 ? 0 : value & ((uint64_t(1) << low_bits_) - 1);
+    while (pos < highs_.size() && highs_[pos] && lows_[k] <= low) {
+        k++;
+        pos++;
+    }
+    return k;
+}
+
+} // namespace succinct
+} // namespace edsparser
@@ -0,0 +1,157 @@
+#ifndef EDSPARSER_FORMATS_SUCCINCT_HPP
+#define EDSPARSER_FORMATS_SUCCINCT_HPP
+
+#include "../common.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace edsparser {
+namespace succinct {
+
+/**
+ * Compressed building blocks for METADATA_ONLY metadata (see EDS::compress_metadata)
+ *
+ * - PackedVector: unsigned integers stored with the bit width of the largest value
+ * - BitVector:    plain bits with rank/select support (512-bit blocks, sampled select)
+ * - EliasFano:    monotone non-decreasing sequence, ~2 + log(u/n) bits per element,
+ *                 with access and predecessor search via select
+ *
+ * All structures are immutable once built and safe to query concurrently.
+ */
+
+class PackedVector {
+public:
+    PackedVector() = default;
+    PackedVector(size_t size, unsigned width);
+
+    // Build from get(0..size-1), using the bit width of the largest value
+    template <typename Get>
+    static PackedVector build(size_t size, Get get) {
+        uint64_t max_value = 0;
+        for (size_t i = 0; i < size; i++) {
+            max_value = std::max<uint64_t>(max_value, get(i));
+        }
+        PackedVector result(size, bits_for(max_value));
+        for (size_t i = 0; i < size; i++) {
+            result.set(i, get(i));
+        }
+        return result;
+    }
+
+    void set(size_t i, uint64_t value);
+
+    uint64_t operator[](size_t i) const {
+        if (width_ == 0) {
+            return 0;
+        }
+        size_t bit = i * width_;
+        size_t word = bit >> 6;
+        unsigned offset = static_cast<unsigned>(bit & 63);
+        uint64_t value = words_[word] >> offset;
+        if (offset + width_ > 64) {
+            value |= words_[word + 1] << (64 - offset);
+        }
+        return width_ == 64 ? value : value & ((uint64_t(1) << width_) - 1);
+    }
+
+    size_t size() const { return size_; }
+    unsigned width() const { return width_; }
+    size_t bytes() const { return words_.capacity() * sizeof(uint64_t); }
+
+    static unsigned bits_for(uint64_t value);
+
+private:
+    std::vector<uint64_t> words_;
+    size_t size_ = 0;
+    unsigned width_ = 0;
+};
+
+class BitVector {
+public:
+    BitVector() = default;
+    explicit BitVector(size_t size);  // All zero
+
+    void set(size_t i);      // Only before build_support()
+    void build_support();    // Rank and select samples
+
+    bool operator[](size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+    size_t size() const { return size_; }
+    size_t count_ones() const { return ones_; }
+
+    size_t rank1(size_t i) const;    // Ones in [0, i)
+    size_t select1(size_t k) const;  // Position of the k-th one (k >= 1)
+    size_t select0(size_t k) const;  // Position of the k-th zero (k >= 1)
+
+    size_t bytes() const;
+
+private:
+    static constexpr size_t WORDS_PER_BLOCK = 8;   // 512-bit rank blocks
+    static constexpr size_t SELECT_SAMPLE = 512;   // Every 512th one/zero is sampled
+
+    size_t zeros_before_block(size_t block) const {
+        return block * WORDS_PER_BLOCK * 64 - block_ranks_[block];
+    }
+
+    std::vector<uint64_t> words_;
+    std::vector<uint64_t> block_ranks_;      // Ones before each block (blocks+1 entries)
+    std::vector<uint32_t> select1_samples_;  // Block holding one number j*SELECT_SAMPLE+1
+    std::vector<uint32_t> select0_samples_;  // Block holding zero number j*SELECT_SAMPLE+1
+    size_t size_ = 0;
+    size_t ones_ = 0;
+};
+
+class EliasFano {
+public:
+    EliasFano() = default;
+
+    // Build from get(0..size-1), which must be non-decreasing
+    template <typename Get>
+    static EliasFano build(size_t size, Get get) {
+        EliasFano result;
+        result.size_ = size;
+        result.last_ = size > 0 ? get(size - 1) : 0;
+
+        uint64_t universe = result.last_ + 1;
+        unsigned low_bits = 0;
+        if (size > 0 && universe > size) {
+            low_bits = PackedVector::bits_for(universe / size) - 1;
+        }
+        result.low_bits_ = low_bits;
+        result.lows_ = PackedVector(size, low_bits);
+        result.highs_ = BitVector(size + (result.last_ >> low_bits) + 1);
+
+        uint64_t low_mask = low_bits == 0 ? 0 : (uint64_t(1) << low_bits) - 1;
+        for (size_t i = 0; i < size; i++) {
+            uint64_t value = get(i);
+            result.lows_.set(i, value & low_mask);
+            result.highs_.set((value >> low_bits) + i);
+        }
+        result.highs_.build_support();
+        return result;
+    }
+
+    uint64_t operator[](size_t i) const {
+        uint64_t high = highs_.select1(i + 1) - i;
+        return (high << low_bits_) | lows_[i];
+    }
+
+    // Number of elements <= value (std::upper_bound as an index)
+    size_t upper_bound(uint64_t value) const;
+
+    size_t size() const { return size_; }
+    size_t bytes() const { return lows_.bytes() + highs_.bytes(); }
+
+private:
+    PackedVector lows_;
+    BitVector highs_;
+    size_t size_ = 0;
+    uint64_t last_ = 0;
+    unsigned low_bits_ = 0;
+};
+
+} // namespace succinct
+} // namespace edsparser
+
+#endif // EDSPARSER_FORMATS_SUCCINCT_HPP
@@ -0,0 +1,120 @@
+#ifndef EDSPARSER_FORMATS_SYMBOL_VIEW_HPP
+#define EDSPARSER_FORMATS_SYMBOL_VIEW_HPP
+
+#include "../common.hpp"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string_view>
+
+namespace edsparser {
+
+/**
+ * Read-only view of the alternatives of one EDS symbol (see EDS::symbol_view)
+ *
+ * Nothing is copied: the view points into the FULL-mode arena or into the
+ * memory-mapped file of a METADATA_ONLY EDS, with string lengths taken from
+ * the EDS metadata. Views stay valid while the EDS is alive and not moved.
+ *
+ * Two layouts are supported:
+ * - Indexed: string i starts at base + offsets[i] (FULL-mode arena, O(1) operator[])
+ * - Packed: strings follow each other from data, separated by `gap` bytes
+ *   (1 for the commas of a text file, 0 for a decoded buffer); operator[] walks
+ *   the preceding lengths, iteration is O(1) per step
+ *
+ * Symbols that cannot be viewed in place (whitespace inside the symbol, 2-bit
+ * .edz payload, block cache) are decoded into a buffer whose ownership the view shares.
+ */
+class SymbolView {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        iterator() = default;
+
+        std::string_view operator*() const {
+            if (view_->offsets_ != nullptr) {
+                return std::string_view(view_->data_ + view_->offsets_[index_], view_->lengths_[index_]);
+            }
+            return std::string_view(view_->data_ + offset_, view_->lengths_[index_]);
+        }
+
+        iterator& operator++() {
+            offset_ += view_->lengths_[index_] + view_->gap_;
+            index_++;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const iterator& other) const { return index_ != other.index_; }
+
+    private:
+        friend class SymbolView;
+        iterator(const SymbolView* view, size_t index) : view_(view), index_(index) {}
+
+        const SymbolView* view_ = nullptr;
+        size_t index_ = 0;
+        size_t offset_ = 0;   // Byte offset of string index_ (packed layout)
+    };
+
+    SymbolView() = default;
+
+    // Indexed layout: string i is base[offsets[i] .. offsets[i] + lengths[i])
+    SymbolView(const char* base, const Position* offsets, const Length* lengths, size_t count)
+        : data_(base), offsets_(offsets), lengths_(lengths), size_(count) {}
+
+    // Packed layout: strings back to back from data, `gap` separator bytes between them
+    SymbolView(const char* data, const Length* lengths, size_t count, Length gap,
+               std::shared_ptr<const void> owner = nullptr)
+        : data_(data), lengths_(lengths), size_(count), gap_(gap), owner_(std::move(owner)) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    std::string_view operator[](size_t i) const {
+        if (offsets_ != nullptr) {
+            return std::string_view(data_ + offsets_[i], lengths_[i]);
+        }
+        size_t offset = 0;
+        for (size_t j = 0; j < i; j++) {
+            offset += lengths_[j] + gap_;
+        }
+        return std::string_view(data_ + offset, lengths_[i]);
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size_); }
+
+    // Owning copy of the alternatives
+    StringSet to_set() const {
+        StringSet result;
+        result.reserve(size_);
+        for (std::string_view s : *this) {
+            result.emplace_back(s);
+        }
+        return result;
+    }
+
+private:
+    const char* data_ = nullptr;
+    const Position* offsets_ = nullptr;   // Indexed layout only
+    const Length* lengths_ = nullptr;
+    size_t size_ = 0;
+    Length gap_ = 0;
+    std::shared_ptr<const void> owner_;  // Decoded buffer or cache block, if any
+};
+
+} // namespace edsparser
+
+#endif // EDSPARSER_FORMATS_SYMBOL_VIEW_HPP
@@ -1,8 +1,15 @@
 #include "eds_transforms.hpp"
+#include "leds_builder.hpp"
+#include "../formats/eds_stream.hpp"
+#include "../formats/edz.hpp"
+#include "../formats/seds.hpp"
 #include <algorithm>
+#include <charconv>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <sstream>
-#include <fstream>
-#include <filesystem>
 #include <stdexcept>
 
 #ifdef _OPENMP
@@ -12,287 +19,479 @@
 namespace edsparser {
 
 namespace {
+    constexpr size_t READ_CHUNK = size_t(1) << 20;
+    constexpr size_t WRITE_CHUNK = size_t(1) << 16;
+    constexpr size_t BATCH_BYTES_PER_THREAD = size_t(1) << 20;  // Input buffered per thread before a parallel build
+    constexpr size_t PIECES_PER_THREAD = 4;                      // Pieces per batch and thread (load balance)
+
+    using Symbol = LedsBuilder::Symbol;
+    using SymbolSink = std::function<void(Symbol)>;
+
+    // Append a symbol in EDS text (full or compact format) and, if given, its sources in sEDS text
+    void format_symbol(const Symbol& symbol, bool compact, std::string& eds_out, std::string* seds_out) {
+        // Compact format drops the brackets of common symbols (unless empty)
+        bool brackets = !compact || !symbol.common() || symbol.strings[0].empty();
+        if (brackets) eds_out.push_back(SET_OPEN);
+        for (size_t i = 0; i < symbol.strings.size(); i++) {
+            if (i > 0) eds_out.push_back(SET_SEPARATOR);
+            eds_out += symbol.strings[i];
+        }
+        if (brackets) eds_out.push_back(SET_CLOSE);
+
+        if (seds_out) {
+            char digits[16];
+            for (const auto& paths : symbol.sources) {
+                seds_out->push_back(SET_OPEN);
+                for (size_t k = 0; k < paths.size(); k++) {
+                    if (k > 0) seds_out->push_back(SET_SEPARATOR);
+                    auto [ptr, ec] = std::to_chars(digits, digits + sizeof(digits), paths[k]);
+                    seds_out->append(digits, ptr);
+                }
+                seds_out->push_back(SET_CLOSE);
+            }
+        }
+    }
+
     /**
-     * Represents a pair of adjacent positions to merge
+     * Writes l-EDS symbols to the output streams as they are produced
+     * (EDS text in full or compact format, sEDS text with sources).
      */
-    struct MergePair {
-        size_t pos1;
-        size_t pos2;
+    class LedsWriter {
+    public:
+        LedsWriter(std::ostream& eds, std::ostream* seds, bool compact)
+            : eds_(eds), seds_(seds), compact_(compact) {}
 
-        MergePair(size_t p1, size_t p2) : pos1(p1), pos2(p2) {}
-    };
+        bool compact() const { return compact_; }
+        bool writes_sources() const { return seds_ != nullptr; }
 
-    /**
-     * Result of merging a pair of positions
-     */
-    struct MergeResult {
-        size_t original_pos1;
-        size_t original_pos2;
-        StringSet merged_set;
-        std::vector<std::set<int>> merged_sources;  // Empty if no sources
+        void write(const Symbol& symbol) {
+            format_symbol(symbol, compact_, eds_out_, seds_ ? &seds_out_ : nullptr);
+            flush(false);
+        }
+
+        // Symbols already formatted by format_symbol
+        void write_formatted(const std::string& eds, const std::string& seds) {
+            flush(true);
+            eds_.write(eds.data(), static_cast<std::streamsize>(eds.size()));
+            if (seds_) {
+                seds_->write(seds.data(), static_cast<std::streamsize>(seds.size()));
+            }
+        }
+
+        void finish() {
+            eds_out_.push_back('\n');
+            if (seds_) {
+                seds_out_.push_back('\n');
+            }
+            flush(true);
+        }
+
+    private:
+        void flush(bool all) {
+            if (all || eds_out_.size() >= WRITE_CHUNK) {
+                eds_.write(eds_out_.data(), static_cast<std::streamsize>(eds_out_.size()));
+                eds_out_.clear();
+            }
+            if (seds_ && (all || seds_out_.size() >= WRITE_CHUNK)) {
+                seds_->write(seds_out_.data(), static_cast<std::streamsize>(seds_out_.size()));
+                seds_out_.clear();
+            }
+        }
+
+        std::ostream& eds_;
+        std::ostream* seds_;
+        bool compact_;
+        std::string eds_out_;
+        std::string seds_out_;
     };
 
     /**
-     * Select independent pairs of adjacent positions to merge in parallel.
+     * Multi-core l-EDS construction with the output of a single LedsBuilder.
      *
-     * Strategy: Greedy left-to-right selection, choosing pairs where merging
-     * would help satisfy the l-EDS property. Ensures no overlapping positions
-     * so parallel merging is safe.
-     *
-     * @param eds The EDS to analyze
-     * @param context_length Minimum context length l
-     * @return Vector of non-overlapping merge pairs
+     * Input symbols are buffered in batches of about BATCH_BYTES_PER_THREAD
+     * per thread. A batch is cut before common blocks of length >= l that
+     * follow a degenerate symbol (no window spans them), its pieces are built
+     * and formatted concurrently, then written in order: a common block ending
+     * one piece is folded into the common block starting the next, as the
+     * builder's own output fold would. The symbols after the last cut stay
+     * for the next batch, so memory is bounded by the batch plus one window.
+     * If `next` is given, the output before folding is also passed to it in
+     * order (see LedsBuilder::set_forward).
      */
-    std::vector<MergePair> select_independent_merge_pairs(
-        const EDS& eds,
-        Length context_length
-    ) {
-        std::vector<MergePair> pairs;
-
-        if (eds.length() < 2) {
-            return pairs;  // Need at least 2 positions to merge
+    class ChunkedLedsBuilder {
+    public:
+        ChunkedLedsBuilder(Length context_length, bool with_sources, const MergeLimit& limit, size_t threads,
+                           LedsWriter& writer, SymbolSink next = nullptr)
+            : context_length_(context_length), with_sources_(with_sources), limit_(limit), threads_(threads),
+              writer_(writer), next_(std::move(next)) {}
+
+        const std::vector<UnmergedWindow>& unmerged() const { return unmerged_; }
+
+        void push(Symbol symbol) {
+            size_t index = batch_.size();
+            if (symbol.common() && !symbol.merged) {
+                if (!in_run_) {
+                    in_run_ = true;
+                    run_cut_ = false;
+                    run_start_ = index;
+                    run_start_bytes_ = batch_bytes_;
+                    run_length_ = 0;
+                }
+                run_length_ += symbol.strings[0].size();
+                if (!run_cut_ && run_start_ > 0 && run_length_ >= context_length_) {
+                    run_cut_ = true;
+                    cuts_.push_back({run_start_, run_start_bytes_});
+                }
+            } else {
+                in_run_ = false;
+            }
+
+            for (const auto& str : symbol.strings) {
+                batch_bytes_ += str.size() + 1;
+            }
+            batch_.push_back(std::move(symbol));
+
+            if (batch_bytes_ >= threads_ * BATCH_BYTES_PER_THREAD && !cuts_.empty()) {
+                build(cuts_.back());
+            }
         }
 
-        // Get degenerate flags from metadata
-        const auto& is_degenerate = eds.get_is_degenerate();
+        void finish() {
+            if (!batch_.empty()) {
+                build({batch_.size(), batch_bytes_});
+            }
+            flush_pending();
+        }
 
-        // Track which positions are already included in pairs
-        std::vector<bool> used(eds.length(), false);
+    private:
+        struct Cut {
+            size_t index;  // Batch symbol the next piece starts at
+            size_t bytes;  // Batch bytes before it
+        };
+
+        struct Piece {
+            bool has_head = false;
+            Symbol head;            // Leading common block
+            std::string eds;        // Formatted symbols in between
+            std::string seds;
+            std::vector<Symbol> body;  // Output before folding, kept for the next stage
+            bool has_tail = false;
+            Symbol tail;            // Trailing common block
+            std::vector<UnmergedWindow> unmerged;
+        };
+
+        // Build and write batch symbols [0, end.index), keep the rest
+        void build(Cut end) {
+            // Pieces of roughly equal input size
+            size_t pieces_wanted = threads_ * PIECES_PER_THREAD;
+            size_t target = std::max<size_t>(1, end.bytes / pieces_wanted);
+            std::vector<Cut> bounds = {{0, 0}};
+            for (const Cut& cut : cuts_) {
+                if (cut.index >= end.index) {
+                    break;
+                }
+                if (cut.bytes - bounds.back().bytes >= target) {
+                    bounds.push_back(cut);
+                }
+            }
+            bounds.push_back(end);
 
-        // Greedy left-to-right selection
-        for (size_t i = 0; i + 1 < eds.length(); ++i) {
-            if (used[i] || used[i + 1]) {
-                continue;  // Position already in a pair
+            std::vector<Piece> pieces(bounds.size() - 1);
+            // Rethrow the error of the first failing piece, which is the one a sequential build reports
+            std::vector<std::exception_ptr> errors(pieces.size());
+#ifdef _OPENMP
+            #pragma omp parallel for num_threads(threads_) schedule(dynamic, 1)
+#endif
+            for (size_t p = 0; p < pieces.size(); p++) {
+                try {
+                    build_piece(bounds[p].index, bounds[p + 1].index, pieces[p]);
+                } catch (...) {
+                    errors[p] = std::current_exception();
+                }
+            }
+            for (const auto& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
             }
 
-            // Only merge if it would fix an l-EDS violation
-            // Cases to merge:
-            // 1. Internal common block with length < l
-            // 2. Two adjacent degenerate symbols (implicit empty common block)
-            bool should_merge = false;
+            for (size_t p = 0; p < pieces.size(); p++) {
+                join(pieces[p], batch_first_ + bounds[p].index);
+                unmerged_.insert(unmerged_.end(), pieces[p].unmerged.begin(), pieces[p].unmerged.end());
+            }
 
-            // Check if position i is an internal common block that's too short
-            if (!is_degenerate[i] && i > 0 && i < eds.length() - 1) {
-                size_t global_idx1 = eds.get_metadata().cum_set_sizes[i];
-                Length len1 = eds.get_string_length(global_idx1);
-                if (len1 < context_length) {
-                    should_merge = true;
+            // Keep the symbols after the end (the current common run, if any, is among them)
+            batch_.erase(batch_.begin(), batch_.begin() + static_cast<std::ptrdiff_t>(end.index));
+            batch_first_ += end.index;
+            batch_bytes_ -= end.bytes;
+            std::vector<Cut> kept;
+            for (const Cut& cut : cuts_) {
+                if (cut.index > end.index) {
+                    kept.push_back({cut.index - end.index, cut.bytes - end.bytes});
                 }
             }
+            cuts_ = std::move(kept);
+            if (in_run_) {
+                run_start_ -= end.index;
+                run_start_bytes_ -= end.bytes;
+            }
+        }
 
-            // Check if position i+1 is an internal common block that's too short
-            if (!is_degenerate[i + 1] && (i + 1) > 0 && (i + 1) < eds.length() - 1) {
-                size_t global_idx2 = eds.get_metadata().cum_set_sizes[i + 1];
-                Length len2 = eds.get_string_length(global_idx2);
-                if (len2 < context_length) {
-                    should_merge = true;
+        void build_piece(size_t begin, size_t end, Piece& piece) {
+            bool compact = writer_.compact();
+            std::string* seds_out = writer_.writes_sources() ? &piece.seds : nullptr;
+
+            // Output common blocks are folded by the builder, so only the first and
+            // the last output symbol can meet a common block of a neighbouring piece
+            bool first_output = true;
+            bool held = false;
+            Symbol last;
+            LedsBuilder builder(context_length_, with_sources_, [&](Symbol& symbol) {
+                if (held) {
+                    format_symbol(last, compact, piece.eds, seds_out);
+                    held = false;
+                }
+                if (!symbol.common()) {
+                    format_symbol(symbol, compact, piece.eds, seds_out);
+                } else if (first_output) {
+                    piece.head = std::move(symbol);
+                    piece.has_head = true;
+                } else {
+                    last = std::move(symbol);
+                    held = true;
                 }
+                first_output = false;
+            }, limit_, batch_first_ + begin);
+            if (next_) {
+                builder.set_forward([&piece](Symbol& symbol) { piece.body.push_back(std::move(symbol)); });
             }
 
-            // Check if both positions are degenerate (implicit empty common)
-            // This represents an implicit {} between them, which has length 0 < context_length
-            // Note: Edge case exemption applies only to common blocks, not degenerate symbols
-            if (is_degenerate[i] && is_degenerate[i + 1]) {
-                should_merge = true;
+            for (size_t i = begin; i < end; i++) {
+                builder.push(std::move(batch_[i]));
             }
+            builder.finish();
+            piece.unmerged = builder.unmerged();
 
-            if (should_merge) {
-                pairs.emplace_back(i, i + 1);
-                used[i] = true;
-                used[i + 1] = true;
+            if (held) {
+                piece.tail = std::move(last);
+                piece.has_tail = true;
             }
         }
 
-        return pairs;
-    }
+        void join(Piece& piece, Position first_symbol) {
+            if (piece.has_head) {
+                if (has_pending_) {
+                    pending_ = LedsBuilder::concatenate(pending_, piece.head, with_sources_);
+                    if (pending_.strings.empty()) {
+                        throw std::runtime_error("Common blocks around symbol " +
+                                                 std::to_string(first_symbol) + " share no path");
+                    }
+                } else {
+                    pending_ = std::move(piece.head);
+                    has_pending_ = true;
+                }
+            }
+            if (!piece.eds.empty()) {
+                flush_pending();
+                writer_.write_formatted(piece.eds, piece.seds);
+            }
+            for (auto& symbol : piece.body) {
+                next_(std::move(symbol));
+            }
+            if (piece.has_tail) {
+                pending_ = std::move(piece.tail);
+                has_pending_ = true;
+            }
+        }
+
+        void flush_pending() {
+            if (has_pending_) {
+                has_pending_ = false;
+                writer_.write(pending_);
+            }
+        }
+
+        Length context_length_;
+        bool with_sources_;
+        MergeLimit limit_;
+        size_t threads_;
+        LedsWriter& writer_;
+        SymbolSink next_;
+        std::vector<UnmergedWindow> unmerged_;
+
+        std::vector<Symbol> batch_;
+        Position batch_first_ = 0;  // Input number of batch_[0]
+        size_t batch_bytes_ = 0;
+        std::vector<Cut> cuts_;     // Cut points in the batch, in order
+
+        // Common run at the end of the batch
+        bool in_run_ = false;
+        bool run_cut_ = false;
+        size_t run_start_ = 0;
+        size_t run_start_bytes_ = 0;
+        size_t run_length_ = 0;
+
+        // Common block ending the output so far, held back for folding
+        bool has_pending_ = false;
+        Symbol pending_;
+    };
 
     /**
-     * Merge multiple pairs of positions in parallel.
+     * Feed an EDS stream, and its sources if given, to a sink symbol by symbol.
      *
-     * Each pair is processed independently, then results are combined
-     * to construct a new EDS.
+     * Text EDS goes through EDSStreamParser and sEDS through seds::StreamReader,
+     * so only one symbol and its source sets are held at a time. Binary .edz
+     * input cannot be streamed and is loaded whole (with its own sources if it
+     * carries them).
      *
-     * @param eds The original EDS
-     * @param pairs Vector of non-overlapping merge pairs
-     * @param num_threads Number of threads to use (1 = sequential)
-     * @return Vector of merge results
+     * `start` is told whether the symbols carry sources before the first one
+     * and returns the sink they are pushed to.
      */
-    std::vector<MergeResult> merge_multiple_pairs(
-        const EDS& eds,
-        const std::vector<MergePair>& pairs,
-        size_t num_threads
-    ) {
-        std::vector<MergeResult> results(pairs.size());
-
-        if (num_threads <= 1 || pairs.empty()) {
-            // Sequential execution
-            for (size_t i = 0; i < pairs.size(); ++i) {
-                const auto& pair = pairs[i];
-                EDS merged = eds.merge_adjacent(pair.pos1, pair.pos2);
-
-                results[i].original_pos1 = pair.pos1;
-                results[i].original_pos2 = pair.pos2;
-                // merge_adjacent returns full EDS with positions merged at pos1
-                results[i].merged_set = merged.read_symbol(pair.pos1);
-
-                // Extract sources if present
-                if (eds.has_sources()) {
-                    size_t merged_size = merged.get_symbol_size(pair.pos1);
-                    const auto& all_sources = merged.get_sources();
-                    size_t global_idx = merged.get_metadata().cum_set_sizes[pair.pos1];
-                    results[i].merged_sources.resize(merged_size);
-                    for (size_t j = 0; j < merged_size; ++j) {
-                        results[i].merged_sources[j] = all_sources[global_idx + j];
-                    }
-                }
-            }
-        } else {
-            // Parallel execution with OpenMP
-#ifdef _OPENMP
-            #pragma omp parallel for num_threads(num_threads)
-            for (size_t i = 0; i < pairs.size(); ++i) {
-                const auto& pair = pairs[i];
-                EDS merged = eds.merge_adjacent(pair.pos1, pair.pos2);
-
-                results[i].original_pos1 = pair.pos1;
-                results[i].original_pos2 = pair.pos2;
-                results[i].merged_set = merged.read_symbol(pair.pos1);
-
-                // Extract sources if present
-                if (eds.has_sources()) {
-                    size_t merged_size = merged.get_symbol_size(pair.pos1);
-                    const auto& all_sources = merged.get_sources();
-                    size_t global_idx = merged.get_metadata().cum_set_sizes[pair.pos1];
-                    results[i].merged_sources.resize(merged_size);
-                    for (size_t j = 0; j < merged_size; ++j) {
-                        results[i].merged_sources[j] = all_sources[global_idx + j];
+    void stream_symbols(std::istream& input, std::istream* sources,
+                        const std::function<SymbolSink(bool)>& start) {
+        std::string chunk(READ_CHUNK, '\0');
+        input.read(&chunk[0], static_cast<std::streamsize>(chunk.size()));
+        chunk.resize(static_cast<size_t>(input.gcount()));
+
+        if (edz::is_edz(chunk.data(), chunk.size())) {
+            chunk.append(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+            std::istringstream edz_input(chunk);
+            EDS eds = sources ? EDS(edz_input, *sources) : EDS(edz_input);
+            SymbolSink sink = start(eds.has_sources());
+
+            const SourceTable* table = eds.has_sources() ? &eds.get_source_table() : nullptr;
+            size_t string_id = 0;
+            for (size_t pos = 0; pos < eds.length(); pos++) {
+                Symbol symbol;
+                symbol.strings = eds.symbol_view(pos).to_set();
+                if (table) {
+                    for (size_t k = 0; k < symbol.strings.size(); k++) {
+                        std::vector<int32_t> paths;
+                        table->for_each_path((*table)[string_id++], [&](int id) { paths.push_back(id); });
+                        symbol.sources.push_back(std::move(paths));
                     }
                 }
+                sink(std::move(symbol));
             }
-#else
-            // OpenMP not available, fall back to sequential
-            for (size_t i = 0; i < pairs.size(); ++i) {
-                const auto& pair = pairs[i];
-                EDS merged = eds.merge_adjacent(pair.pos1, pair.pos2);
-
-                results[i].original_pos1 = pair.pos1;
-                results[i].original_pos2 = pair.pos2;
-                results[i].merged_set = merged.read_symbol(pair.pos1);
-
-                if (eds.has_sources()) {
-                    size_t merged_size = merged.get_symbol_size(pair.pos1);
-                    const auto& all_sources = merged.get_sources();
-                    size_t global_idx = merged.get_metadata().cum_set_sizes[pair.pos1];
-                    results[i].merged_sources.resize(merged_size);
-                    for (size_t j = 0; j < merged_size; ++j) {
-                        results[i].merged_sources[j] = all_sources[global_idx + j];
+            return;
+        }
+
+        SymbolSink sink = start(sources != nullptr);
+        std::unique_ptr<seds::StreamReader> reader;
+        if (sources) {
+            reader = std::make_unique<seds::StreamReader>(*sources);
+        }
+
+        std::vector<int32_t> paths;
+        EDSStreamParser parser([&](const StreamedSymbol& streamed) {
+            Symbol symbol;
+            symbol.strings = streamed.strings.to_set();
+            if (reader) {
+                symbol.sources.reserve(symbol.strings.size());
+                for (size_t k = 0; k < symbol.strings.size(); k++) {
+                    if (!reader->next(paths)) {
+                        throw std::runtime_error("sEDS: Source count (" + std::to_string(reader->sets_read()) +
+                                                 ") is smaller than the EDS cardinality");
                     }
+                    std::sort(paths.begin(), paths.end());
+                    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+                    symbol.sources.push_back(paths);
                 }
             }
-#endif
+            sink(std::move(symbol));
+        });
+
+        while (!chunk.empty()) {
+            parser.feed(chunk.data(), chunk.size());
+            chunk.resize(READ_CHUNK);
+            input.read(&chunk[0], static_cast<std::streamsize>(chunk.size()));
+            chunk.resize(static_cast<size_t>(input.gcount()));
         }
+        parser.finish();
 
-        return results;
+        if (reader && reader->next(paths)) {
+            throw std::runtime_error("sEDS: Source count (more than " + std::to_string(reader->sets_read() - 1) +
+                                     ") does not match EDS cardinality (" +
+                                     std::to_string(parser.cardinality()) + ")");
+        }
     }
 
     /**
-     * Reconstruct EDS from original and merge results.
-     *
-     * Builds a new EDS by combining unmodified positions with merged results.
-     *
-     * @param original The original EDS
-     * @param merge_results Results from parallel merging
-     * @return New EDS with merges applied
+     * Streaming transform shared by all entry points (`allow_sources` false
+     * rejects inputs that carry sources). Every context length is a stage fed
+     * with the output of the previous one before folding: a LedsBuilder on one
+     * thread, a ChunkedLedsBuilder on more. Each stage writes to its own outputs.
      */
-    EDS reconstruct_eds(
-        const EDS& original,
-        const std::vector<MergeResult>& merge_results
-    ) {
-        // Build mapping: position -> merge result index (or -1 if not merged)
-        std::vector<int> merge_map(original.length(), -1);
-        std::vector<bool> skip(original.length(), false);
-
-        for (size_t i = 0; i < merge_results.size(); ++i) {
-            merge_map[merge_results[i].original_pos1] = static_cast<int>(i);
-            skip[merge_results[i].original_pos2] = true;  // Second position consumed by merge
+    std::vector<std::vector<UnmergedWindow>> transform_streaming(
+        std::istream& input, std::istream* sources, const std::vector<Length>& lengths,
+        const std::vector<std::ostream*>& outputs, const std::vector<std::ostream*>& sources_outputs,
+        bool compact, bool allow_sources, size_t num_threads, const MergeLimit& limit) {
+        if (lengths.empty()) {
+            throw std::invalid_argument("At least one context length is needed for l-EDS transformation");
         }
-
-        // Build new EDS string and sources
-        std::ostringstream eds_stream;
-        std::ostringstream sources_stream;
-        bool has_sources = original.has_sources();
-        const auto& all_sources = has_sources ? original.get_sources() : std::vector<std::set<int>>();
-
-        for (size_t pos = 0; pos < original.length(); ++pos) {
-            if (skip[pos]) {
-                continue;  // Position was merged into previous
+        for (size_t k = 0; k < lengths.size(); k++) {
+            if (lengths[k] == 0) {
+                throw std::invalid_argument("context_length must be > 0 for l-EDS transformation");
             }
+            if (k > 0 && lengths[k] <= lengths[k - 1]) {
+                throw std::invalid_argument("Context lengths must be strictly increasing");
+            }
+        }
+        if (outputs.size() != lengths.size() ||
+            (!sources_outputs.empty() && sources_outputs.size() != lengths.size())) {
+            throw std::invalid_argument("One output (and source output, if any) is needed per context length");
+        }
 
-            if (merge_map[pos] >= 0) {
-                // Use merged result
-                const auto& result = merge_results[merge_map[pos]];
-                const auto& merged_set = result.merged_set;
-
-                // Write merged symbol
-                eds_stream << '{';
-                for (size_t i = 0; i < merged_set.size(); ++i) {
-                    if (i > 0) eds_stream << ',';
-                    eds_stream << merged_set[i];
-                }
-                eds_stream << '}';
-
-                // Write merged sources if present
-                if (has_sources) {
-                    for (size_t i = 0; i < result.merged_sources.size(); ++i) {
-                        sources_stream << '{';
-                        bool first = true;
-                        for (int path_id : result.merged_sources[i]) {
-                            if (!first) sources_stream << ',';
-                            sources_stream << path_id;
-                            first = false;
-                        }
-                        sources_stream << '}';
-                    }
-                }
-            } else {
-                // Copy original symbol
-                const auto& symbol = original.read_symbol(pos);
-                eds_stream << '{';
-                for (size_t i = 0; i < symbol.size(); ++i) {
-                    if (i > 0) eds_stream << ',';
-                    eds_stream << symbol[i];
-                }
-                eds_stream << '}';
-
-                // Copy original sources if present
-                if (has_sources) {
-                    size_t symbol_size = original.get_symbol_size(pos);
-                    size_t global_idx = original.get_metadata().cum_set_sizes[pos];
-                    for (size_t i = 0; i < symbol_size; ++i) {
-                        const auto& src = all_sources[global_idx + i];
-                        sources_stream << '{';
-                        bool first = true;
-                        for (int path_id : src) {
-                            if (!first) sources_stream << ',';
-                            sources_stream << path_id;
-                            first = false;
-                        }
-                        sources_stream << '}';
+        size_t stages = lengths.size();
+        std::vector<std::unique_ptr<LedsWriter>> writers(stages);
+        std::vector<std::unique_ptr<LedsBuilder>> builders(stages);
+        std::vector<std::unique_ptr<ChunkedLedsBuilder>> chunked(stages);
+
+        // The writers and builders need to know whether sources are present, which
+        // binary input only tells once it is loaded. Stages are made last to first
+        // so each one can pass its output on to the next.
+        auto start = [&](bool with_sources) -> SymbolSink {
+            if (with_sources && !allow_sources) {
+                throw std::invalid_argument("Cartesian mode cannot be used with source files");
+            }
+            SymbolSink next;
+            for (size_t k = stages; k-- > 0;) {
+                std::ostream* seds = with_sources && !sources_outputs.empty() ? sources_outputs[k] : nullptr;
+                writers[k] = std::make_unique<LedsWriter>(*outputs[k], seds, compact);
+                LedsWriter& writer = *writers[k];
+                if (num_threads > 1) {
+                    chunked[k] = std::make_unique<ChunkedLedsBuilder>(lengths[k], with_sources, limit, num_threads,
+                                                                      writer, next);
+                    ChunkedLedsBuilder& stage = *chunked[k];
+                    next = [&stage](Symbol symbol) { stage.push(std::move(symbol)); };
+                } else {
+                    builders[k] = std::make_unique<LedsBuilder>(lengths[k], with_sources,
+                        [&writer](Symbol& symbol) { writer.write(symbol); }, limit);
+                    LedsBuilder& stage = *builders[k];
+                    if (next) {
+                        stage.set_forward([next](Symbol& symbol) { next(std::move(symbol)); });
                     }
+                    next = [&stage](Symbol symbol) { stage.push(std::move(symbol)); };
                 }
             }
-        }
-
-        // Construct new EDS
-        std::string eds_str = eds_stream.str();
+            return next;
+        };
 
+        stream_symbols(input, sources, start);
 
-        if (has_sources) {
-            std::string sources_str = sources_stream.str();
-            return EDS(eds_str, sources_str);
-        } else {
-            return EDS(eds_str);
+        // Finishing a stage flushes its last symbols into the next one
+        std::vector<std::vector<UnmergedWindow>> unmerged(stages);
+        for (size_t k = 0; k < stages; k++) {
+            if (chunked[k]) {
+                chunked[k]->finish();
+                unmerged[k] = chunked[k]->unmerged();
+            } else {
+                builders[k]->finish();
+                unmerged[k] = builders[k]->unmerged();
+            }
+            writers[k]->finish();
         }
+        return unmerged;
     }
 
 } // anonymous namespace
@@ -300,129 +499,132 @@ namespace {
 /**
  * Convert EDS to l-EDS using linear merging with phasing preservation.
  *
- * Iteratively merges adjacent positions until all internal common blocks
- * have length >= context_length. Uses parallel processing when num_threads > 1.
+ * Streams the input left to right through a LedsBuilder: the symbols between
+ * two common blocks of length >= context_length are collapsed by one merge
+ * and written out immediately, so memory is bounded by the largest such window.
+ * With several threads, batches of input are cut before such common blocks and
+ * the pieces are built concurrently; the output is the same.
  *
  * @param input EDS input stream
  * @param output l-EDS output stream
  * @param context_length Minimum context length l
  * @param phasing_input Optional phasing information (.seds file)
  * @param phasing_output Optional output for updated phasing
- * @param num_threads Number of threads for parallel processing (default: 1)
+ * @param num_threads Number of threads for parallel processing
+ * @param limit Cap on merged symbols and what to do with windows exceeding it
+ * @return Windows left unmerged under MergeLimit::Policy::KEEP_UNMERGED
  */
-void eds_to_leds_linear(
+std::vector<UnmergedWindow> eds_to_leds_linear(
     std::istream& input,
     std::ostream& output,
     Length context_length,
     std::istream* phasing_input,
     std::ostream* phasing_output,
     size_t num_threads,
-    bool compact
+    bool compact,
+    const MergeLimit& limit
 ) {
-    if (context_length == 0) {
-        throw std::invalid_argument("context_length must be > 0 for l-EDS transformation");
-    }
-
-    // Load EDS (with sources if provided)
-    EDS eds = phasing_input ? EDS(input, *phasing_input) : EDS(input);
-
-    // Enforce METADATA_ONLY mode for large datasets
-    // Note: Current implementation works with FULL mode, but for production
-    // should add mode enforcement and streaming support
-
-    // Iterative merging until convergence
-    size_t iteration = 0;
-    const size_t MAX_ITERATIONS = 10000;  // Safety limit
-
-    while (iteration < MAX_ITERATIONS) {
-        // Check convergence
-        if (is_leds(eds, context_length)) {
-            break;  // All internal common blocks satisfy l-EDS property
-        }
-
-        // Select independent pairs to merge
-        auto pairs = select_independent_merge_pairs(eds, context_length);
-
-        if (pairs.empty()) {
-            // No more pairs to merge, but still not l-EDS
-            // This can happen if degenerate symbols prevent further merging
-            break;
-        }
-
-        // Merge pairs in parallel
-        auto merge_results = merge_multiple_pairs(eds, pairs, num_threads);
-
-        // Reconstruct EDS with merged results
-        eds = reconstruct_eds(eds, merge_results);
-
-        iteration++;
-    }
-
-    if (iteration >= MAX_ITERATIONS) {
-        throw std::runtime_error("Maximum iterations reached without convergence");
-    }
-
-    // Write output
-    auto format = compact ? EDS::OutputFormat::COMPACT : EDS::OutputFormat::FULL;
-    eds.save(output, format);
-
-    // Write updated sources if requested
-    if (phasing_output && eds.has_sources()) {
-        eds.save_sources(*phasing_output);
-    }
+    return transform_streaming(input, phasing_input, {context_length}, {&output}, {phasing_output}, compact, true,
+                               num_threads, limit)[0];
 }
 
 /**
  * Convert EDS to l-EDS using cartesian merging.
  *
- * Similar to linear merging but uses cartesian product (ignores phasing).
- * Cannot be used with source files.
+ * Same streaming transform as linear merging, with cartesian products (ignores phasing)
+ * from which repeated strings are dropped. Cannot be used with source files.
  */
-void eds_to_leds_cartesian(
+std::vector<UnmergedWindow> eds_to_leds_cartesian(
     std::istream& input,
     std::ostream& output,
     Length context_length,
     size_t num_threads,
-    bool compact
+    bool compact,
+    const MergeLimit& limit
 ) {
-    if (context_length == 0) {
-        throw std::invalid_argument("context_length must be > 0 for l-EDS transformation");
-    }
+    return transform_streaming(input, nullptr, {context_length}, {&output}, {}, compact, false, num_threads,
+                               limit)[0];
+}
 
-    // Load EDS (without sources)
-    EDS eds(input);
+/**
+ * Convert EDS to l-EDS for several context lengths in one pass.
+ *
+ * The input is read once; each length is a streaming stage fed with the
+ * output of the previous one, so merges done for a shorter l are reused.
+ * Linear merging with sources (phasing_input, or an .edz carrying them),
+ * cartesian without.
+ */
+std::vector<std::vector<UnmergedWindow>> eds_to_leds_ladder(
+    std::istream& input,
+    const std::vector<Length>& context_lengths,
+    const std::vector<std::ostream*>& outputs,
+    std::istream* phasing_input,
+    const std::vector<std::ostream*>& phasing_outputs,
+    size_t num_threads,
+    bool compact,
+    const MergeLimit& limit
+) {
+    return transform_streaming(input, phasing_input, context_lengths, outputs, phasing_outputs, compact, true,
+                               num_threads, limit);
+}
 
-    if (eds.has_sources()) {
-        throw std::invalid_argument("Cartesian mode cannot be used with source files");
+/**
+ * Convert a loaded EDS to l-EDS following a merge plan.
+ *
+ * Groups are read symbol by symbol and merged left to right; the merged
+ * symbols go through a LedsBuilder, which passes a plan of plan_leds through
+ * unchanged and folds or merges further wherever a group came out common.
+ */
+void eds_to_leds_planned(
+    const EDS& eds,
+    std::ostream& output,
+    const LedsPlan& plan,
+    std::ostream* phasing_output,
+    bool compact
+) {
+    const auto& starts = plan.group_starts;
+    bool covers = eds.length() == 0 ? starts.empty() : !starts.empty() && starts[0] == 0;
+    for (size_t k = 1; k < starts.size() && covers; k++) {
+        covers = starts[k - 1] < starts[k] && starts[k] < eds.length();
     }
-
-    // Iterative merging (same logic as linear, but no source handling)
-    size_t iteration = 0;
-    const size_t MAX_ITERATIONS = 10000;
-
-    while (iteration < MAX_ITERATIONS) {
-        if (is_leds(eds, context_length)) {
-            break;
-        }
-
-        auto pairs = select_independent_merge_pairs(eds, context_length);
-
-        if (pairs.empty()) {
-            break;
-        }
-
-        auto merge_results = merge_multiple_pairs(eds, pairs, num_threads);
-        eds = reconstruct_eds(eds, merge_results);
-
-        iteration++;
+    if (!covers) {
+        throw std::invalid_argument("eds_to_leds_planned: Groups must start at symbol 0 and increase within the EDS");
     }
-
-    if (iteration >= MAX_ITERATIONS) {
-        throw std::runtime_error("Maximum iterations reached without convergence");
+    bool with_sources = eds.has_sources();
+    if (phasing_output && !with_sources) {
+        throw std::invalid_argument("eds_to_leds_planned: Sources output needs an EDS with sources");
     }
 
-    auto format = compact ? EDS::OutputFormat::COMPACT : EDS::OutputFormat::FULL;
-    eds.save(output, format);
+    LedsWriter writer(output, phasing_output, compact);
+    LedsBuilder builder(plan.context_length, with_sources, [&](Symbol& symbol) { writer.write(symbol); });
+
+    size_t string_id = 0;
+    for (size_t k = 0; k < starts.size(); k++) {
+        Position first = starts[k];
+        Position end = k + 1 < starts.size() ? starts[k + 1] : eds.length();
+        Symbol merged;
+        for (Position pos = first; pos < end; pos++) {
+            Symbol symbol;
+            symbol.strings = eds.symbol_view(pos).to_set();
+            if (with_sources) {
+                symbol.sources.reserve(symbol.strings.size());
+                for (size_t i = 0; i < symbol.strings.size(); i++) {
+                    symbol.sources.push_back(eds.get_string_sources(string_id + i));
+                }
+            }
+            string_id += symbol.strings.size();
+            merged = pos == first ? std::move(symbol) : LedsBuilder::concatenate(merged, symbol, with_sources);
+            if (merged.strings.empty()) {
+                throw std::runtime_error(
+                    "Merging symbols " + std::to_string(first) + " to " + std::to_string(end - 1) +
+                    " results in empty set (no valid source intersections)"
+                );
+            }
+        }
+        builder.push(std::move(merged));
+    }
+    builder.finish();
+    writer.finish();
 }
 
 /**
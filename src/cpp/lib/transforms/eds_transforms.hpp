@@ -3,7 +3,10 @@
 
 #include "../common.hpp"
 #include "../formats/eds.hpp"
+#include "leds_builder.hpp"
+#include "leds_profile.hpp"
 #include <iostream>
+#include <vector>
 
 namespace edsparser {
 
@@ -13,6 +16,16 @@ namespace edsparser {
  * This module provides transformations for Elastic-Degenerate Strings:
  * - EDS → l-EDS (length-constrained merging)
  * - Both LINEAR (phasing-aware) and CARTESIAN (all combinations) strategies
+ *
+ * Text input is streamed left to right (see LedsBuilder) and the output is
+ * written as it is produced, so memory is bounded by the largest window of
+ * symbols between two common blocks of length >= l, not by the input size.
+ * With num_threads > 1, batches of input are cut before such common blocks
+ * and the pieces are transformed concurrently; the output is identical.
+ *
+ * A MergeLimit caps the strings and bytes of every merged symbol; a window
+ * exceeding it fails the transform or, with KEEP_UNMERGED, is written as it
+ * is and returned, so memory stays bounded by the cap.
  */
 
 /**
@@ -25,28 +38,83 @@ namespace edsparser {
  * @param phasing_output Optional output for updated phasing
  * @param num_threads Number of threads for parallel processing (default: 1)
  * @param compact Use compact output format (omit brackets on non-degenerate symbols)
+ * @param limit Cap on merged symbols (default: none) and its fallback policy
+ * @return Windows left unmerged by MergeLimit::Policy::KEEP_UNMERGED
  */
-void eds_to_leds_linear(
+std::vector<UnmergedWindow> eds_to_leds_linear(
     std::istream& input,
     std::ostream& output,
     Length context_length,
     std::istream* phasing_input = nullptr,
     std::ostream* phasing_output = nullptr,
     size_t num_threads = 1,
-    bool compact = true
+    bool compact = true,
+    const MergeLimit& limit = MergeLimit()
 );
 
 /**
- * Convert EDS to l-EDS using cartesian merging
+ * Convert EDS to l-EDS using cartesian merging (repeated strings dropped)
+ * Throws std::invalid_argument for binary input carrying sources.
  *
  * @param num_threads Number of threads for parallel processing (default: 1)
  * @param compact Use compact output format (omit brackets on non-degenerate symbols)
+ * @param limit Cap on merged symbols (default: none) and its fallback policy
+ * @return Windows left unmerged by MergeLimit::Policy::KEEP_UNMERGED
  */
-void eds_to_leds_cartesian(
+std::vector<UnmergedWindow> eds_to_leds_cartesian(
     std::istream& input,
     std::ostream& output,
     Length context_length,
     size_t num_threads = 1,
+    bool compact = true,
+    const MergeLimit& limit = MergeLimit()
+);
+
+/**
+ * Convert EDS to l-EDS for several context lengths in one pass (a ladder)
+ *
+ * The input is read once and each level is built from the previous one: level
+ * k merges the windows level k-1 collapsed, with the input's common blocks in
+ * between, and never anchors on a collapsed window, so every level is the
+ * direct l[k]-EDS of the input, written as it is produced. (Under a MergeLimit
+ * a level may keep a window unmerged where the direct transform would not, or
+ * the reverse.) Merging is LINEAR with sources (phasing_input, or an .edz
+ * carrying them) and CARTESIAN without.
+ *
+ * @param context_lengths Strictly increasing context lengths
+ * @param outputs One l-EDS output per length
+ * @param phasing_outputs Empty, or one sEDS output (may be null) per length
+ * @return Windows left unmerged per level, numbered by that level's input symbols
+ */
+std::vector<std::vector<UnmergedWindow>> eds_to_leds_ladder(
+    std::istream& input,
+    const std::vector<Length>& context_lengths,
+    const std::vector<std::ostream*>& outputs,
+    std::istream* phasing_input = nullptr,
+    const std::vector<std::ostream*>& phasing_outputs = {},
+    size_t num_threads = 1,
+    bool compact = true,
+    const MergeLimit& limit = MergeLimit()
+);
+
+/**
+ * Convert a loaded EDS to l-EDS following a merge plan (see plan_leds)
+ *
+ * Each group of input symbols is merged into one symbol, LINEAR when the EDS
+ * has sources and CARTESIAN otherwise. The symbols then pass through a
+ * LedsBuilder for plan.context_length, so the output is an l-EDS whatever
+ * the plan. Works in both storage modes; memory is bounded by the largest group.
+ *
+ * @param phasing_output Optional output for the sources (EDS with sources only)
+ * @param compact Use compact output format (omit brackets on non-degenerate symbols)
+ * Throws std::invalid_argument if the plan does not cover the EDS, and
+ * std::runtime_error if a merge leaves no valid path
+ */
+void eds_to_leds_planned(
+    const EDS& eds,
+    std::ostream& output,
+    const LedsPlan& plan,
+    std::ostream* phasing_output = nullptr,
     bool compact = true
 );
 
@@ -0,0 +1,283 @@
+#include "leds_builder.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace edsparser {
+
+namespace {
+    // Path sets are sorted; a set containing 0 is universal (identity of the
+    // intersection, two of them giving {0}), as in SourceSet and merge_adjacent
+    bool is_universal(const std::vector<int32_t>& paths) {
+        return !paths.empty() && paths[0] == 0;
+    }
+
+    std::vector<int32_t> intersect_paths(const std::vector<int32_t>& a, const std::vector<int32_t>& b) {
+        if (is_universal(a)) {
+            return is_universal(b) ? std::vector<int32_t>{0} : b;
+        }
+        if (is_universal(b)) {
+            return a;
+        }
+        std::vector<int32_t> result;
+        result.reserve(std::min(a.size(), b.size()));
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        return result;
+    }
+
+    std::string describe(const MergeLimit& limit) {
+        std::string text;
+        if (limit.max_strings > 0) {
+            text = std::to_string(limit.max_strings) + " strings";
+        }
+        if (limit.max_bytes > 0) {
+            text += (text.empty() ? "" : ", ") + std::to_string(limit.max_bytes) + " bytes";
+        }
+        return text;
+    }
+}
+
+LedsBuilder::LedsBuilder(Length context_length, bool with_sources, SymbolCallback on_symbol,
+                         const MergeLimit& limit, Position first_symbol)
+    : context_length_(context_length), with_sources_(with_sources), on_symbol_(std::move(on_symbol)),
+      limit_(limit), first_symbol_(first_symbol) {
+    if (context_length == 0) {
+        throw std::invalid_argument("context_length must be > 0 for l-EDS transformation");
+    }
+}
+
+void LedsBuilder::push(Symbol symbol) {
+    if (finished_) {
+        throw std::runtime_error("LedsBuilder: push() after finish()");
+    }
+    Position index = first_symbol_ + symbols_in_;
+    if (symbol.strings.empty()) {
+        throw std::invalid_argument("LedsBuilder: Symbol " + std::to_string(index) + " is empty");
+    }
+    if (with_sources_ && symbol.sources.size() != symbol.strings.size()) {
+        throw std::invalid_argument("LedsBuilder: Symbol " + std::to_string(index) +
+                                    " needs one source set per string");
+    }
+    symbols_in_++;
+
+    if (symbol.common() && !symbol.merged) {
+        if (has_common_) {
+            common_ = merge(common_, symbol);
+            if (common_.strings.empty()) {
+                throw std::runtime_error("Common blocks at symbols " + std::to_string(common_first_) +
+                                         " to " + std::to_string(index) + " share no path");
+            }
+        } else {
+            common_ = std::move(symbol);
+            common_first_ = index;
+            has_common_ = true;
+        }
+        return;
+    }
+
+    if (has_common_) {
+        has_common_ = false;
+        item_first_ = common_first_;
+        item_last_ = index - 1;
+        push_item(std::move(common_));
+    }
+    item_first_ = item_last_ = index;
+    push_item(std::move(symbol));
+}
+
+void LedsBuilder::push_item(Symbol symbol) {
+    bool first_item = !seen_item_;
+    seen_item_ = true;
+
+    if (symbol.common() && !symbol.merged && (first_item || symbol.strings[0].size() >= context_length_)) {
+        // Anchor: closes the window
+        collapse_window();
+        emit(std::move(symbol));
+        return;
+    }
+
+    if (window_.empty()) {
+        window_first_ = item_first_;
+    }
+    window_last_ = item_last_;
+    window_.push_back(std::move(symbol));
+}
+
+void LedsBuilder::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    if (has_common_) {
+        has_common_ = false;
+        item_first_ = common_first_;
+        item_last_ = first_symbol_ + symbols_in_ - 1;
+        push_item(std::move(common_));
+    }
+
+    // A short common block at the end is the last symbol, which needs no context
+    if (!window_.empty() && window_.back().common() && !window_.back().merged) {
+        Symbol tail = std::move(window_.back());
+        window_.pop_back();
+        collapse_window();
+        emit(std::move(tail));
+    } else {
+        collapse_window();
+    }
+
+    if (has_output_common_) {
+        has_output_common_ = false;
+        symbols_out_++;
+        on_symbol_(output_common_);
+    }
+}
+
+void LedsBuilder::collapse_window() {
+    if (window_.empty()) {
+        return;
+    }
+    peak_window_ = std::max(peak_window_, window_.size());
+
+    // One multi-way merge, left to right (the order of the merged alternatives
+    // is that of nested loops over the window's symbols)
+    Symbol merged;
+    bool within_limit = true;
+    if (window_.size() == 1) {
+        merged = std::move(window_[0]);
+    }
+    for (size_t k = 1; k < window_.size() && within_limit; k++) {
+        Symbol next;
+        within_limit = concatenate(k == 1 ? window_[0] : merged, window_[k], with_sources_, limit_, next);
+        merged = std::move(next);
+        if (within_limit && merged.strings.empty()) {
+            throw std::runtime_error(
+                "Merging symbols " + std::to_string(window_first_) + " to " +
+                std::to_string(window_last_) + " results in empty set "
+                "(no valid source intersections)"
+            );
+        }
+    }
+
+    if (!within_limit) {
+        if (limit_.policy == MergeLimit::Policy::FAIL) {
+            throw std::runtime_error(
+                "Merging symbols " + std::to_string(window_first_) + " to " +
+                std::to_string(window_last_) + " exceeds the merge limit (" + describe(limit_) + ")"
+            );
+        }
+        // Leave the window as it is (not l-EDS there) and report it
+        unmerged_.push_back({window_first_, window_last_});
+        std::vector<Symbol> items = std::move(window_);
+        window_.clear();
+        for (auto& item : items) {
+            emit(std::move(item));
+        }
+        return;
+    }
+    window_.clear();
+    merged.merged = true;
+    emit(std::move(merged));
+}
+
+void LedsBuilder::emit(Symbol symbol) {
+    if (symbol.common()) {
+        if (forward_) {
+            Symbol copy = symbol;
+            forward_(copy);
+        }
+        if (has_output_common_) {
+            output_common_ = merge(output_common_, symbol);
+            if (output_common_.strings.empty()) {
+                throw std::runtime_error("Common blocks around symbol " +
+                                         std::to_string(item_first_) + " share no path");
+            }
+        } else {
+            output_common_ = std::move(symbol);
+            has_output_common_ = true;
+        }
+        return;
+    }
+
+    if (has_output_common_) {
+        has_output_common_ = false;
+        symbols_out_++;
+        on_symbol_(output_common_);
+    }
+    symbols_out_++;
+    on_symbol_(symbol);
+    if (forward_) {
+        forward_(symbol);
+    }
+}
+
+LedsBuilder::Symbol LedsBuilder::concatenate(const Symbol& left, const Symbol& right, bool with_sources) {
+    Symbol merged;
+    concatenate(left, right, with_sources, MergeLimit(), merged);
+    return merged;
+}
+
+bool LedsBuilder::concatenate(const Symbol& left, const Symbol& right, bool with_sources,
+                              const MergeLimit& limit, Symbol& merged) {
+    merged.strings.clear();
+    merged.sources.clear();
+    size_t bytes = 0;
+    auto within_limit = [&]() {
+        return (limit.max_strings == 0 || merged.strings.size() <= limit.max_strings) &&
+               (limit.max_bytes == 0 || bytes <= limit.max_bytes);
+    };
+
+    // Room for the strings the merge can reach: a byte cap alone does not bound
+    // their number, so it only bounds what the reservation itself may take
+    size_t combinations = left.strings.size() * right.strings.size();
+    if (limit.max_strings > 0) {
+        combinations = std::min(combinations, limit.max_strings + 1);
+    } else if (limit.max_bytes > 0) {
+        combinations = std::min(combinations, limit.max_bytes / sizeof(std::string) + 1);
+    }
+
+    if (!with_sources) {
+        // CARTESIAN: all distinct combinations, in order of first occurrence
+        // (the set holds indices into merged.strings)
+        auto hash = [&](size_t i) { return std::hash<std::string_view>()(merged.strings[i]); };
+        auto equal = [&](size_t i, size_t j) { return merged.strings[i] == merged.strings[j]; };
+        std::unordered_set<size_t, decltype(hash), decltype(equal)> seen(combinations, hash, equal);
+
+        merged.strings.reserve(combinations);
+        for (const auto& str1 : left.strings) {
+            for (const auto& str2 : right.strings) {
+                merged.strings.push_back(str1 + str2);
+                if (!seen.insert(merged.strings.size() - 1).second) {
+                    merged.strings.pop_back();
+                    continue;
+                }
+                bytes += merged.strings.back().size();
+                if (!within_limit()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // LINEAR: combinations whose path sets intersect
+    for (size_t i = 0; i < left.strings.size(); i++) {
+        for (size_t j = 0; j < right.strings.size(); j++) {
+            std::vector<int32_t> paths = intersect_paths(left.sources[i], right.sources[j]);
+            if (!paths.empty()) {
+                merged.strings.push_back(left.strings[i] + right.strings[j]);
+                merged.sources.push_back(std::move(paths));
+                bytes += merged.strings.back().size();
+                if (!within_limit()) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace edsparser
@@ -0,0 +1,142 @@
+#ifndef EDSPARSER_TRANSFORMS_LEDS_BUILDER_HPP
+#define EDSPARSER_TRANSFORMS_LEDS_BUILDER_HPP
+
+#include "../common.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace edsparser {
+
+/**
+ * Cap on the symbol a window merge may produce (0: no limit), checked while it
+ * is built, so a merge never holds more than about max_bytes of strings
+ */
+struct MergeLimit {
+    enum class Policy {
+        FAIL,           // Throw std::runtime_error naming the window
+        KEEP_UNMERGED   // Output the window's symbols as they are and report it
+    };
+
+    size_t max_strings = 0;  // Strings in the merged symbol
+    size_t max_bytes = 0;    // Characters in the merged symbol
+    Policy policy = Policy::FAIL;
+};
+
+// Input symbols [first, last] left unmerged by MergeLimit::Policy::KEEP_UNMERGED
+struct UnmergedWindow {
+    Position first;
+    Position last;
+};
+
+/**
+ * Streaming EDS → l-EDS construction
+ *
+ * Symbols are pushed left to right; l-EDS symbols are reported through the
+ * callback as soon as they are final:
+ * - adjacent common (single-string) symbols are concatenated, both in the input
+ *   and in the output;
+ * - a common block of length >= l, or the first symbol, is an anchor;
+ * - the degenerate symbols and shorter common blocks between two anchors form a
+ *   window, collapsed into one symbol by a single multi-way merge when the next
+ *   anchor arrives; a trailing short common block stays the last symbol.
+ * The result is an l-EDS (see is_leds). Merging is LINEAR with sources (only
+ * combinations whose path sets intersect, a set containing 0 intersecting
+ * everything) and CARTESIAN without; cartesian merges drop repeated strings
+ * (first occurrence kept). Windows whose merge exceeds the MergeLimit fail or,
+ * if the policy says so, are output unmerged and listed by unmerged().
+ *
+ * Memory is bounded by the largest window and the largest common block, time
+ * is linear in the input plus the size of the merged symbols.
+ *
+ * Windows never span a common block of length >= l preceded by a degenerate
+ * symbol, so the input can be cut before such blocks and the pieces built
+ * independently: concatenating their outputs, with a common block ending one
+ * piece folded into the common block starting the next, gives the output of
+ * one builder over the whole input (see eds_to_leds_linear).
+ *
+ * The output before folding, with collapsed windows flagged, can feed a builder
+ * for a larger l (see set_forward): a flagged symbol is never folded into a
+ * common block nor taken as an anchor, so that builder sees the windows of the
+ * input, and as merging is associative its output is the transform of the input.
+ */
+class LedsBuilder {
+public:
+    struct Symbol {
+        StringSet strings;
+        std::vector<std::vector<int32_t>> sources;  // Sorted path IDs per string (with sources only)
+        bool merged = false;  // A collapsed window, not an input common block
+
+        bool common() const { return strings.size() == 1; }
+    };
+    using SymbolCallback = std::function<void(Symbol&)>;
+
+    // Throws std::invalid_argument if context_length is 0; first_symbol numbers
+    // the first pushed symbol in messages (for a piece of a longer input)
+    LedsBuilder(Length context_length, bool with_sources, SymbolCallback on_symbol,
+                const MergeLimit& limit = MergeLimit(), Position first_symbol = 0);
+
+    // Next input symbol; throws std::runtime_error if a merge leaves no valid path
+    void push(Symbol symbol);
+    void finish();  // End of input: collapses the last window and flushes
+
+    // Redirect the output (a copied builder still reports to the original's callback)
+    void set_callback(SymbolCallback on_symbol) { on_symbol_ = std::move(on_symbol); }
+    // Also report each output symbol before common blocks are folded, after the
+    // callback has seen it (which must then leave degenerate symbols in place)
+    void set_forward(SymbolCallback forward) { forward_ = std::move(forward); }
+
+    Position symbols_in() const { return symbols_in_; }
+    Position symbols_out() const { return symbols_out_; }
+    size_t peak_window() const { return peak_window_; }  // Most input items collapsed at once
+    const std::vector<UnmergedWindow>& unmerged() const { return unmerged_; }
+
+    // Concatenations of the alternatives of two adjacent symbols: all distinct
+    // ones, or with sources those whose path sets intersect (empty if none does)
+    static Symbol concatenate(const Symbol& left, const Symbol& right, bool with_sources);
+    // Same into `merged`; false, leaving it partial, once it exceeds a limit
+    static bool concatenate(const Symbol& left, const Symbol& right, bool with_sources,
+                            const MergeLimit& limit, Symbol& merged);
+
+private:
+    void push_item(Symbol symbol);   // Input with adjacent common symbols folded
+    void collapse_window();
+    void emit(Symbol symbol);        // Output, adjacent common symbols folded
+    Symbol merge(const Symbol& left, const Symbol& right) const {
+        return concatenate(left, right, with_sources_);
+    }
+
+    Length context_length_;
+    bool with_sources_;
+    SymbolCallback on_symbol_;
+    SymbolCallback forward_;
+    MergeLimit limit_;
+    Position first_symbol_;
+    std::vector<UnmergedWindow> unmerged_;
+    bool finished_ = false;
+
+    Position symbols_in_ = 0;
+    Position symbols_out_ = 0;
+    size_t peak_window_ = 0;
+
+    // Common run being folded (input side), starting at input symbol common_first_
+    bool has_common_ = false;
+    Symbol common_;
+    Position common_first_ = 0;
+
+    // Items since the last anchor, starting at input symbol window_first_
+    bool seen_item_ = false;
+    std::vector<Symbol> window_;
+    Position window_first_ = 0;
+    Position window_last_ = 0;
+    Position item_first_ = 0;  // Input symbols spanned by the item being pushed
+    Position item_last_ = 0;
+
+    // Common block held back for folding (output side)
+    bool has_output_common_ = false;
+    Symbol output_common_;
+};
+
+} // namespace edsparser
+
+#endif // EDSPARSER_TRANSFORMS_LEDS_BUILDER_HPP
@@ -0,0 +1,544 @@
+#include "leds_profile.hpp"
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace edsparser {
+
+namespace {
+    constexpr uint64_t SATURATED = std::numeric_limits<uint64_t>::max();
+    constexpr size_t PROFILE_BLOCK = size_t(1) << 16;  // Symbols read before the lengths replay them
+
+    // Transform memory besides the symbols: read chunk and the two write buffers
+    constexpr uint64_t IO_BYTES = (uint64_t(1) << 20) + 2 * (uint64_t(1) << 16);
+
+    uint64_t add(uint64_t a, uint64_t b) { return a > SATURATED - b ? SATURATED : a + b; }
+    uint64_t mul(uint64_t a, uint64_t b) { return a != 0 && b > SATURATED / a ? SATURATED : a * b; }
+
+    /**
+     * A symbol as the replay sees it: totals, and with sources the length and
+     * path IDs of every string (all a linear merge looks at)
+     */
+    struct Block {
+        uint64_t count = 0;
+        uint64_t chars = 0;
+        uint64_t path_ids = 0;
+        std::vector<uint64_t> lengths;             // With sources only
+        std::vector<std::vector<int32_t>> paths;   // With sources only
+
+        bool common() const { return count == 1; }
+
+        // Footprint of the symbol as a LedsBuilder::Symbol
+        uint64_t bytes() const {
+            uint64_t total = add(chars, mul(count, sizeof(std::string)));
+            if (!paths.empty()) {
+                total = add(total, add(mul(count, sizeof(std::vector<int32_t>)), mul(path_ids, sizeof(int32_t))));
+            }
+            return total;
+        }
+    };
+
+    // Path sets are sorted; a set containing 0 is universal (as in LedsBuilder)
+    bool is_universal(const std::vector<int32_t>& paths) { return !paths.empty() && paths[0] == 0; }
+
+    std::vector<int32_t> intersect_paths(const std::vector<int32_t>& a, const std::vector<int32_t>& b) {
+        if (is_universal(a)) {
+            return is_universal(b) ? std::vector<int32_t>{0} : b;
+        }
+        if (is_universal(b)) {
+            return a;
+        }
+        std::vector<int32_t> result;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        return result;
+    }
+
+    // LedsBuilder::concatenate on blocks (cartesian counted without deduplication)
+    Block concatenate(const Block& left, const Block& right, bool with_sources) {
+        Block merged;
+        if (!with_sources) {
+            merged.count = mul(left.count, right.count);
+            merged.chars = add(mul(left.chars, right.count), mul(right.chars, left.count));
+            return merged;
+        }
+        for (size_t i = 0; i < left.lengths.size(); i++) {
+            for (size_t j = 0; j < right.lengths.size(); j++) {
+                std::vector<int32_t> paths = intersect_paths(left.paths[i], right.paths[j]);
+                if (!paths.empty()) {
+                    merged.count++;
+                    merged.lengths.push_back(left.lengths[i] + right.lengths[j]);
+                    merged.chars = add(merged.chars, merged.lengths.back());
+                    merged.path_ids += paths.size();
+                    merged.paths.push_back(std::move(paths));
+                }
+            }
+        }
+        return merged;
+    }
+
+    /**
+     * LedsBuilder for one context length, counting the symbols it would emit
+     * instead of building them. The first error stops the replay.
+     */
+    class Replay {
+    public:
+        Replay(Length context_length, bool with_sources) : with_sources_(with_sources) {
+            profile_.context_length = context_length;
+        }
+
+        void push(const Block& symbol, Position index) {
+            if (!profile_.error.empty()) {
+                return;
+            }
+            if (symbol.common()) {
+                if (has_common_) {
+                    common_ = concatenate(common_, symbol, with_sources_);
+                    if (common_.count == 0) {
+                        fail("Common blocks at symbols " + std::to_string(common_first_) +
+                             " to " + std::to_string(index) + " share no path");
+                    }
+                } else {
+                    common_ = symbol;
+                    common_first_ = index;
+                    has_common_ = true;
+                }
+                return;
+            }
+
+            if (has_common_) {
+                has_common_ = false;
+                item_first_ = common_first_;
+                item_last_ = index - 1;
+                push_item(std::move(common_));
+            }
+            item_first_ = item_last_ = index;
+            push_item(symbol);
+        }
+
+        LedsProfile finish(Position length) {
+            if (!profile_.error.empty()) {
+                return profile_;
+            }
+            if (has_common_) {
+                has_common_ = false;
+                item_first_ = common_first_;
+                item_last_ = length - 1;
+                push_item(std::move(common_));
+            }
+            if (!window_.empty() && window_.back().common()) {
+                Block tail = std::move(window_.back());
+                window_.pop_back();
+                window_bytes_ -= std::min(window_bytes_, tail.bytes());
+                collapse_window();
+                emit(std::move(tail));
+            } else {
+                collapse_window();
+            }
+            if (has_output_common_) {
+                has_output_common_ = false;
+                count_output(output_common_);
+            }
+            profile_.memory_bytes = add(IO_BYTES, peak_bytes_);
+            return profile_;
+        }
+
+    private:
+        void fail(std::string message) {
+            profile_.error = std::move(message);
+            window_.clear();
+        }
+
+        void push_item(Block item) {
+            if (!profile_.error.empty()) {
+                return;
+            }
+            bool first_item = !seen_item_;
+            seen_item_ = true;
+
+            if (item.common() && (first_item || item.chars >= profile_.context_length)) {
+                collapse_window();
+                emit(std::move(item));
+                return;
+            }
+
+            if (window_.empty()) {
+                window_first_ = item_first_;
+            }
+            window_last_ = item_last_;
+            window_bytes_ = add(window_bytes_, item.bytes());
+            peak_bytes_ = std::max(peak_bytes_, window_bytes_);
+            window_.push_back(std::move(item));
+        }
+
+        void collapse_window() {
+            if (window_.empty() || !profile_.error.empty()) {
+                return;
+            }
+            profile_.peak_window = std::max<uint64_t>(profile_.peak_window, window_.size());
+
+            // The window's input symbols stay alive while each step holds its two operands
+            Block merged = std::move(window_[0]);
+            for (size_t k = 1; k < window_.size(); k++) {
+                Block next = concatenate(merged, window_[k], with_sources_);
+                peak_bytes_ = std::max(peak_bytes_, add(window_bytes_, add(merged.bytes(), next.bytes())));
+                merged = std::move(next);
+                if (merged.count == 0) {
+                    fail("Merging symbols " + std::to_string(window_first_) + " to " +
+                         std::to_string(window_last_) + " results in empty set "
+                         "(no valid source intersections)");
+                    return;
+                }
+            }
+            window_.clear();
+            window_bytes_ = 0;
+            emit(std::move(merged));
+        }
+
+        void emit(Block symbol) {
+            if (!profile_.error.empty()) {
+                return;
+            }
+            if (symbol.common()) {
+                if (has_output_common_) {
+                    output_common_ = concatenate(output_common_, symbol, with_sources_);
+                    if (output_common_.count == 0) {
+                        fail("Common blocks around symbol " + std::to_string(item_first_) + " share no path");
+                    }
+                } else {
+                    output_common_ = std::move(symbol);
+                    has_output_common_ = true;
+                }
+                peak_bytes_ = std::max(peak_bytes_, add(window_bytes_, output_common_.bytes()));
+                return;
+            }
+            if (has_output_common_) {
+                has_output_common_ = false;
+                count_output(output_common_);
+            }
+            count_output(symbol);
+        }
+
+        void count_output(const Block& symbol) {
+            profile_.n = add(profile_.n, 1);
+            profile_.N = add(profile_.N, symbol.chars);
+            profile_.m = add(profile_.m, symbol.count);
+            profile_.peak_cardinality = std::max(profile_.peak_cardinality, symbol.count);
+        }
+
+        bool with_sources_;
+        LedsProfile profile_;
+        uint64_t peak_bytes_ = 0;
+
+        bool has_common_ = false;
+        Block common_;
+        Position common_first_ = 0;
+
+        bool seen_item_ = false;
+        std::vector<Block> window_;
+        uint64_t window_bytes_ = 0;
+        Position window_first_ = 0;
+        Position window_last_ = 0;
+        Position item_first_ = 0;
+        Position item_last_ = 0;
+
+        bool has_output_common_ = false;
+        Block output_common_;
+    };
+
+    // Symbol `pos` as a block; string_id is the global ID of its first string and is advanced past it
+    Block read_block(const EDS& eds, Position pos, size_t& string_id, bool with_sources) {
+        Block symbol;
+        symbol.count = eds.get_symbol_size(pos);
+        for (uint64_t k = 0; k < symbol.count; k++, string_id++) {
+            Length length = eds.get_string_length(string_id);
+            symbol.chars += length;
+            if (with_sources) {
+                symbol.lengths.push_back(length);
+                symbol.paths.push_back(eds.get_string_sources(string_id));
+                symbol.path_ids += symbol.paths.back().size();
+            }
+        }
+        return symbol;
+    }
+
+    /**
+     * Forward pass of plan_leds. The input is folded into anchors and windows
+     * as LedsBuilder does; when an anchor closes, the cheapest plan keeping it
+     * is chosen among those keeping one of the max_absorbed + 1 anchors before
+     * it, the group in between merged by extending it leftwards. Only the last
+     * anchors and windows are held, plus a few words per anchor for backtracking.
+     */
+    class Planner {
+    public:
+        Planner(Length context_length, bool with_sources, PlanCost cost, size_t max_absorbed)
+            : context_length_(context_length), with_sources_(with_sources), cost_(cost),
+              max_absorbed_(max_absorbed) {
+            anchors_.push_back({0, 0, 0, 0, 0});  // Virtual anchor before the input
+        }
+
+        void push(const Block& symbol, Position index) {
+            if (symbol.common()) {
+                if (has_common_) {
+                    common_ = concatenate(common_, symbol, with_sources_);
+                    if (common_.count == 0) {
+                        throw std::runtime_error("Common blocks at symbols " + std::to_string(common_first_) +
+                                                 " to " + std::to_string(index) + " share no path");
+                    }
+                } else {
+                    common_ = symbol;
+                    common_first_ = index;
+                    has_common_ = true;
+                }
+                return;
+            }
+            if (has_common_) {
+                has_common_ = false;
+                push_item(std::move(common_), common_first_, index - 1);
+            }
+            push_item(symbol, index, index);
+        }
+
+        LedsPlan finish(Position length) {
+            if (has_common_) {
+                has_common_ = false;
+                push_item(std::move(common_), common_first_, length - 1);
+            }
+            // A short common block at the end is the last symbol, an anchor
+            if (has_window_ && has_tail_) {
+                Block tail = std::move(window_);
+                window_ = std::move(before_tail_);
+                window_last_ = tail_first_ - 1;
+                close_anchor(tail, tail_first_, length);
+            }
+            close_anchor(Block(), length, length);  // Virtual anchor after the input
+
+            LedsPlan plan;
+            plan.context_length = context_length_;
+            plan.cost = anchors_.back().best;
+            plan.greedy_cost = greedy_cost_;
+
+            std::vector<size_t> kept;
+            for (size_t j = anchors_.size() - 1; j > 0; j = anchors_[j].prev) {
+                kept.push_back(j);
+            }
+            size_t i = 0;
+            for (auto it = kept.rbegin(); it != kept.rend(); ++it) {
+                const Anchor& left = anchors_[i];
+                const Anchor& right = anchors_[*it];
+                if (right.first > left.end) {
+                    plan.group_starts.push_back(left.end);
+                }
+                if (right.end > right.first) {
+                    plan.group_starts.push_back(right.first);
+                }
+                i = *it;
+            }
+            return plan;
+        }
+
+    private:
+        struct Anchor {
+            Position first;  // Input symbols [first, end)
+            Position end;
+            uint64_t cost;   // As a symbol of its own
+            uint64_t best;   // Cheapest plan of the input before `end` keeping this anchor
+            size_t prev;     // Kept anchor before it in that plan
+        };
+
+        uint64_t cost(const Block& block) const {
+            return cost_ == PlanCost::STRINGS ? block.count : block.chars;
+        }
+
+        void push_item(Block item, Position first, Position last) {
+            bool first_item = !seen_item_;
+            seen_item_ = true;
+            if (item.common() && (first_item || item.chars >= context_length_)) {
+                close_anchor(item, first, last + 1);
+                return;
+            }
+
+            has_tail_ = has_window_ && item.common();
+            if (!has_window_) {
+                has_window_ = true;
+                window_first_ = first;
+                window_ = std::move(item);
+            } else if (has_tail_) {
+                before_tail_ = std::move(window_);
+                tail_first_ = first;
+                window_ = concatenate(before_tail_, item, with_sources_);
+            } else {
+                window_ = concatenate(window_, item, with_sources_);
+            }
+            window_last_ = last;
+        }
+
+        // Close the window before this anchor, then find the cheapest plan keeping it
+        void close_anchor(const Block& anchor, Position first, Position end) {
+            if (has_window_ && window_.count == 0) {
+                throw std::runtime_error(
+                    "Merging symbols " + std::to_string(window_first_) + " to " +
+                    std::to_string(window_last_) + " results in empty set "
+                    "(no valid source intersections)");
+            }
+            windows_.push_back({has_window_, std::move(window_)});
+            if (has_window_) {
+                greedy_cost_ = add(greedy_cost_, cost(windows_.back().second));
+            }
+            has_window_ = false;
+            has_tail_ = false;
+            window_ = Block();
+
+            bool virtual_end = end == first;
+            Anchor next{first, end, virtual_end ? 0 : cost(anchor), SATURATED, anchors_.size() - 1};
+            greedy_cost_ = add(greedy_cost_, next.cost);
+
+            // Group before the anchor: window i, anchor i + 1, ..., window j - 1
+            size_t j = anchors_.size();
+            size_t base = j - windows_.size();  // Anchor index of windows_[0] (the anchor it follows)
+            Block group;
+            bool has_group = false;
+            uint64_t apart = 0;  // The group's windows and anchors as symbols of their own
+            for (size_t i = j - 1; ; i--) {
+                const auto& window = windows_[i - base];
+                if (window.first) {
+                    group = has_group ? concatenate(window.second, group, with_sources_) : window.second;
+                    has_group = true;
+                    apart = add(apart, cost(window.second));
+                }
+                if (has_group && (group.count == 0 || cost(group) > apart)) {
+                    break;
+                }
+                uint64_t total = add(anchors_[i].best, add(has_group ? cost(group) : 0, next.cost));
+                if (total < next.best) {
+                    next.best = total;
+                    next.prev = i;
+                }
+                if (i == 0 || j - 1 - i >= max_absorbed_ || i - 1 < base) {
+                    break;
+                }
+                const Block& absorbed = anchor_blocks_[i - base - 1];
+                group = has_group ? concatenate(absorbed, group, with_sources_) : absorbed;
+                has_group = true;
+                apart = add(apart, anchors_[i].cost);
+            }
+            anchors_.push_back(next);
+            anchor_blocks_.push_back(anchor);
+
+            // Keep the windows and anchors the next groups can reach
+            while (windows_.size() > max_absorbed_ + 1) {
+                windows_.pop_front();
+                anchor_blocks_.pop_front();
+            }
+        }
+
+        Length context_length_;
+        bool with_sources_;
+        PlanCost cost_;
+        size_t max_absorbed_;
+        uint64_t greedy_cost_ = 0;
+
+        bool has_common_ = false;
+        Block common_;
+        Position common_first_ = 0;
+
+        // Window being merged; before_tail_ is the merge without its last item
+        // while that item is a common block (the tail, if the input ends there)
+        bool seen_item_ = false;
+        bool has_window_ = false;
+        bool has_tail_ = false;
+        Block window_;
+        Block before_tail_;
+        Position window_first_ = 0;
+        Position window_last_ = 0;
+        Position tail_first_ = 0;
+
+        std::vector<Anchor> anchors_;
+        std::deque<std::pair<bool, Block>> windows_;  // Window before each recent anchor, if any
+        std::deque<Block> anchor_blocks_;             // Recent real anchors (after windows_[k] comes anchor_blocks_[k])
+    };
+
+    // Run `f(replay)` for every replay, concurrently; rethrows the first failure
+    template <typename F>
+    void for_each_replay(std::vector<Replay>& replays, size_t threads, F f) {
+        std::vector<std::exception_ptr> errors(replays.size());
+#ifdef _OPENMP
+        #pragma omp parallel for num_threads(std::max<size_t>(1, threads)) schedule(dynamic, 1)
+#else
+        (void)threads;  // Sequential without OpenMP
+#endif
+        for (size_t r = 0; r < replays.size(); r++) {
+            try {
+                f(r, replays[r]);
+            } catch (...) {
+                errors[r] = std::current_exception();
+            }
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+}
+
+std::vector<LedsProfile> profile_leds(const EDS& eds, Length min_length, Length max_length, size_t threads) {
+    if (min_length == 0 || min_length > max_length) {
+        throw std::invalid_argument("profile_leds: Need 0 < min_length <= max_length (got " +
+                                    std::to_string(min_length) + ", " + std::to_string(max_length) + ")");
+    }
+    bool with_sources = eds.has_sources();
+    std::vector<Replay> replays;
+    for (Length l = min_length; ; l++) {
+        replays.emplace_back(l, with_sources);
+        if (l == max_length) {
+            break;
+        }
+    }
+
+    // Read the metadata once, by blocks that every length replays
+    std::vector<Block> block;
+    block.reserve(std::min<size_t>(PROFILE_BLOCK, eds.length()));
+    Position block_first = 0;
+    size_t string_id = 0;
+    for (Position pos = 0; pos < eds.length(); pos++) {
+        block.push_back(read_block(eds, pos, string_id, with_sources));
+
+        if (block.size() == PROFILE_BLOCK || pos + 1 == eds.length()) {
+            for_each_replay(replays, threads, [&](size_t, Replay& replay) {
+                for (size_t i = 0; i < block.size(); i++) {
+                    replay.push(block[i], block_first + i);
+                }
+            });
+            block_first += block.size();
+            block.clear();
+        }
+    }
+
+    std::vector<LedsProfile> profiles(replays.size());
+    for_each_replay(replays, threads, [&](size_t r, Replay& replay) {
+        profiles[r] = replay.finish(eds.length());
+    });
+    return profiles;
+}
+
+LedsPlan plan_leds(const EDS& eds, Length context_length, PlanCost cost, size_t max_absorbed) {
+    if (context_length == 0) {
+        throw std::invalid_argument("context_length must be > 0 for l-EDS transformation");
+    }
+    bool with_sources = eds.has_sources();
+    Planner planner(context_length, with_sources, cost, max_absorbed);
+    size_t string_id = 0;
+    for (Position pos = 0; pos < eds.length(); pos++) {
+        planner.push(read_block(eds, pos, string_id, with_sources), pos);
+    }
+    return planner.finish(eds.length());
+}
+
+} // namespace edsparser
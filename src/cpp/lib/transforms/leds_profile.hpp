@@ -0,0 +1,82 @@
+#ifndef EDSPARSER_TRANSFORMS_LEDS_PROFILE_HPP
+#define EDSPARSER_TRANSFORMS_LEDS_PROFILE_HPP
+
+#include "../common.hpp"
+#include "../formats/eds.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace edsparser {
+
+/**
+ * Predicted outcome of eds_to_leds_linear / eds_to_leds_cartesian for one
+ * context length, computed without the strings: the windows of LedsBuilder are
+ * replayed on symbol sizes, string lengths and, if loaded, the sources.
+ *
+ * With sources the counts are exact (linear merges are replayed on the path
+ * sets). Without, every cartesian merge is counted as the full product, an
+ * upper bound when concatenations repeat. Counts saturate at UINT64_MAX.
+ */
+struct LedsProfile {
+    Length context_length = 0;
+    uint64_t n = 0;                 // Symbols of the l-EDS
+    uint64_t N = 0;                 // Characters
+    uint64_t m = 0;                 // Strings
+    uint64_t peak_cardinality = 0;  // Strings of the largest l-EDS symbol
+    uint64_t peak_window = 0;       // Input symbols collapsed by the largest merge
+    uint64_t memory_bytes = 0;      // Estimated peak memory of a single-threaded transform
+    std::string error;              // Error the transform would stop with (empty if none)
+};
+
+/**
+ * Profile every context length in [min_length, max_length] in one pass over
+ * the metadata (both storage modes, sources in memory or read on demand);
+ * the lengths are replayed concurrently on `threads` threads.
+ *
+ * Throws std::invalid_argument if min_length is 0 or exceeds max_length
+ */
+std::vector<LedsProfile> profile_leds(const EDS& eds, Length min_length, Length max_length, size_t threads = 1);
+
+// What plan_leds minimizes over the output symbols
+enum class PlanCost {
+    STRINGS,     // Σ |symbol| (cardinality m)
+    CHARACTERS   // Σ characters (size N)
+};
+
+/**
+ * Grouping of the input symbols into l-EDS symbols: output symbol k merges
+ * input symbols [group_starts[k], group_starts[k + 1]) (the last one runs to
+ * the end of the input). Run by eds_to_leds_planned.
+ */
+struct LedsPlan {
+    Length context_length = 0;
+    std::vector<Position> group_starts;
+    uint64_t cost = 0;         // Predicted cost of the plan
+    uint64_t greedy_cost = 0;  // Same for the streaming transform (every window merged apart)
+};
+
+/**
+ * Merge plan minimizing `cost`, chosen by dynamic programming over the metadata
+ *
+ * The streaming transform keeps every common block of length >= l (anchor) as
+ * a symbol and merges each window between two anchors. Any l-EDS built by
+ * merging adjacent symbols has that form for a subset of the anchors, since
+ * the others must be merged with the windows around them: merging a window
+ * of two variants with an anchor and the next window of two variants, say,
+ * leaves 4 strings instead of 5, and with sources often fewer. The planner
+ * picks the kept anchors over the replayed costs (as profile_leds counts
+ * them), absorbing at most `max_absorbed` consecutive anchors into a symbol;
+ * a merge is not extended further once it costs more than its windows and
+ * anchors merged apart. The plan never costs more than greedy_cost.
+ *
+ * Without sources costs count full cartesian products (an upper bound).
+ * Throws std::runtime_error where the transform would fail, and
+ * std::invalid_argument if context_length is 0
+ */
+LedsPlan plan_leds(const EDS& eds, Length context_length, PlanCost cost = PlanCost::STRINGS,
+                   size_t max_absorbed = 4);
+
+} // namespace edsparser
+
+#endif // EDSPARSER_TRANSFORMS_LEDS_PROFILE_HPP
@@ -0,0 +1,75 @@
+#include "leds_view.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace edsparser {
+
+LedsView::LedsView(const EDS& eds, Length context_length)
+    : eds_(eds), context_length_(context_length) {
+    if (context_length == 0) {
+        throw std::invalid_argument("context_length must be > 0 for l-EDS transformation");
+    }
+}
+
+LedsView::iterator::Cursor::Cursor(const LedsView& view)
+    : view(view),
+      builder(view.context_length_, view.eds_.has_sources(), [this](Symbol& symbol) {
+          ready.push_back(std::move(symbol));
+      }) {}
+
+LedsView::iterator::Cursor::Cursor(const Cursor& other)
+    : view(other.view), builder(other.builder), ready(other.ready), index(other.index),
+      next_input(other.next_input), next_string(other.next_string) {
+    builder.set_callback([this](Symbol& symbol) { ready.push_back(std::move(symbol)); });
+}
+
+void LedsView::iterator::Cursor::fill() {
+    const EDS& eds = view.eds_;
+    while (ready.empty() && next_input < eds.length()) {
+        Symbol symbol;
+        symbol.strings = eds.symbol_view(next_input).to_set();
+        if (eds.has_sources()) {
+            symbol.sources.reserve(symbol.strings.size());
+            for (size_t k = 0; k < symbol.strings.size(); k++) {
+                symbol.sources.push_back(eds.get_string_sources(next_string + k));
+            }
+        }
+        next_string += symbol.strings.size();
+        next_input++;
+        builder.push(std::move(symbol));
+    }
+    if (ready.empty()) {
+        builder.finish();
+    }
+}
+
+LedsView::iterator::iterator(const LedsView& view) : cursor_(std::make_unique<Cursor>(view)) {
+    cursor_->fill();
+    if (cursor_->ready.empty()) {
+        cursor_.reset();
+    }
+}
+
+LedsView::iterator::iterator(const iterator& other)
+    : cursor_(other.cursor_ ? std::make_unique<Cursor>(*other.cursor_) : nullptr) {}
+
+LedsView::iterator& LedsView::iterator::operator=(const iterator& other) {
+    if (this != &other) {
+        cursor_ = other.cursor_ ? std::make_unique<Cursor>(*other.cursor_) : nullptr;
+    }
+    return *this;
+}
+
+LedsView::iterator::~iterator() = default;
+
+LedsView::iterator& LedsView::iterator::operator++() {
+    cursor_->ready.pop_front();
+    cursor_->index++;
+    cursor_->fill();
+    if (cursor_->ready.empty()) {
+        cursor_.reset();
+    }
+    return *this;
+}
+
+} // namespace edsparser
@@ -0,0 +1,101 @@
+#ifndef EDSPARSER_TRANSFORMS_LEDS_VIEW_HPP
+#define EDSPARSER_TRANSFORMS_LEDS_VIEW_HPP
+
+#include "../common.hpp"
+#include "../formats/eds.hpp"
+#include "leds_builder.hpp"
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <memory>
+
+namespace edsparser {
+
+/**
+ * Lazy l-EDS of a loaded EDS, as a forward range of LedsBuilder::Symbol
+ *
+ * Nothing is materialized: iterating reads the EDS symbols one by one (in
+ * both storage modes) and runs them through a LedsBuilder, so each merged
+ * window is computed when the iterator reaches it and memory is bounded by one
+ * window. Merging is LINEAR when the EDS has sources (each symbol then carries
+ * its path sets) and CARTESIAN otherwise; the symbols are those that
+ * eds_to_leds_linear / eds_to_leds_cartesian would write.
+ *
+ * Copies of an iterator advance independently (each holds its own window).
+ * A merge that leaves no valid path throws std::runtime_error from begin() or
+ * operator++. The EDS must outlive the view and its iterators.
+ */
+class LedsView {
+public:
+    using Symbol = LedsBuilder::Symbol;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Symbol;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Symbol*;
+        using reference = const Symbol&;
+
+        iterator() = default;
+        iterator(const iterator& other);
+        iterator(iterator&& other) noexcept = default;
+        iterator& operator=(const iterator& other);
+        iterator& operator=(iterator&& other) noexcept = default;
+        ~iterator();
+
+        const Symbol& operator*() const { return cursor_->ready.front(); }
+        const Symbol* operator->() const { return &cursor_->ready.front(); }
+
+        iterator& operator++();
+        iterator operator++(int) {
+            iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        // Iterators of the same view are equal at the same l-EDS symbol
+        bool operator==(const iterator& other) const {
+            return cursor_ == nullptr ? other.cursor_ == nullptr
+                                      : other.cursor_ != nullptr && cursor_->index == other.cursor_->index;
+        }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class LedsView;
+        explicit iterator(const LedsView& view);
+
+        // Builder state between two output symbols (null at the end)
+        struct Cursor {
+            Cursor(const LedsView& view);
+            Cursor(const Cursor& other);
+            void fill();  // Push input until an output symbol is ready or the input ends
+
+            const LedsView& view;
+            LedsBuilder builder;
+            std::deque<Symbol> ready;  // Output symbols not yet passed (front is current)
+            Position index = 0;        // l-EDS position of ready.front()
+            Position next_input = 0;   // Next EDS symbol to push
+            size_t next_string = 0;    // Global ID of its first string
+        };
+        std::unique_ptr<Cursor> cursor_;
+    };
+    using const_iterator = iterator;
+
+    // Throws std::invalid_argument if context_length is 0
+    LedsView(const EDS& eds, Length context_length);
+
+    iterator begin() const { return iterator(*this); }
+    iterator end() const { return iterator(); }
+
+    const EDS& eds() const { return eds_; }
+    Length context_length() const { return context_length_; }
+
+private:
+    const EDS& eds_;
+    Length context_length_;
+};
+
+} // namespace edsparser
+
+#endif // EDSPARSER_TRANSFORMS_LEDS_VIEW_HPP
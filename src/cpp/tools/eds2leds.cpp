@@ -5,10 +5,54 @@
 #include <fstream>
 #include <iomanip>
 #include <filesystem>
+#include <algorithm>
+#include <memory>
+#include <sstream>
 
 namespace po = boost::program_options;
 using namespace edsparser;
 
+// Parse "3,5,10" into sorted distinct context lengths
+std::vector<Length> parse_lengths(const std::string& list) {
+    std::vector<Length> lengths;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t used = 0;
+        unsigned long value = 0;
+        try {
+            value = std::stoul(item, &used);
+        } catch (const std::logic_error&) {
+            used = 0;
+        }
+        if (used == 0 || used != item.size() || value == 0) {
+            throw std::invalid_argument("--lengths expects positive context lengths like 3,5,10, got '" + list + "'");
+        }
+        lengths.push_back(static_cast<Length>(value));
+    }
+    if (lengths.empty()) {
+        throw std::invalid_argument("--lengths expects positive context lengths like 3,5,10, got '" + list + "'");
+    }
+    std::sort(lengths.begin(), lengths.end());
+    lengths.erase(std::unique(lengths.begin(), lengths.end()), lengths.end());
+    return lengths;
+}
+
+// Warn about windows left unmerged by --on-limit keep (they break the l-EDS property locally)
+void report_unmerged(const std::vector<UnmergedWindow>& unmerged, const std::string& what) {
+    if (unmerged.empty()) {
+        return;
+    }
+    std::cerr << "Warning: " << unmerged.size() << " window(s) " << what
+              << "exceeded the merge limit and were left unmerged:\n";
+    for (size_t i = 0; i < unmerged.size() && i < 10; i++) {
+        std::cerr << "  symbols " << unmerged[i].first << " to " << unmerged[i].last << "\n";
+    }
+    if (unmerged.size() > 10) {
+        std::cerr << "  ... and " << unmerged.size() - 10 << " more\n";
+    }
+}
+
 int main(int argc, char** argv) {
     // Start performance tracking
     Timer timer;
@@ -30,20 +74,31 @@ int main(int argc, char** argv) {
         std::filesystem::path input_file;
         std::filesystem::path output_file;
         std::filesystem::path sources_file;
-        Length context_length;
+        Length context_length = 0;
+        std::string lengths_list;
         int num_threads;
         bool compact_mode = true;  // Default to compact format
         bool full_mode = false;
+        edsparser::MergeLimit limit;
+        std::string on_limit;
+        std::string plan_mode;
+        std::string plan_cost_name;
 
         po::options_description desc("Transform EDS to l-EDS (length-constrained EDS)");
         desc.add_options()
             ("help,h", "Show help message")
-            ("input,i", po::value<std::filesystem::path>(&input_file)->required(), "Input EDS file (.eds)")
+            ("input,i", po::value<std::filesystem::path>(&input_file)->required(), "Input EDS file (.eds or binary .edz)")
             ("output,o", po::value<std::filesystem::path>(&output_file), "Output l-EDS file (default: <input>_l<N>.leds)")
-            ("context-length,l", po::value<Length>(&context_length)->required(), "Minimum context length")
+            ("context-length,l", po::value<Length>(&context_length), "Minimum context length")
+            ("lengths", po::value<std::string>(&lengths_list), "Several context lengths (e.g. 3,5,10,15,20), built in one pass; each output is that of -l N")
             ("sources,s", po::value<std::filesystem::path>(&sources_file), "Input source file (.seds) for linear (phasing-aware) merging")
             ("full", po::bool_switch(&full_mode), "Use full output format with brackets on all symbols (default: compact)")
-            ("threads,t", po::value<int>(&num_threads)->default_value(1), "Number of threads for parallel processing");
+            ("threads,t", po::value<int>(&num_threads)->default_value(1), "Number of threads for parallel processing")
+            ("max-strings", po::value<size_t>(&limit.max_strings)->default_value(0), "Max strings in a merged symbol (0: no limit)")
+            ("max-bytes", po::value<size_t>(&limit.max_bytes)->default_value(0), "Max characters in a merged symbol (0: no limit)")
+            ("on-limit", po::value<std::string>(&on_limit)->default_value("fail"), "When a merge exceeds the limit: fail, or keep (leave it unmerged)")
+            ("plan", po::value<std::string>(&plan_mode)->default_value("greedy"), "Merge plan: greedy (streaming) or dp (smallest output, loads the metadata)")
+            ("plan-cost", po::value<std::string>(&plan_cost_name)->default_value("strings"), "What --plan dp minimizes: strings or chars");
 
         po::variables_map vm;
         po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -65,6 +120,17 @@ int main(int argc, char** argv) {
             std::cout << "    - All-combinations merging (cross-product of alternatives)\n";
             std::cout << "    - Automatically used when no source file is provided\n";
             std::cout << "    - Use for: Unknown phasing or when all combinations needed\n\n";
+            std::cout << "MERGE LIMIT:\n";
+            std::cout << "  --max-strings/--max-bytes cap every merged symbol; a merge is stopped as\n";
+            std::cout << "  soon as it exceeds the cap. --on-limit fail aborts with the offending\n";
+            std::cout << "  symbols, --on-limit keep writes them unmerged and lists them.\n\n";
+            std::cout << "MERGE PLAN:\n";
+            std::cout << "  greedy (default): stream the input and merge every window between two\n";
+            std::cout << "  common blocks of length >= l on its own.\n";
+            std::cout << "  dp: load the metadata and choose by dynamic programming which of those\n";
+            std::cout << "  blocks to merge into their neighbours, minimizing the total strings\n";
+            std::cout << "  (--plan-cost strings) or characters (--plan-cost chars) of the output.\n";
+            std::cout << "  Runs sequentially; not combined with --lengths or a merge limit.\n\n";
             std::cout << "OUTPUT MODES:\n";
             std::cout << "  Default (compact): Omit brackets on non-degenerate symbols: ACGT{A,ACA}CGT\n";
             std::cout << "  --full: Use brackets on all symbols: {ACGT}{A,ACA}{CGT}\n\n";
@@ -77,6 +143,12 @@ int main(int argc, char** argv) {
             std::cout << "  eds2leds -i data.eds -s data.seds -l 5 --full\n\n";
             std::cout << "  # Parallel processing with 4 threads:\n";
             std::cout << "  eds2leds -i data.eds -l 5 --threads 4\n\n";
+            std::cout << "  # Several context lengths from one read of the input (data_l3.leds, ...):\n";
+            std::cout << "  eds2leds -i data.eds -s data.seds --lengths 3,5,10,15,20\n\n";
+            std::cout << "  # Keep dense variant clusters unmerged instead of running out of memory:\n";
+            std::cout << "  eds2leds -i data.eds -l 10 --max-bytes 100000000 --on-limit keep\n\n";
+            std::cout << "  # Fewest output strings (merges through common blocks where it pays):\n";
+            std::cout << "  eds2leds -i data.eds -s data.seds -l 10 --plan dp\n\n";
             std::cout << "  # Custom output path:\n";
             std::cout << "  eds2leds -i data.eds -s data.seds -l 10 -o output.leds\n\n";
             std::cout << "OUTPUT FILES:\n";
@@ -95,8 +167,8 @@ int main(int argc, char** argv) {
         }
 
         // Validate input file extension
-        if (input_file.extension() != ".eds") {
-            std::cerr << "Error: Input file must be an EDS file (.eds)\n";
+        if (input_file.extension() != EXT_EDS && input_file.extension() != EXT_EDZ) {
+            std::cerr << "Error: Input file must be an EDS file (.eds or .edz)\n";
             std::cerr << "Got: " << input_file << "\n";
             print_performance();
             return 1;
@@ -109,7 +181,107 @@ int main(int argc, char** argv) {
             return 1;
         }
 
+        // Validate limit policy
+        if (on_limit == "fail") {
+            limit.policy = edsparser::MergeLimit::Policy::FAIL;
+        } else if (on_limit == "keep") {
+            limit.policy = edsparser::MergeLimit::Policy::KEEP_UNMERGED;
+        } else {
+            std::cerr << "Error: --on-limit must be 'fail' or 'keep'\n";
+            print_performance();
+            return 1;
+        }
+
+        // Validate merge plan
+        edsparser::PlanCost plan_cost = edsparser::PlanCost::STRINGS;
+        if (plan_cost_name == "chars") {
+            plan_cost = edsparser::PlanCost::CHARACTERS;
+        } else if (plan_cost_name != "strings") {
+            std::cerr << "Error: --plan-cost must be 'strings' or 'chars'\n";
+            print_performance();
+            return 1;
+        }
+        if (plan_mode != "greedy" && plan_mode != "dp") {
+            std::cerr << "Error: --plan must be 'greedy' or 'dp'\n";
+            print_performance();
+            return 1;
+        }
+        if (plan_mode == "dp" && (vm.count("lengths") || limit.max_strings > 0 || limit.max_bytes > 0)) {
+            std::cerr << "Error: --plan dp cannot be combined with --lengths, --max-strings or --max-bytes\n";
+            print_performance();
+            return 1;
+        }
+
+        // Several lengths: one pass, each level built from the previous one
+        if (vm.count("lengths")) {
+            if (vm.count("context-length") || vm.count("output")) {
+                std::cerr << "Error: --lengths cannot be combined with -l or -o (outputs are <input>_l<N>.leds)\n";
+                print_performance();
+                return 1;
+            }
+            std::vector<Length> lengths = parse_lengths(lengths_list);
+
+            std::cout << "EDS → l-EDS transformation (" << lengths.size() << " context lengths)\n";
+            std::cout << "  Input: " << input_file << "\n";
+            if (!sources_file.empty()) {
+                std::cout << "  Sources: " << sources_file << "\n";
+            }
+            std::cout << "  Output mode: " << (compact_mode ? "compact" : "full") << "\n";
+            std::cout << "  Threads: " << num_threads << (num_threads == 1 ? " (sequential)" : " (parallel)") << "\n";
+
+            std::ifstream input(input_file, std::ios::binary);
+            if (!input) {
+                throw std::runtime_error("Cannot open input file: " + input_file.string());
+            }
+            std::unique_ptr<std::ifstream> sources_in;
+            if (!sources_file.empty()) {
+                sources_in = std::make_unique<std::ifstream>(sources_file);
+                if (!*sources_in) {
+                    throw std::runtime_error("Cannot open sources file: " + sources_file.string());
+                }
+            }
+
+            std::vector<std::unique_ptr<std::ofstream>> files;
+            std::vector<std::ostream*> outputs;
+            std::vector<std::ostream*> sources_outputs;
+            for (Length l : lengths) {
+                std::filesystem::path path = input_file.parent_path() /
+                    (input_file.stem().string() + "_l" + std::to_string(l) + ".leds");
+                files.push_back(std::make_unique<std::ofstream>(path));
+                if (!*files.back()) {
+                    throw std::runtime_error("Cannot open output file: " + path.string());
+                }
+                outputs.push_back(files.back().get());
+                std::cout << "  Output (l=" << l << "): " << path << "\n";
+
+                if (sources_in) {
+                    path.replace_extension(".seds");
+                    files.push_back(std::make_unique<std::ofstream>(path));
+                    if (!*files.back()) {
+                        throw std::runtime_error("Cannot create output sources file: " + path.string());
+                    }
+                    sources_outputs.push_back(files.back().get());
+                    std::cout << "  Output sources (l=" << l << "): " << path << "\n";
+                }
+            }
+
+            auto unmerged = eds_to_leds_ladder(input, lengths, outputs, sources_in.get(), sources_outputs,
+                                               static_cast<size_t>(num_threads), compact_mode, limit);
+            for (size_t k = 0; k < lengths.size(); k++) {
+                report_unmerged(unmerged[k], "at l=" + std::to_string(lengths[k]) + " ");
+            }
+
+            std::cout << "Transformation complete!\n";
+            print_performance();
+            return 0;
+        }
+
         // Validate context length
+        if (!vm.count("context-length")) {
+            std::cerr << "Error: One of --context-length/-l or --lengths is required\n";
+            print_performance();
+            return 1;
+        }
         if (context_length == 0) {
             std::cerr << "Error: Context length must be > 0\n";
             print_performance();
@@ -131,10 +303,18 @@ int main(int argc, char** argv) {
             std::cout << "  Sources: " << sources_file << "\n";
         }
         std::cout << "  Output mode: " << (compact_mode ? "compact" : "full") << "\n";
-        std::cout << "  Threads: " << num_threads << (num_threads == 1 ? " (sequential)" : " (parallel)") << "\n";
+        if (plan_mode == "dp") {
+            std::cout << "  Merge plan: dp, fewest " << plan_cost_name << " (sequential)\n";
+        } else {
+            std::cout << "  Threads: " << num_threads << (num_threads == 1 ? " (sequential)" : " (parallel)") << "\n";
+        }
+        if (limit.max_strings > 0 || limit.max_bytes > 0) {
+            std::cout << "  Merge limit: " << limit.max_strings << " strings, " << limit.max_bytes
+                      << " bytes (0: none), on limit: " << on_limit << "\n";
+        }
 
         // Open input file
-        std::ifstream input(input_file);
+        std::ifstream input(input_file, std::ios::binary);
         if (!input) {
             throw std::runtime_error("Cannot open input file: " + input_file.string());
         }
@@ -171,27 +351,39 @@ int main(int argc, char** argv) {
             std::cout << "  Output sources: " << output_sources << "\n";
         }
 
+        std::vector<edsparser::UnmergedWindow> unmerged;
         try {
-            // Call library function based on auto-detected method
-            if (!sources_file.empty()) {
+            // Call library function based on the plan and auto-detected method
+            if (plan_mode == "dp") {
+                // Plan the merges over the metadata, then run them
+                EDS eds = sources_file.empty()
+                    ? EDS::load(input_file, EDS::StoringMode::METADATA_ONLY)
+                    : EDS::load(input_file, sources_file, EDS::StoringMode::METADATA_ONLY);
+                edsparser::LedsPlan plan = edsparser::plan_leds(eds, context_length, plan_cost);
+                std::cout << "  Planned " << plan_cost_name << ": " << plan.cost
+                          << " (greedy: " << plan.greedy_cost << ")\n";
+                edsparser::eds_to_leds_planned(eds, output, plan, sources_out, compact_mode);
+            } else if (!sources_file.empty()) {
                 // LINEAR merging: phasing-aware using source information
-                edsparser::eds_to_leds_linear(
+                unmerged = edsparser::eds_to_leds_linear(
                     input,
                     output,
                     context_length,
                     sources_in,
                     sources_out,
                     static_cast<size_t>(num_threads),
-                    compact_mode
+                    compact_mode,
+                    limit
                 );
             } else {
                 // CARTESIAN merging: all combinations
-                edsparser::eds_to_leds_cartesian(
+                unmerged = edsparser::eds_to_leds_cartesian(
                     input,
                     output,
                     context_length,
                     static_cast<size_t>(num_threads),
-                    compact_mode
+                    compact_mode,
+                    limit
                 );
             }
 
@@ -199,6 +391,8 @@ int main(int argc, char** argv) {
             delete sources_in;
             delete sources_out;
 
+            report_unmerged(unmerged, "");
+
             std::cout << "Transformation complete!\n";
             print_performance();
             return 0;
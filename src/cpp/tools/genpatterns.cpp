@@ -35,7 +35,7 @@ int main(int argc, char** argv) {
         po::options_description desc("Generate random patterns from EDS");
         desc.add_options()
             ("help,h", "Show help message")
-            ("input,i", po::value<std::filesystem::path>(&input_file)->required(), "Input EDS file")
+            ("input,i", po::value<std::filesystem::path>(&input_file)->required(), "Input EDS file (.eds or binary .edz)")
             ("output,o", po::value<std::filesystem::path>(&output_file)->required(), "Output pattern file")
             ("count,n", po::value<size_t>(&count)->default_value(100), "Number of patterns")
             ("length,l", po::value<Length>(&length)->default_value(10), "Pattern length");
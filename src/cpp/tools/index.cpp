@@ -0,0 +1,98 @@
+#include "formats/eds.hpp"
+#include "common.hpp"
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <filesystem>
+#include <iomanip>
+#include <vector>
+
+namespace po = boost::program_options;
+using namespace edsparser;
+
+int main(int argc, char** argv) {
+    // Start performance tracking
+    Timer timer;
+    timer.start();
+
+    // Helper to print performance info to stderr
+    auto print_performance = [&timer]() {
+        timer.stop();
+        double runtime = timer.elapsed_seconds();
+        double memory_mb = get_peak_memory_mb();
+        std::cerr << "[Performance] Runtime: " << std::fixed << std::setprecision(2) << runtime << "s";
+        if (memory_mb > 0.0) {
+            std::cerr << " | Peak Memory: " << std::fixed << std::setprecision(1) << memory_mb << " MB";
+        }
+        std::cerr << "\n";
+    };
+
+    try {
+        std::vector<std::filesystem::path> input_files;
+        bool force = false;
+        bool check_only = false;
+
+        po::options_description desc("Build sidecar metadata indexes (<file>.idx) for EDS files");
+        desc.add_options()
+            ("help,h", "Show help message")
+            ("input,i", po::value<std::vector<std::filesystem::path>>(&input_files)->required()->multitoken(), "Input EDS file(s)")
+            ("force,f", po::bool_switch(&force), "Rebuild even if the index is current")
+            ("check,c", po::bool_switch(&check_only), "Only report whether each index is current (exit 1 if any is not)");
+
+        po::positional_options_description positional;
+        positional.add("input", -1);
+
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
+
+        if (vm.count("help")) {
+            std::cout << desc << "\n";
+            std::cout << "Examples:\n";
+            std::cout << "  # Index a file (later METADATA_ONLY loads skip parsing)\n";
+            std::cout << "  edsparser-index -i data.eds\n\n";
+            std::cout << "  # Check which indexes are stale\n";
+            std::cout << "  edsparser-index --check data/*.eds\n\n";
+            std::cout << "Notes:\n";
+            std::cout << "  Indexes are also written automatically by the first METADATA_ONLY load.\n";
+            std::cout << "  An index is ignored once the file's size, mtime or sampled checksum changes.\n";
+            std::cout << "  Binary .edz files load in O(metadata) and need no index.\n";
+            print_performance();
+            return 0;
+        }
+
+        po::notify(vm);
+
+        bool all_current = true;
+        for (const auto& input_file : input_files) {
+            if (!std::filesystem::exists(input_file)) {
+                std::cerr << "Error: Input file does not exist: " << input_file << "\n";
+                print_performance();
+                return 1;
+            }
+
+            bool current = EDS::has_current_index(input_file);
+
+            if (check_only) {
+                std::cout << (current ? "current  " : "stale    ") << input_file.string() << "\n";
+                all_current = all_current && current;
+                continue;
+            }
+
+            if (current && !force) {
+                std::cout << "Up to date: " << input_file.string() << "\n";
+                continue;
+            }
+
+            EDS::build_index(input_file);
+            std::cout << "Indexed: " << input_file.string() << " -> "
+                      << eds_index::sidecar_path(input_file).string() << "\n";
+        }
+
+        print_performance();
+        return all_current ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        print_performance();
+        return 1;
+    }
+}
@@ -1,4 +1,6 @@
 #include "formats/eds.hpp"
+#include "formats/eds_stream.hpp"
+#include "transforms/leds_profile.hpp"
 #include "common.hpp"
 #include <boost/program_options.hpp>
 #include <iostream>
@@ -34,26 +36,11 @@ std::string format_size(uintmax_t bytes) {
     return ss.str();
 }
 
-// Estimate memory usage for FULL mode
-size_t estimate_full_mode_memory(size_t N, size_t m, size_t n) {
-    // Rough estimation:
-    // - String data: N bytes (actual characters)
-    // - String overhead: m * sizeof(std::string) ≈ m * 32 bytes
-    // - StringSet overhead: n * sizeof(std::vector) ≈ n * 24 bytes
-    // - Pointers and bookkeeping: ~20% overhead
-
-    size_t string_data = N;
-    size_t string_overhead = m * 32;
-    size_t vector_overhead = n * 24;
-    size_t bookkeeping = (string_data + string_overhead + vector_overhead) / 5;
-
-    return string_data + string_overhead + vector_overhead + bookkeeping;
-}
-
 // Estimate memory usage for METADATA_ONLY mode
 size_t estimate_metadata_memory(size_t m, size_t n) {
     // Metadata structure:
     // - base_positions: n * sizeof(streampos) ≈ n * 8 bytes
+    // - symbol_byte_lengths: n * sizeof(Length) ≈ n * 4 bytes
     // - symbol_sizes: n * sizeof(Length) ≈ n * 4 bytes
     // - string_lengths: m * sizeof(Length) ≈ m * 4 bytes
     // - cum_set_sizes: n * sizeof(Length) ≈ n * 4 bytes
@@ -62,44 +49,123 @@ size_t estimate_metadata_memory(size_t m, size_t n) {
     // - Overhead: ~10%
 
     size_t base_positions = n * 8;
+    size_t symbol_byte_lengths = n * 4;
     size_t symbol_sizes = n * 4;
     size_t string_lengths = m * 4;
     size_t cum_set_sizes = n * 4;
     size_t is_degenerate = n * 1;
     size_t statistics = 64;
-    size_t total = base_positions + symbol_sizes + string_lengths + cum_set_sizes + is_degenerate + statistics;
+    size_t total = base_positions + symbol_byte_lengths + symbol_sizes + string_lengths + cum_set_sizes + is_degenerate + statistics;
     size_t overhead = total / 10;
 
     return total + overhead;
 }
 
-// Print statistics in standard format
-void print_standard(const EDS& eds, const std::filesystem::path& input_file, bool verbose, bool has_sources_file) {
-    auto stats = eds.get_statistics();
-    auto metadata = eds.get_metadata();
+// Estimate memory usage for FULL mode
+size_t estimate_full_mode_memory(size_t N, size_t m, size_t n) {
+    // Rough estimation (strings live in one contiguous arena):
+    // - String data: N bytes (actual characters)
+    // - String offsets: (m + 1) * sizeof(Position) = (m + 1) * 8 bytes
+    // - Metadata index kept alongside the arena
+    // - Growth slack: ~5% overhead
 
-    // Get file size
-    uintmax_t file_size = std::filesystem::file_size(input_file);
+    size_t string_data = N;
+    size_t string_offsets = (m + 1) * 8;
+    size_t metadata = estimate_metadata_memory(m, n);
+    size_t slack = (string_data + string_offsets) / 20;
+
+    return string_data + string_offsets + metadata + slack;
+}
+
+// Everything the reports show, taken from a loaded EDS or from a streamed input
+struct Summary {
+    std::string path;
+    std::string name;          // File name (or "stdin")
+    uintmax_t file_size;       // Bytes read
+    std::string mode;          // "METADATA_ONLY", "FULL" or "STREAMING"
+    size_t n;
+    size_t N;
+    size_t m;
+    EDS::Statistics stats;
+    bool has_sources;
+    size_t source_strings;
+    size_t stream_buffer_bytes;  // STREAMING only: peak parser buffer
+};
+
+Summary summarize(const EDS& eds, const std::filesystem::path& input_file) {
+    Summary summary;
+    summary.path = input_file.string();
+    summary.name = input_file.filename().string();
+    summary.file_size = std::filesystem::file_size(input_file);
+    summary.mode = eds.get_storing_mode() == EDS::StoringMode::METADATA_ONLY ? "METADATA_ONLY" : "FULL";
+    summary.n = eds.length();
+    summary.N = eds.size();
+    summary.m = eds.cardinality();
+    summary.stats = eds.get_statistics();
+    summary.has_sources = eds.has_sources();
+    summary.source_strings = eds.has_sources() ? eds.cardinality() : 0;  // One set per string
+    summary.stream_buffer_bytes = 0;
+    return summary;
+}
+
+// Parse stdin with the incremental parser: memory stays bounded by the largest symbol
+Summary summarize_stdin() {
+    EDSStreamParser parser([](const StreamedSymbol&) {});
+    std::vector<char> buffer(1 << 16);
+    while (std::cin) {
+        std::cin.read(buffer.data(), buffer.size());
+        parser.feed(buffer.data(), static_cast<size_t>(std::cin.gcount()));
+    }
+    parser.finish();
+
+    Summary summary;
+    summary.path = "-";
+    summary.name = "stdin";
+    summary.file_size = parser.bytes();
+    summary.mode = "STREAMING";
+    summary.n = parser.length();
+    summary.N = parser.size();
+    summary.m = parser.cardinality();
+    summary.stats = parser.get_statistics();
+    summary.has_sources = false;
+    summary.source_strings = 0;
+    summary.stream_buffer_bytes = parser.peak_buffer_bytes();
+    return summary;
+}
+
+// Memory of the current mode (the STREAMING parser only keeps its buffers)
+size_t current_memory(const Summary& summary, size_t metadata_mem, size_t full_mem) {
+    if (summary.mode == "STREAMING") {
+        return summary.stream_buffer_bytes;
+    }
+    return summary.mode == "FULL" ? full_mem : metadata_mem;
+}
+
+// Print statistics in standard format
+void print_standard(const Summary& summary, bool verbose, bool has_sources_file) {
+    const auto& stats = summary.stats;
 
     // Calculate memory estimates
-    size_t metadata_mem = estimate_metadata_memory(eds.cardinality(), eds.length());
-    size_t full_mem = estimate_full_mode_memory(eds.size(), eds.cardinality(), eds.length());
+    size_t metadata_mem = estimate_metadata_memory(summary.m, summary.n);
+    size_t full_mem = estimate_full_mode_memory(summary.N, summary.m, summary.n);
     double reduction_factor = static_cast<double>(full_mem) / static_cast<double>(metadata_mem);
 
     std::cout << "========================================\n";
     std::cout << "EDS Statistics\n";
     std::cout << "========================================\n";
-    std::cout << "File: " << input_file.filename().string() << "\n";
-    std::cout << "Size: " << format_size(file_size) << "\n";
-    std::cout << "Storage Mode: " << (eds.get_storing_mode() == EDS::StoringMode::METADATA_ONLY ? "METADATA_ONLY (memory-efficient)" : "FULL (all data in RAM)") << "\n";
+    std::cout << "File: " << summary.name << "\n";
+    std::cout << "Size: " << format_size(summary.file_size) << "\n";
+    std::cout << "Storage Mode: " << (summary.mode == "METADATA_ONLY" ? "METADATA_ONLY (memory-efficient)"
+                                      : summary.mode == "FULL" ? "FULL (all data in RAM)"
+                                      : "STREAMING (incremental parse, nothing kept)") << "\n";
     std::cout << "\n";
 
     std::cout << "Structure:\n";
-    std::cout << "  Number of symbols (n):        " << std::setw(12) << format_number(eds.length()) << "\n";
-    std::cout << "  Total characters (N):         " << std::setw(12) << format_number(eds.size()) << "\n";
-    std::cout << "  Total strings (m):            " << std::setw(12) << format_number(eds.cardinality()) << "\n";
+    std::cout << "  Number of symbols (n):        " << std::setw(12) << format_number(summary.n) << "\n";
+    std::cout << "  Total characters (N):         " << std::setw(12) << format_number(summary.N) << "\n";
+    std::cout << "  Total strings (m):            " << std::setw(12) << format_number(summary.m) << "\n";
     std::cout << "  Degenerate symbols:           " << std::setw(12) << format_number(stats.num_degenerate_symbols) << "\n";
-    std::cout << "  Regular symbols:              " << std::setw(12) << format_number(eds.length() - stats.num_degenerate_symbols) << "\n";
+    std::cout << "  Regular symbols:              " << std::setw(12) << format_number(summary.n - stats.num_degenerate_symbols) << "\n";
     std::cout << "\n";
 
     std::cout << "Context Lengths (non-degenerate symbols):\n";
@@ -117,17 +183,17 @@ void print_standard(const EDS& eds, const std::filesystem::path& input_file, boo
     if (verbose) {
         std::cout << "Detailed Metrics:\n";
         std::cout << "  Avg strings per symbol:       " << std::setw(12) << std::fixed << std::setprecision(2)
-                  << (static_cast<double>(eds.cardinality()) / eds.length()) << "\n";
+                  << (static_cast<double>(summary.m) / summary.n) << "\n";
         std::cout << "  Avg chars per string:         " << std::setw(12) << std::fixed << std::setprecision(2)
-                  << (static_cast<double>(eds.size()) / eds.cardinality()) << "\n";
+                  << (static_cast<double>(summary.N) / summary.m) << "\n";
         std::cout << "  Degenerate ratio:             " << std::setw(12) << std::fixed << std::setprecision(2)
-                  << (100.0 * stats.num_degenerate_symbols / eds.length()) << " %\n";
+                  << (100.0 * stats.num_degenerate_symbols / summary.n) << " %\n";
         std::cout << "\n";
     }
 
-    if (eds.has_sources()) {
+    if (summary.has_sources) {
         std::cout << "Sources (pangenome paths):\n";
-        std::cout << "  Strings with source info:     " << std::setw(12) << format_number(eds.get_sources().size()) << "\n";
+        std::cout << "  Strings with source info:     " << std::setw(12) << format_number(summary.source_strings) << "\n";
         std::cout << "  Total paths (genomes):        " << std::setw(12) << format_number(stats.num_paths) << "\n";
         std::cout << "  Max paths per string:         " << std::setw(12) << format_number(stats.max_paths_per_string) << "\n";
         std::cout << "  Avg paths per string:         " << std::setw(12) << std::fixed << std::setprecision(2) << stats.avg_paths_per_string << "\n";
@@ -138,9 +204,12 @@ void print_standard(const EDS& eds, const std::filesystem::path& input_file, boo
     }
 
     std::cout << "Memory Usage:\n";
-    std::cout << "  Current (" << (eds.get_storing_mode() == EDS::StoringMode::METADATA_ONLY ? "METADATA_ONLY" : "FULL") << "): "
-              << std::setw(12) << format_size(eds.get_storing_mode() == EDS::StoringMode::METADATA_ONLY ? metadata_mem : full_mem) << "\n";
-    if (eds.get_storing_mode() == EDS::StoringMode::METADATA_ONLY) {
+    std::cout << "  Current (" << summary.mode << "): "
+              << std::setw(12) << format_size(current_memory(summary, metadata_mem, full_mem)) << "\n";
+    if (summary.mode == "STREAMING") {
+        std::cout << "  Estimated METADATA_ONLY mode: " << std::setw(12) << format_size(metadata_mem) << "\n";
+    }
+    if (summary.mode != "FULL") {
         std::cout << "  Estimated FULL mode:          " << std::setw(12) << format_size(full_mem) << "\n";
         std::cout << "  Reduction factor:             " << std::setw(12) << std::fixed << std::setprecision(1) << reduction_factor << "x\n";
     }
@@ -152,7 +221,7 @@ void print_standard(const EDS& eds, const std::filesystem::path& input_file, boo
         std::cout << "  ⚠️  Minimum context length (" << stats.min_context_length << ") < typical l-EDS threshold (5)\n";
         std::cout << "  → Transformation to l-EDS may require merging adjacent symbols\n";
         std::cout << "  → Suggested command:\n";
-        std::cout << "      edsparser-transform -i " << input_file.filename().string() << " -l 5 --method linear\n";
+        std::cout << "      edsparser-transform -i " << summary.name << " -l 5 --method linear\n";
     } else {
         std::cout << "  ✓ Minimum context length (" << stats.min_context_length << ") ≥ 5\n";
         std::cout << "  → Ready for indexing with l ≤ " << stats.min_context_length << "\n";
@@ -162,27 +231,26 @@ void print_standard(const EDS& eds, const std::filesystem::path& input_file, boo
 }
 
 // Print statistics in JSON format
-void print_json(const EDS& eds, const std::filesystem::path& input_file, bool has_sources_file) {
-    auto stats = eds.get_statistics();
-    auto metadata = eds.get_metadata();
-    uintmax_t file_size = std::filesystem::file_size(input_file);
+void print_json(const Summary& summary, bool has_sources_file) {
+    const auto& stats = summary.stats;
 
-    size_t metadata_mem = estimate_metadata_memory(eds.cardinality(), eds.length());
-    size_t full_mem = estimate_full_mode_memory(eds.size(), eds.cardinality(), eds.length());
+    size_t metadata_mem = estimate_metadata_memory(summary.m, summary.n);
+    size_t full_mem = estimate_full_mode_memory(summary.N, summary.m, summary.n);
+    size_t current_mem = current_memory(summary, metadata_mem, full_mem);
     double reduction_factor = static_cast<double>(full_mem) / static_cast<double>(metadata_mem);
 
     std::cout << "{\n";
     std::cout << "  \"file\": {\n";
-    std::cout << "    \"path\": \"" << input_file.string() << "\",\n";
-    std::cout << "    \"size_bytes\": " << file_size << ",\n";
-    std::cout << "    \"storage_mode\": \"" << (eds.get_storing_mode() == EDS::StoringMode::METADATA_ONLY ? "METADATA_ONLY" : "FULL") << "\"\n";
+    std::cout << "    \"path\": \"" << summary.path << "\",\n";
+    std::cout << "    \"size_bytes\": " << summary.file_size << ",\n";
+    std::cout << "    \"storage_mode\": \"" << summary.mode << "\"\n";
     std::cout << "  },\n";
     std::cout << "  \"structure\": {\n";
-    std::cout << "    \"n_symbols\": " << eds.length() << ",\n";
-    std::cout << "    \"N_characters\": " << eds.size() << ",\n";
-    std::cout << "    \"m_strings\": " << eds.cardinality() << ",\n";
+    std::cout << "    \"n_symbols\": " << summary.n << ",\n";
+    std::cout << "    \"N_characters\": " << summary.N << ",\n";
+    std::cout << "    \"m_strings\": " << summary.m << ",\n";
     std::cout << "    \"degenerate_symbols\": " << stats.num_degenerate_symbols << ",\n";
-    std::cout << "    \"regular_symbols\": " << (eds.length() - stats.num_degenerate_symbols) << "\n";
+    std::cout << "    \"regular_symbols\": " << (summary.n - stats.num_degenerate_symbols) << "\n";
     std::cout << "  },\n";
     std::cout << "  \"context_lengths\": {\n";
     std::cout << "    \"min\": " << stats.min_context_length << ",\n";
@@ -195,9 +263,12 @@ void print_json(const EDS& eds, const std::filesystem::path& input_file, bool ha
     std::cout << "    \"empty_strings\": " << stats.num_empty_strings << "\n";
     std::cout << "  },\n";
     std::cout << "  \"memory\": {\n";
-    std::cout << "    \"current_bytes\": " << (eds.get_storing_mode() == EDS::StoringMode::METADATA_ONLY ? metadata_mem : full_mem) << ",\n";
-    std::cout << "    \"current_mb\": " << std::fixed << std::setprecision(1) << ((eds.get_storing_mode() == EDS::StoringMode::METADATA_ONLY ? metadata_mem : full_mem) / 1024.0 / 1024.0) << ",\n";
-    if (eds.get_storing_mode() == EDS::StoringMode::METADATA_ONLY) {
+    std::cout << "    \"current_bytes\": " << current_mem << ",\n";
+    std::cout << "    \"current_mb\": " << std::fixed << std::setprecision(1) << (current_mem / 1024.0 / 1024.0) << ",\n";
+    if (summary.mode == "STREAMING") {
+        std::cout << "    \"estimated_metadata_only_bytes\": " << metadata_mem << ",\n";
+    }
+    if (summary.mode != "FULL") {
         std::cout << "    \"estimated_full_bytes\": " << full_mem << ",\n";
         std::cout << "    \"estimated_full_mb\": " << std::fixed << std::setprecision(1) << (full_mem / 1024.0 / 1024.0) << ",\n";
         std::cout << "    \"reduction_factor\": " << std::fixed << std::setprecision(1) << reduction_factor << "\n";
@@ -206,9 +277,9 @@ void print_json(const EDS& eds, const std::filesystem::path& input_file, bool ha
     }
     std::cout << "  },\n";
     std::cout << "  \"sources\": {\n";
-    std::cout << "    \"loaded\": " << (eds.has_sources() ? "true" : "false") << ",\n";
+    std::cout << "    \"loaded\": " << (summary.has_sources ? "true" : "false") << ",\n";
     std::cout << "    \"file_provided\": " << (has_sources_file ? "true" : "false") << ",\n";
-    if (eds.has_sources()) {
+    if (summary.has_sources) {
         std::cout << "    \"num_paths\": " << stats.num_paths << ",\n";
         std::cout << "    \"max_paths_per_string\": " << stats.max_paths_per_string << ",\n";
         std::cout << "    \"avg_paths_per_string\": " << std::fixed << std::setprecision(2) << stats.avg_paths_per_string << "\n";
@@ -223,12 +294,87 @@ void print_json(const EDS& eds, const std::filesystem::path& input_file, bool ha
     std::cout << "    \"ready_for_indexing\": " << (stats.min_context_length >= 5 ? "true" : "false") << ",\n";
     std::cout << "    \"min_context_length\": " << stats.min_context_length << ",\n";
     std::cout << "    \"suggested_command\": \"" << (stats.min_context_length < 5
-                  ? "edsparser-transform -i " + input_file.filename().string() + " -l 5"
+                  ? "edsparser-transform -i " + summary.name + " -l 5"
                   : "ready for indexing") << "\"\n";
     std::cout << "  }\n";
     std::cout << "}\n";
 }
 
+// Parse an l range "A-B" (or a single "A")
+std::pair<Length, Length> parse_length_range(const std::string& range) {
+    size_t dash = range.find('-');
+    try {
+        size_t used = 0;
+        unsigned long first = std::stoul(range.substr(0, dash), &used);
+        if (used != (dash == std::string::npos ? range.size() : dash)) {
+            throw std::invalid_argument(range);
+        }
+        unsigned long last = first;
+        if (dash != std::string::npos) {
+            last = std::stoul(range.substr(dash + 1), &used);
+            if (used != range.size() - dash - 1) {
+                throw std::invalid_argument(range);
+            }
+        }
+        return {static_cast<Length>(first), static_cast<Length>(last)};
+    } catch (const std::logic_error&) {
+        throw std::invalid_argument("--leds-profile expects a range of context lengths like 3-20, got '" + range + "'");
+    }
+}
+
+// Print the predicted l-EDS for every profiled context length
+void print_leds_profile(const Summary& summary, const std::vector<LedsProfile>& profiles, bool json) {
+    const char* method = summary.has_sources ? "linear" : "cartesian";
+    if (json) {
+        std::cout << "{\n";
+        std::cout << "  \"file\": \"" << summary.path << "\",\n";
+        std::cout << "  \"method\": \"" << method << "\",\n";
+        std::cout << "  \"exact\": " << (summary.has_sources ? "true" : "false") << ",\n";
+        std::cout << "  \"input\": {\"n_symbols\": " << summary.n << ", \"N_characters\": " << summary.N
+                  << ", \"m_strings\": " << summary.m << "},\n";
+        std::cout << "  \"profiles\": [\n";
+        for (size_t i = 0; i < profiles.size(); i++) {
+            const LedsProfile& p = profiles[i];
+            std::cout << "    {\"l\": " << p.context_length;
+            if (p.error.empty()) {
+                std::cout << ", \"n_symbols\": " << p.n << ", \"N_characters\": " << p.N
+                          << ", \"m_strings\": " << p.m << ", \"peak_cardinality\": " << p.peak_cardinality
+                          << ", \"peak_window\": " << p.peak_window << ", \"memory_bytes\": " << p.memory_bytes;
+            } else {
+                std::cout << ", \"error\": \"" << p.error << "\"";
+            }
+            std::cout << "}" << (i + 1 < profiles.size() ? "," : "") << "\n";
+        }
+        std::cout << "  ]\n";
+        std::cout << "}\n";
+        return;
+    }
+
+    std::cout << "========================================\n";
+    std::cout << "l-EDS Profile (" << method << " merging, "
+              << (summary.has_sources ? "exact" : "upper bounds") << ")\n";
+    std::cout << "========================================\n";
+    std::cout << "File: " << summary.name << "\n";
+    std::cout << "Input: n=" << format_number(summary.n) << "  N=" << format_number(summary.N)
+              << "  m=" << format_number(summary.m) << "\n\n";
+    std::cout << std::setw(6) << "l" << std::setw(16) << "n" << std::setw(18) << "N" << std::setw(16) << "m"
+              << std::setw(14) << "peak card." << std::setw(12) << "peak win." << std::setw(12) << "memory" << "\n";
+    for (const LedsProfile& p : profiles) {
+        std::cout << std::setw(6) << p.context_length;
+        if (!p.error.empty()) {
+            std::cout << "  fails: " << p.error << "\n";
+            continue;
+        }
+        std::cout << std::setw(16) << format_number(p.n) << std::setw(18) << format_number(p.N)
+                  << std::setw(16) << format_number(p.m) << std::setw(14) << format_number(p.peak_cardinality)
+                  << std::setw(12) << format_number(p.peak_window) << std::setw(12) << format_size(p.memory_bytes)
+                  << "\n";
+    }
+    std::cout << "\nMemory is for one thread; eds2leds --threads T needs about T times the\n";
+    std::cout << "peak plus T MiB of buffered input.\n";
+    std::cout << "========================================\n";
+}
+
 int main(int argc, char** argv) {
     // Start performance tracking
     Timer timer;
@@ -252,15 +398,20 @@ int main(int argc, char** argv) {
         bool use_full_mode = false;
         bool json_output = false;
         bool verbose = false;
+        int num_threads;
+        std::string profile_range;
 
         po::options_description desc("Display statistics for EDS/l-EDS file");
         desc.add_options()
             ("help,h", "Show help message")
-            ("input,i", po::value<std::filesystem::path>(&input_file)->required(), "Input EDS file")
+            ("input,i", po::value<std::filesystem::path>(&input_file)->required(), "Input EDS file (.eds or binary .edz), '-' streams text EDS from stdin")
             ("sources,s", po::value<std::filesystem::path>(&sources_file), "Source file (.seds) - optional")
             ("full,f", po::bool_switch(&use_full_mode), "Use FULL mode (load all strings)")
             ("json,j", po::bool_switch(&json_output), "Output in JSON format")
-            ("verbose,v", po::bool_switch(&verbose), "Show detailed statistics");
+            ("verbose,v", po::bool_switch(&verbose), "Show detailed statistics")
+            ("threads,t", po::value<int>(&num_threads)->default_value(1), "Number of threads for parsing the input and --leds-profile")
+            ("leds-profile", po::value<std::string>(&profile_range)->implicit_value("1-20"),
+             "Predict the l-EDS for each l in a range (default 1-20) from the metadata");
 
         po::variables_map vm;
         po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -277,16 +428,40 @@ int main(int argc, char** argv) {
             std::cout << "  edsparser-stats -i data.eds --json\n\n";
             std::cout << "  # Use FULL mode (loads all strings, more memory):\n";
             std::cout << "  edsparser-stats -i data.eds --full --verbose\n\n";
+            std::cout << "  # Parse a large file with 8 threads:\n";
+            std::cout << "  edsparser-stats -i data.eds -s data.seds --threads 8\n\n";
+            std::cout << "  # Predict eds2leds output size and memory for l = 3..20:\n";
+            std::cout << "  edsparser-stats -i data.eds -s data.seds --leds-profile 3-20\n\n";
+            std::cout << "  # Stream from a pipe (constant memory):\n";
+            std::cout << "  zcat data.eds.gz | edsparser-stats -i -\n\n";
             std::cout << "Storage Modes:\n";
             std::cout << "  METADATA_ONLY (default): Uses ~10% memory of FULL mode, fast for large files\n";
             std::cout << "                           Sources are loaded as metadata (minimal memory impact)\n";
             std::cout << "  FULL (--full):           Loads all strings into RAM, enables detailed inspection\n";
+            std::cout << "  STREAMING (-i -):        Parses stdin incrementally, keeps only the current symbol\n";
             print_performance();
             return 0;
         }
 
         po::notify(vm);
 
+        // Streaming from stdin: statistics only, nothing is kept
+        if (input_file == "-") {
+            if (vm.count("sources") || use_full_mode || vm.count("leds-profile")) {
+                std::cerr << "Error: --sources, --full and --leds-profile need a file input, not stdin\n";
+                print_performance();
+                return 1;
+            }
+            Summary summary = summarize_stdin();
+            if (json_output) {
+                print_json(summary, false);
+            } else {
+                print_standard(summary, verbose, false);
+            }
+            print_performance();
+            return 0;
+        }
+
         // Check if input file exists
         if (!std::filesystem::exists(input_file)) {
             std::cerr << "Error: Input file '" << input_file << "' not found\n";
@@ -294,6 +469,13 @@ int main(int argc, char** argv) {
             return 1;
         }
 
+        // Validate threads
+        if (num_threads < 1) {
+            std::cerr << "Error: Number of threads must be >= 1\n";
+            print_performance();
+            return 1;
+        }
+
         // Load EDS with appropriate mode
         EDS::StoringMode mode = use_full_mode ? EDS::StoringMode::FULL : EDS::StoringMode::METADATA_ONLY;
 
@@ -305,16 +487,25 @@ int main(int argc, char** argv) {
                 return 1;
             }
             // Load with sources (works in both FULL and METADATA_ONLY modes)
-            eds = EDS::load(input_file, sources_file, mode);
+            eds = EDS::load(input_file, sources_file, mode, 0, static_cast<size_t>(num_threads));
         } else {
-            eds = EDS::load(input_file, mode);
+            eds = EDS::load(input_file, mode, 0, static_cast<size_t>(num_threads));
+        }
+
+        if (vm.count("leds-profile")) {
+            auto [min_length, max_length] = parse_length_range(profile_range);
+            std::vector<LedsProfile> profiles = profile_leds(eds, min_length, max_length,
+                                                             static_cast<size_t>(num_threads));
+            print_leds_profile(summarize(eds, input_file), profiles, json_output);
+            print_performance();
+            return 0;
         }
 
         // Output statistics
         if (json_output) {
-            print_json(eds, input_file, vm.count("sources") > 0);
+            print_json(summarize(eds, input_file), vm.count("sources") > 0);
         } else {
-            print_standard(eds, input_file, verbose, vm.count("sources") > 0);
+            print_standard(summarize(eds, input_file), verbose, vm.count("sources") > 0);
         }
 
         print_performance();
@@ -1,5 +1,7 @@
 #include "transforms/vcf_transforms.hpp"
 #include "common.hpp"
+#include "formats/eds.hpp"
+#include "formats/seds.hpp"
 #include <boost/program_options.hpp>
 #include <iostream>
 #include <fstream>
@@ -31,6 +33,7 @@ int main(int argc, char** argv) {
         std::filesystem::path reference_file;
         std::filesystem::path output_file;
         std::filesystem::path sources_file;
+        std::string seds_format_name;
         Length context_length;
 
         po::options_description desc("Transform VCF (Variant Call Format) to EDS/l-EDS");
@@ -38,8 +41,9 @@ int main(int argc, char** argv) {
             ("help,h", "Show help message")
             ("input,i", po::value<std::filesystem::path>(&input_file)->required(), "Input VCF file (.vcf)")
             ("reference,r", po::value<std::filesystem::path>(&reference_file)->required(), "Reference FASTA file")
-            ("output,o", po::value<std::filesystem::path>(&output_file), "Output EDS file (default: <input>.eds)")
+            ("output,o", po::value<std::filesystem::path>(&output_file), "Output EDS file (default: <input>.eds, .edz writes the binary container)")
             ("sources,s", po::value<std::filesystem::path>(&sources_file), "Output source file (default: <output>.seds)")
+            ("seds-format", po::value<std::string>(&seds_format_name)->default_value("text"), "Source encoding: text {1,2,3}, ranges {1-3} or binary (.sedz)")
             ("context-length,l", po::value<Length>(&context_length)->default_value(0), "Create l-EDS with minimum context length (0 = regular EDS)");
 
         po::variables_map vm;
@@ -73,6 +77,10 @@ int main(int argc, char** argv) {
             std::cout << "  # Two-stage transformation (VCF → EDS → l-EDS):\n";
             std::cout << "  vcf2eds -i variants.vcf -r reference.fa -l 5\n";
             std::cout << "  # Creates: variants_l5.leds and variants_l5.seds\n\n";
+            std::cout << "  # Compact sources for large cohorts (runs of IDs as first-last, or binary):\n";
+            std::cout << "  vcf2eds -i variants.vcf -r reference.fa --seds-format ranges\n";
+            std::cout << "  vcf2eds -i variants.vcf -r reference.fa --seds-format binary\n";
+            std::cout << "  # Creates: variants.eds and variants.sedz\n\n";
             std::cout << "  # Custom output paths:\n";
             std::cout << "  vcf2eds -i variants.vcf -r reference.fa -o output.eds -s output.seds\n\n";
             std::cout << "OUTPUT:\n";
@@ -98,6 +106,9 @@ int main(int argc, char** argv) {
 
         po::notify(vm);
 
+        seds::Format seds_format = seds::parse_format(seds_format_name);
+        const char* seds_ext = (seds_format == seds::Format::BINARY) ? EXT_SEDZ : EXT_SEDS;
+
         // Validate input file extension
         if (input_file.extension() != ".vcf") {
             std::cerr << "Error: Input file must be a VCF file (.vcf)\n";
@@ -166,7 +177,7 @@ int main(int argc, char** argv) {
                 : output_file;
 
             seds_path = sources_file.empty()
-                ? eds_path.parent_path() / (base_name + suffix + ".seds")
+                ? eds_path.parent_path() / (base_name + suffix + seds_ext)
                 : sources_file;
         } else {
             // Regular EDS output
@@ -175,24 +186,33 @@ int main(int argc, char** argv) {
                 : output_file;
 
             seds_path = sources_file.empty()
-                ? eds_path.parent_path() / (eds_path.stem().string() + ".seds")
+                ? eds_path.parent_path() / (eds_path.stem().string() + seds_ext)
                 : sources_file;
         }
 
-        // Write EDS output
-        std::ofstream eds_out(eds_path);
-        if (!eds_out) {
-            throw std::runtime_error("Failed to open output file: " + eds_path.string());
+        // Write EDS output (binary container when requested by extension)
+        if (eds_path.extension() == EXT_EDZ) {
+            EDS(eds_str, seds_str).save(eds_path);
+        } else {
+            std::ofstream eds_out(eds_path);
+            if (!eds_out) {
+                throw std::runtime_error("Failed to open output file: " + eds_path.string());
+            }
+            eds_out << eds_str;
+            eds_out.close();
         }
-        eds_out << eds_str;
-        eds_out.close();
 
-        // Write sources output
-        std::ofstream seds_out(seds_path);
+        // Write sources output (re-encoded unless plain text; a .sedz path is always binary)
+        seds_format = seds::format_for(seds_path, seds_format);
+        std::ofstream seds_out(seds_path, std::ios::binary);
         if (!seds_out) {
             throw std::runtime_error("Failed to open sources file: " + seds_path.string());
         }
-        seds_out << seds_str;
+        if (seds_format == seds::Format::TEXT) {
+            seds_out << seds_str;
+        } else {
+            seds::write(seds_out, seds::parse(seds_str.data(), seds_str.size()), seds_format);
+        }
         seds_out.close();
 
         std::cout << "Transformation complete!\n";
@@ -1,10 +1,16 @@
 // EDS parsing tests
 #include "formats/eds.hpp"
+#include "formats/eds_stream.hpp"
 #include <sstream>
 #include <iostream>
 #include <cassert>
 #include <filesystem>
 #include <fstream>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cctype>
+#include <memory>
 
 void test_simple_eds() {
     std::cout << "Test 1: Simple EDS parsing... ";
@@ -230,6 +236,75 @@ void test_load_from_file() {
     std::cout << "PASSED\n";
 }
 
+void test_mapped_file_parsing() {
+    std::cout << "Test 10b: In-place parsing of mapped files... ";
+
+    // Bracketed, compact and whitespace-padded renderings of the same EDS
+    std::vector<std::string> inputs = {
+        "{ACGT} {A,,CA}\n{GG}{T,TT}{C}\n",
+        "ACGT{A,,CA}GG\r\n{T,TT}C",
+        "AC\nGT{ A , ,C\nA }GG{T,T T}C",
+    };
+    std::vector<std::string> spans = {"ACGT", "{A,,CA}", "GG", "{T,TT}", "C"};
+
+    edsparser::EDS reference("{ACGT}{A,,CA}{GG}{T,TT}{C}");
+    std::filesystem::path temp_path = std::filesystem::temp_directory_path() / "test_eds_mapped.eds";
+
+    for (const auto& input : inputs) {
+        {
+            std::ofstream ofs(temp_path, std::ios::binary);
+            ofs << input;
+        }
+        for (auto mode : {edsparser::EDS::StoringMode::FULL, edsparser::EDS::StoringMode::METADATA_ONLY}) {
+            auto eds = edsparser::EDS::load(temp_path, mode);
+            assert(eds.length() == reference.length());
+            assert(eds.cardinality() == reference.cardinality());
+            assert(eds.size() == reference.size());
+
+            for (size_t pos = 0; pos < eds.length(); pos++) {
+                assert(eds.read_symbol(pos) == reference.read_symbol(pos));
+
+                // Byte spans are offsets into the file itself, not into a normalized copy
+                std::string span = input.substr(static_cast<std::streamoff>(eds.get_base_position(pos)),
+                                                eds.get_symbol_byte_length(pos));
+                span.erase(std::remove_if(span.begin(), span.end(),
+                                          [](unsigned char c) { return std::isspace(c); }),
+                           span.end());
+                if (span.front() == '{' && spans[pos].front() != '{') {
+                    span = span.substr(1, span.size() - 2);
+                }
+                assert(span == spans[pos]);
+            }
+        }
+        std::filesystem::remove(edsparser::eds_index::sidecar_path(temp_path));
+    }
+
+    // A '{' inside a set is an error, not a character
+    {
+        std::ofstream ofs(temp_path);
+        ofs << "{A,{C}}";
+    }
+    bool threw = false;
+    try {
+        edsparser::EDS::load(temp_path);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // An empty file maps to nothing and gives an empty EDS
+    {
+        std::ofstream ofs(temp_path);
+    }
+    assert(edsparser::EDS::load(temp_path).empty());
+    assert(edsparser::EDS::load(temp_path, edsparser::EDS::StoringMode::METADATA_ONLY).empty());
+
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(temp_path));
+    std::filesystem::remove(temp_path);
+
+    std::cout << "PASSED\n";
+}
+
 void test_roundtrip_file() {
     std::cout << "Test 11: Roundtrip EDS (save → load)... ";
 
@@ -532,6 +607,789 @@ void test_roundtrip_compact() {
     std::cout << "PASSED\n";
 }
 
+void test_long_and_wrapped_strings() {
+    std::cout << "Test 23b: Long and line-wrapped strings... ";
+
+    // Strings longer than one SIMD block, wrapped across lines and padded
+    std::string long_a(100, 'A');
+    std::string long_c(37, 'C');
+    std::string input = long_a.substr(0, 60) + "\n" + long_a.substr(60) +
+                        "{" + long_c + ",\t" + long_c.substr(0, 20) + "\r\n" + long_c.substr(20) + ", }\n" +
+                        "{GT}\n";
+    edsparser::EDS eds(input);
+
+    assert(eds.length() == 3);
+    assert(eds.cardinality() == 5);
+    assert(eds.size() == 100 + 37 + 37 + 0 + 2);
+
+    const auto& sets = eds.get_sets();
+    assert(sets[0][0] == long_a);
+    assert(sets[1].size() == 3);
+    assert(sets[1][0] == long_c);
+    assert(sets[1][1] == long_c);
+    assert(sets[1][2] == "");
+    assert(sets[2][0] == "GT");
+
+    // Same input through the mapped file loader
+    std::filesystem::path temp_path = std::filesystem::temp_directory_path() / "test_eds_wrapped.eds";
+    std::ofstream ofs(temp_path);
+    ofs << input;
+    ofs.close();
+
+    edsparser::EDS loaded = edsparser::EDS::load(temp_path);
+    const auto& loaded_sets = loaded.get_sets();
+    assert(loaded.length() == 3);
+    assert(loaded_sets[0][0] == long_a);
+    assert(loaded_sets[1][1] == long_c);
+
+    std::filesystem::remove(temp_path);
+
+    std::cout << "PASSED\n";
+}
+
+void test_string_views() {
+    std::cout << "Test 23c: Zero-copy string access... ";
+
+    edsparser::EDS eds("{ACGT}{A,,CA}{GG}");
+
+    // By global string ID
+    assert(eds.get_string(0) == "ACGT");
+    assert(eds.get_string(1) == "A");
+    assert(eds.get_string(2).empty());
+    assert(eds.get_string(3) == "CA");
+    assert(eds.get_string(4) == "GG");
+
+    // By symbol and alternative
+    assert(eds.get_string(1, 2) == "CA");
+    assert(eds.get_string(2, 0) == "GG");
+
+    // Views are contiguous and agree with the materialized sets
+    const auto& sets = eds.get_sets();
+    assert(eds.get_string(3).data() == eds.get_string(1).data() + 1);
+    assert(sets[1][2] == std::string(eds.get_string(1, 2)));
+
+    bool threw = false;
+    try {
+        eds.get_string(5);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        eds.get_string(1, 3);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Merged EDS keeps its own arena
+    edsparser::EDS merged = eds.merge_adjacent(1, 2);
+    assert(merged.get_string(0) == "ACGT");
+    assert(merged.get_string(1, 0) == "AGG");
+    assert(merged.get_string(1, 1) == "GG");
+    assert(merged.get_string(1, 2) == "CAGG");
+
+    edsparser::EDS merged_front = eds.merge_adjacent(0, 1);
+    assert(merged_front.get_string(0, 1) == "ACGT");
+    assert(merged_front.get_string(0, 2) == "ACGTCA");
+    assert(merged_front.get_string(1, 0) == "GG");
+
+    std::cout << "PASSED\n";
+}
+
+void test_binary_edz_roundtrip() {
+    std::cout << "Test 23d: Binary .edz roundtrip... ";
+
+    // Non-ACGT runs, lowercase, empty alternatives and a long symbol
+    std::string long_a(70, 'A');
+    std::string input = "{" + long_a + "NNNNN}{A,,CT}{GNNa,RY}{TT}";
+    std::string sources = "{0}{1,2}{3}{1}{2,3}{1}{0}";
+    edsparser::EDS eds(input, sources);
+
+    std::filesystem::path temp_path = std::filesystem::temp_directory_path() / "test_eds_binary.edz";
+    eds.save(temp_path);  // Extension selects the binary container
+
+    // FULL mode: same strings, metadata and sources
+    edsparser::EDS full = edsparser::EDS::load(temp_path);
+    assert(full.length() == eds.length());
+    assert(full.cardinality() == eds.cardinality());
+    assert(full.size() == eds.size());
+    assert(full.get_sets() == eds.get_sets());
+    assert(full.get_is_degenerate() == eds.get_is_degenerate());
+    assert(full.has_sources());
+    assert(full.get_sources() == eds.get_sources());
+    assert(full.get_statistics().num_empty_strings == 1);
+
+    // METADATA_ONLY mode: symbols decoded on demand from the payload
+    edsparser::EDS meta = edsparser::EDS::load(temp_path, edsparser::EDS::StoringMode::METADATA_ONLY);
+    assert(meta.length() == eds.length());
+    for (size_t i = 0; i < eds.length(); i++) {
+        assert(meta.read_symbol(i) == eds.read_symbol(i));
+    }
+    assert(meta.get_metadata().cum_set_sizes == eds.get_metadata().cum_set_sizes);
+
+    // Stream constructor detects the container as well
+    std::ifstream ifs(temp_path, std::ios::binary);
+    edsparser::EDS streamed(ifs);
+    assert(streamed.get_sets() == eds.get_sets());
+
+    // Text output of a binary-loaded EDS matches the original
+    std::ostringstream text;
+    full.save(text, edsparser::EDS::OutputFormat::FULL);
+    assert(text.str() == input + "\n");
+
+    std::filesystem::remove(temp_path);
+
+    std::cout << "PASSED\n";
+}
+
+void test_sidecar_index() {
+    std::cout << "Test 23e: Sidecar metadata index... ";
+
+    std::filesystem::path temp_path = std::filesystem::temp_directory_path() / "test_eds_index.eds";
+    std::filesystem::path index_path = edsparser::eds_index::sidecar_path(temp_path);
+    std::filesystem::remove(index_path);
+    {
+        std::ofstream ofs(temp_path);
+        ofs << "{ACGT}{A,,CA}{GG}{T,TT}";
+    }
+    assert(!edsparser::EDS::has_current_index(temp_path));
+
+    // First METADATA_ONLY load parses and writes the sidecar
+    auto mode = edsparser::EDS::StoringMode::METADATA_ONLY;
+    edsparser::EDS parsed = edsparser::EDS::load(temp_path, mode);
+    assert(std::filesystem::exists(index_path));
+    assert(edsparser::EDS::has_current_index(temp_path));
+
+    // Second load comes from the index with identical metadata
+    edsparser::EDS indexed = edsparser::EDS::load(temp_path, mode);
+    const auto& a = parsed.get_metadata();
+    const auto& b = indexed.get_metadata();
+    assert(indexed.length() == parsed.length());
+    assert(indexed.cardinality() == parsed.cardinality());
+    assert(indexed.size() == parsed.size());
+    assert(b.base_positions == a.base_positions);
+    assert(b.string_lengths == a.string_lengths);
+    assert(b.cum_set_sizes == a.cum_set_sizes);
+    assert(b.is_degenerate == a.is_degenerate);
+    assert(b.cum_common_positions == a.cum_common_positions);
+    assert(b.cum_degenerate_counts == a.cum_degenerate_counts);
+    assert(b.num_empty_strings == a.num_empty_strings);
+    assert(b.avg_context_length == a.avg_context_length);
+    assert(indexed.read_symbol(1) == parsed.read_symbol(1));
+
+    // Same-size rewrite makes the index stale; the next load reparses
+    {
+        std::ofstream ofs(temp_path);
+        ofs << "{ACGT}{A,C,CA}{G}{T}{T}";
+    }
+    assert(!edsparser::EDS::has_current_index(temp_path));
+    edsparser::EDS reloaded = edsparser::EDS::load(temp_path, mode);
+    assert(reloaded.length() == 5);
+    assert(reloaded.get_metadata().num_empty_strings == 0);
+    assert(edsparser::EDS::has_current_index(temp_path));
+
+    // A damaged index is ignored
+    std::filesystem::resize_file(index_path, 10);
+    assert(!edsparser::EDS::has_current_index(temp_path));
+    assert(edsparser::EDS::load(temp_path, mode).length() == 5);
+
+    // Explicit rebuild
+    edsparser::EDS::build_index(temp_path);
+    assert(edsparser::EDS::has_current_index(temp_path));
+
+    std::filesystem::remove(index_path);
+    std::filesystem::remove(temp_path);
+
+    std::cout << "PASSED\n";
+}
+
+void test_random_access_all_formats() {
+    std::cout << "Test 23f: METADATA_ONLY random access on compact and wrapped files... ";
+
+    // Full, compact and line-wrapped/padded renderings of the same EDS
+    std::vector<std::string> inputs = {
+        "{ACGT}{A,,CA}{GG}{T,TT}{C}",
+        "ACGT{A,,CA}GG{T,TT}C",
+        "AC\nGT\n{A, ,C\nA}\r\n  GG{ T,T T }\nC\n",
+    };
+
+    edsparser::EDS reference("{ACGT}{A,,CA}{GG}{T,TT}{C}");
+    std::filesystem::path temp_path = std::filesystem::temp_directory_path() / "test_eds_random_access.eds";
+
+    for (const auto& input : inputs) {
+        {
+            std::ofstream ofs(temp_path);
+            ofs << input;
+        }
+        std::filesystem::remove(edsparser::eds_index::sidecar_path(temp_path));
+
+        // Second load comes from the sidecar index, so both paths are covered
+        for (int pass = 0; pass < 2; pass++) {
+            auto eds = edsparser::EDS::load(temp_path, edsparser::EDS::StoringMode::METADATA_ONLY);
+            assert(eds.length() == reference.length());
+
+            // Out of order, so each read stands alone
+            for (size_t pos : {4, 0, 2, 1, 3}) {
+                assert(eds.read_symbol(pos) == reference.read_symbol(pos));
+            }
+
+            // Byte spans point at the symbol in the file
+            edsparser::Position base = static_cast<std::streamoff>(eds.get_base_position(4));
+            assert(input.substr(base, eds.get_symbol_byte_length(4)).find('C') != std::string::npos);
+        }
+    }
+
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(temp_path));
+    std::filesystem::remove(temp_path);
+
+    std::cout << "PASSED\n";
+}
+
+void test_symbol_views() {
+    std::cout << "Test 23g: Zero-copy symbol views in every storage mode... ";
+
+    edsparser::EDS reference("{ACGT}{A,,CA}{GG}{T,TT}{C}");
+
+    // FULL mode views point into the arena
+    for (size_t pos = 0; pos < reference.length(); pos++) {
+        edsparser::SymbolView view = reference.symbol_view(pos);
+        assert(view.size() == reference.get_symbol_size(pos));
+        assert(view.to_set() == reference.read_symbol(pos));
+        for (size_t j = 0; j < view.size(); j++) {
+            assert(view[j].data() == reference.get_string(pos, j).data());
+        }
+    }
+
+    // METADATA_ONLY: clean text (mapped in place), wrapped text and .edz (decoded fallback)
+    std::filesystem::path temp_dir = std::filesystem::temp_directory_path();
+    std::vector<std::pair<std::filesystem::path, std::string>> files = {
+        {temp_dir / "test_eds_views.eds", "ACGT{A,,CA}GG{T,TT}C"},
+        {temp_dir / "test_eds_views_wrapped.eds", "AC\nGT\n{A, ,C\nA}\r\n  GG{ T,T T }\nC\n"},
+    };
+    for (const auto& [path, content] : files) {
+        std::ofstream ofs(path);
+        ofs << content;
+    }
+    std::filesystem::path edz_path = temp_dir / "test_eds_views.edz";
+    reference.save(edz_path);
+
+    for (const auto& path : {files[0].first, files[1].first, edz_path}) {
+        auto eds = edsparser::EDS::load(path, edsparser::EDS::StoringMode::METADATA_ONLY);
+        for (size_t pos : {3, 0, 4, 1, 2}) {
+            edsparser::SymbolView view = eds.symbol_view(pos);
+            assert(view.to_set() == reference.read_symbol(pos));
+
+            // Random access and iteration agree
+            size_t j = 0;
+            for (std::string_view str : view) {
+                assert(str == view[j]);
+                j++;
+            }
+            assert(j == view.size());
+        }
+
+        // Views outlive the call that produced them
+        edsparser::SymbolView kept = eds.symbol_view(1);
+        eds.symbol_view(3);
+        assert(kept[2] == "CA");
+    }
+
+    // A clean text file is viewed in the mapping, not copied
+    {
+        auto eds = edsparser::EDS::load(files[0].first, edsparser::EDS::StoringMode::METADATA_ONLY);
+        edsparser::SymbolView first = eds.symbol_view(1);
+        edsparser::SymbolView second = eds.symbol_view(1);
+        assert(first[0].data() == second[0].data());
+    }
+
+    bool caught = false;
+    try {
+        reference.symbol_view(reference.length());
+    } catch (const std::out_of_range&) {
+        caught = true;
+    }
+    assert(caught);
+
+    for (const auto& path : {files[0].first, files[1].first, edz_path}) {
+        std::filesystem::remove(edsparser::eds_index::sidecar_path(path));
+        std::filesystem::remove(path);
+    }
+
+    std::cout << "PASSED\n";
+}
+
+void test_concurrent_reads() {
+    std::cout << "Test 23h: Concurrent queries on one METADATA_ONLY EDS... ";
+
+    // 3000 symbols alternating common runs and degenerate sets, in compact form
+    std::string text;
+    for (int i = 0; i < 1500; i++) {
+        text += std::string(1 + i % 7, "ACGT"[i % 4]);
+        text += "{" + std::string(1 + i % 3, 'A') + ",C" + (i % 5 == 0 ? ",," : ",GT") + "}";
+    }
+    edsparser::EDS reference(text);
+    std::vector<edsparser::StringSet> expected = reference.get_sets();
+
+    std::filesystem::path temp_dir = std::filesystem::temp_directory_path();
+    std::filesystem::path eds_path = temp_dir / "test_eds_concurrent.eds";
+    std::filesystem::path edz_path = temp_dir / "test_eds_concurrent.edz";
+    {
+        std::ofstream ofs(eds_path);
+        ofs << text;
+    }
+    reference.save(edz_path);
+
+    for (const auto& path : {eds_path, edz_path}) {
+        auto eds = edsparser::EDS::load(path, edsparser::EDS::StoringMode::METADATA_ONLY);
+        std::atomic<size_t> mismatches{0};
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < 8; t++) {
+            threads.emplace_back([&, t]() {
+                // Each thread walks the symbols with its own stride
+                size_t stride = 2 * t + 1;
+                for (size_t k = 0; k < eds.length(); k++) {
+                    size_t pos = (k * stride + t) % eds.length();
+                    if (eds.read_symbol(pos) != expected[pos] ||
+                        eds.symbol_view(pos).to_set() != expected[pos]) {
+                        mismatches++;
+                    }
+                }
+
+                // Pattern generation and position checks share the same file
+                std::stringstream patterns;
+                eds.generate_patterns(patterns, 20, 12);
+                std::string line;
+                while (std::getline(patterns, line)) {
+                    if (line.size() != 12) {
+                        mismatches++;
+                    }
+                }
+                if (!eds.check_position(0, {}, "A")) {
+                    mismatches++;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        assert(mismatches == 0);
+    }
+
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(eds_path));
+    std::filesystem::remove(eds_path);
+    std::filesystem::remove(edz_path);
+
+    std::cout << "PASSED\n";
+}
+
+void test_block_cache() {
+    std::cout << "Test 23i: METADATA_ONLY block cache with a byte budget... ";
+
+    // 4000 symbols, enough for several cache blocks
+    std::string text;
+    for (int i = 0; i < 2000; i++) {
+        text += std::string(1 + i % 5, "ACGT"[i % 4]);
+        text += (i % 3 == 0) ? "{A,,TT}" : "{C, G}";  // Whitespace forces decoding
+    }
+    edsparser::EDS reference(text);
+    std::vector<edsparser::StringSet> expected = reference.get_sets();
+
+    std::filesystem::path temp_dir = std::filesystem::temp_directory_path();
+    std::filesystem::path eds_path = temp_dir / "test_eds_cache.eds";
+    std::filesystem::path edz_path = temp_dir / "test_eds_cache.edz";
+    {
+        std::ofstream ofs(eds_path);
+        ofs << text;
+    }
+    reference.save(edz_path);
+
+    size_t blocks = (reference.length() + edsparser::SymbolBlock::SYMBOLS_PER_BLOCK - 1) /
+                    edsparser::SymbolBlock::SYMBOLS_PER_BLOCK;
+
+    for (const auto& path : {eds_path, edz_path}) {
+        // Budget large enough for everything: one miss per block, hits afterwards
+        {
+            auto eds = edsparser::EDS::load(path, edsparser::EDS::StoringMode::METADATA_ONLY, 64 << 20);
+            for (size_t pos = 0; pos < eds.length(); pos++) {
+                assert(eds.symbol_view(pos).to_set() == expected[pos]);
+            }
+            auto stats = eds.get_cache_stats();
+            assert(stats.misses == blocks);
+            assert(stats.hits == eds.length() - blocks);
+            assert(stats.evictions == 0);
+
+            assert(eds.read_symbol(7) == expected[7]);
+            assert(eds.check_position(0, {}, "A"));
+            assert(eds.get_cache_stats().misses == blocks);
+        }
+
+        // Tiny budget: blocks are evicted, but views keep theirs alive
+        {
+            auto eds = edsparser::EDS::load(path, edsparser::EDS::StoringMode::METADATA_ONLY, 1024);
+            edsparser::SymbolView kept = eds.symbol_view(1);
+            for (size_t round = 0; round < 2; round++) {
+                for (size_t pos = 0; pos < eds.length(); pos++) {
+                    assert(eds.read_symbol(pos) == expected[pos]);
+                }
+            }
+            auto stats = eds.get_cache_stats();
+            assert(stats.evictions > 0);
+            assert(stats.misses > blocks);
+            assert(stats.resident_bytes < 64 << 20);
+            assert(kept.to_set() == expected[1]);
+
+            // Concurrent readers share the cache
+            std::atomic<size_t> mismatches{0};
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < 4; t++) {
+                threads.emplace_back([&, t]() {
+                    for (size_t k = 0; k < eds.length(); k++) {
+                        size_t pos = (k * (2 * t + 1)) % eds.length();
+                        if (eds.symbol_view(pos).to_set() != expected[pos]) {
+                            mismatches++;
+                        }
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            assert(mismatches == 0);
+        }
+    }
+
+    // Without a budget there is no cache
+    {
+        auto eds = edsparser::EDS::load(eds_path, edsparser::EDS::StoringMode::METADATA_ONLY);
+        eds.read_symbol(0);
+        assert(eds.get_cache_stats().hits == 0 && eds.get_cache_stats().misses == 0);
+    }
+
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(eds_path));
+    std::filesystem::remove(eds_path);
+    std::filesystem::remove(edz_path);
+
+    std::cout << "PASSED\n";
+}
+
+void test_succinct_metadata() {
+    std::cout << "Test 23j: Succinct METADATA_ONLY metadata answers the same queries... ";
+
+    // Alternating common runs and degenerate sets (with empty alternatives)
+    std::string text;
+    for (int i = 0; i < 3000; i++) {
+        text += std::string(1 + (i * 7) % 40, "ACGT"[i % 4]);
+        text += (i % 4 == 0) ? "{A,,TTT}" : (i % 4 == 1 ? "{C,G}" : "{GATTACA,T}");
+    }
+
+    std::filesystem::path temp_dir = std::filesystem::temp_directory_path();
+    std::filesystem::path eds_path = temp_dir / "test_eds_succinct.eds";
+    std::filesystem::path edz_path = temp_dir / "test_eds_succinct.edz";
+    {
+        std::ofstream ofs(eds_path);
+        ofs << text;
+    }
+    edsparser::EDS(text).save(edz_path);
+
+    for (const auto& path : {eds_path, edz_path}) {
+        for (size_t cache_budget : {size_t(0), size_t(1) << 20}) {
+            auto plain = edsparser::EDS::load(path, edsparser::EDS::StoringMode::METADATA_ONLY);
+            auto compact = edsparser::EDS::load(path, edsparser::EDS::StoringMode::METADATA_ONLY, cache_budget);
+            auto metadata = plain.get_metadata();  // Copy: compress_metadata() releases the arrays
+
+            size_t plain_bytes = compact.metadata_bytes();
+            compact.compress_metadata();
+            assert(compact.has_compressed_metadata());
+            assert(compact.metadata_bytes() < plain_bytes / 2);
+            assert(compact.get_metadata().cum_set_sizes.empty());
+            assert(compact.get_statistics().num_common_chars == plain.get_statistics().num_common_chars);
+
+            for (size_t pos = 0; pos < plain.length(); pos++) {
+                assert(compact.get_symbol_size(pos) == plain.get_symbol_size(pos));
+                assert(compact.get_base_position(pos) == plain.get_base_position(pos));
+                assert(compact.get_symbol_byte_length(pos) == plain.get_symbol_byte_length(pos));
+                assert(compact.read_symbol(pos) == plain.read_symbol(pos));
+                assert(compact.symbol_view(pos).to_set() == plain.read_symbol(pos));
+            }
+            for (size_t id = 0; id < plain.cardinality(); id++) {
+                assert(compact.get_string_length(id) == plain.get_string_length(id));
+            }
+
+            // Common run + one alternative of the following set, located by select queries
+            for (size_t pos = 0; pos + 1 < plain.length(); pos += 2) {
+                std::string common = plain.read_symbol(pos)[0];
+                edsparser::StringSet next = plain.read_symbol(pos + 1);
+                for (size_t j = 0; j < next.size(); j++) {
+                    if (next[j].empty()) {
+                        continue;  // Pattern would end before the set
+                    }
+                    edsparser::Position common_pos = metadata.cum_common_positions[pos];
+                    std::vector<int> choice = {metadata.cum_degenerate_counts[pos + 1] + static_cast<int>(j)};
+                    std::string pattern = common.substr(common.size() / 2) + next[j];
+                    edsparser::Position offset = common.size() / 2;
+                    assert(plain.check_position(common_pos + offset, choice, pattern));
+                    assert(compact.check_position(common_pos + offset, choice, pattern));
+                    assert(!compact.check_position(common_pos + offset, choice, pattern + "X"));
+                }
+            }
+            assert(!compact.check_position(plain.get_statistics().num_common_chars + 10, {}, "A"));
+
+            bool caught = false;
+            try {
+                compact.merge_adjacent(0, 1);
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            assert(caught);
+
+            caught = false;
+            try {
+                compact.get_string(1, 0);
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            assert(caught);
+        }
+    }
+
+    // FULL mode keeps its plain arrays
+    bool caught = false;
+    try {
+        edsparser::EDS("{A}{C,G}").compress_metadata();
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    assert(caught);
+
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(eds_path));
+    std::filesystem::remove(eds_path);
+    std::filesystem::remove(edz_path);
+
+    std::cout << "PASSED\n";
+}
+
+void test_parallel_parse() {
+    std::cout << "Test 23k: Chunked parallel parse matches the sequential parse... ";
+
+    // A few MiB so that the input is cut into several chunks
+    std::string compact;
+    std::string full;
+    std::string seds;
+    size_t strings = 0;
+    for (int i = 0; i < 100000; i++) {
+        std::string common(1 + (i * 13) % 60, "ACGT"[i % 4]);
+        std::string set = (i % 3 == 0) ? "{A,,TTT}" : (i % 3 == 1 ? "{C,G}" : "{GATTACA,T,CC}");
+        compact += common + (i % 50 == 0 ? "\n" : "") + set;
+        full += "{" + common + "}" + set + (i % 50 == 0 ? "\n" : "");
+        size_t set_size = (i % 3 == 1) ? 2 : 3;
+        seds += "{" + std::to_string(i % 5) + "}";
+        for (size_t j = 0; j < set_size; j++) {
+            seds += "{" + std::to_string(j) + "," + std::to_string(j + 1) + "}";
+        }
+        strings += 1 + set_size;
+    }
+
+    std::filesystem::path temp_dir = std::filesystem::temp_directory_path();
+    std::filesystem::path compact_path = temp_dir / "test_eds_parallel_compact.eds";
+    std::filesystem::path full_path = temp_dir / "test_eds_parallel_full.eds";
+    std::filesystem::path seds_path = temp_dir / "test_eds_parallel.seds";
+    std::ofstream(compact_path) << compact;
+    std::ofstream(full_path) << full;
+    std::ofstream(seds_path) << seds;
+
+    using Mode = edsparser::EDS::StoringMode;
+    for (const auto& path : {compact_path, full_path}) {
+        for (Mode mode : {Mode::FULL, Mode::METADATA_ONLY}) {
+            std::filesystem::remove(edsparser::eds_index::sidecar_path(path));
+            auto sequential = edsparser::EDS::load(path, seds_path, mode);
+            std::filesystem::remove(edsparser::eds_index::sidecar_path(path));
+            auto parallel = edsparser::EDS::load(path, seds_path, mode, 0, 5);
+
+            const auto& a = sequential.get_metadata();
+            const auto& b = parallel.get_metadata();
+            assert(parallel.length() == sequential.length());
+            assert(parallel.cardinality() == strings);
+            assert(parallel.size() == sequential.size());
+            assert(b.base_positions == a.base_positions);
+            assert(b.symbol_byte_lengths == a.symbol_byte_lengths);
+            assert(b.symbol_sizes == a.symbol_sizes);
+            assert(b.string_lengths == a.string_lengths);
+            assert(b.cum_set_sizes == a.cum_set_sizes);
+            assert(b.is_degenerate == a.is_degenerate);
+            assert(b.cum_common_positions == a.cum_common_positions);
+            assert(b.cum_degenerate_counts == a.cum_degenerate_counts);
+            assert(b.min_context_length == a.min_context_length);
+            assert(b.max_context_length == a.max_context_length);
+            assert(b.avg_context_length == a.avg_context_length);
+            assert(b.num_degenerate_symbols == a.num_degenerate_symbols);
+            assert(b.num_common_chars == a.num_common_chars);
+            assert(b.total_change_size == a.total_change_size);
+            assert(b.num_empty_strings == a.num_empty_strings);
+            assert(parallel.get_sources() == sequential.get_sources());
+            assert(b.num_paths == a.num_paths);
+
+            for (size_t pos = 0; pos < sequential.length(); pos += 97) {
+                assert(parallel.read_symbol(pos) == sequential.read_symbol(pos));
+            }
+        }
+    }
+
+    // A malformed symbol late in the file is reported at the same position
+    std::string broken = compact + "{A,C";
+    std::ofstream(compact_path) << broken;
+    std::string messages[2];
+    for (size_t threads : {size_t(1), size_t(4)}) {
+        try {
+            edsparser::EDS::load(compact_path, Mode::FULL, 0, threads);
+        } catch (const std::runtime_error& e) {
+            messages[threads == 1 ? 0 : 1] = e.what();
+        }
+    }
+    assert(!messages[0].empty());
+    assert(messages[1] == messages[0]);
+
+    // Source count is still checked against the EDS
+    bool caught = false;
+    try {
+        std::ofstream(seds_path) << "{0}";
+        edsparser::EDS::load(full_path, seds_path, Mode::FULL, 0, 4);
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    assert(caught);
+
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(compact_path));
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(full_path));
+    std::filesystem::remove(compact_path);
+    std::filesystem::remove(full_path);
+    std::filesystem::remove(seds_path);
+
+    std::cout << "PASSED\n";
+}
+
+void test_stream_parser() {
+    std::cout << "Test 23l: Incremental stream parser matches EDS across chunk boundaries... ";
+
+    std::vector<std::string> inputs = {
+        "{ACGT}{A,ACA}{CGT}{T,TG}",
+        "ACGT{A,,ACA}CGT{T,TG}GA",
+        "  ACG\nT{A,\nAC A}\nCGT {T,TG}\n\n",
+        ",A{C}",
+        "",
+    };
+    std::string large;
+    for (int i = 0; i < 2000; i++) {
+        large += std::string(1 + (i * 7) % 90, "ACGT"[i % 4]) + (i % 3 == 0 ? "{A,,TTT}" : "{C,G}");
+        large += (i % 10 == 0) ? "\n" : "";
+    }
+    inputs.push_back(large);
+
+    for (const auto& text : inputs) {
+        edsparser::EDS expected(text);
+        for (size_t chunk : {size_t(1), size_t(3), size_t(64), size_t(1000), text.size() + 1}) {
+            // Push: symbols arrive through the callback
+            std::vector<edsparser::StringSet> symbols;
+            edsparser::EDSStreamParser push([&](const edsparser::StreamedSymbol& symbol) {
+                assert(symbol.index == symbols.size());
+                assert(symbol.byte_offset == static_cast<edsparser::Position>(expected.get_base_position(symbol.index)));
+                assert(symbol.byte_length == expected.get_symbol_byte_length(symbol.index));
+                symbols.push_back(symbol.strings.to_set());
+            });
+            // Pull: symbols are taken after each feed
+            edsparser::EDSStreamParser pull;
+            std::vector<edsparser::StringSet> pulled;
+            edsparser::StreamedSymbol symbol;
+            for (size_t i = 0; i < text.size(); i += chunk) {
+                std::string_view piece(text.data() + i, std::min(chunk, text.size() - i));
+                push.feed(piece);
+                pull.feed(piece);
+                while (pull.next(symbol)) {
+                    pulled.push_back(symbol.strings.to_set());
+                }
+            }
+            push.finish();
+            pull.finish();
+            while (pull.next(symbol)) {
+                pulled.push_back(symbol.strings.to_set());
+            }
+
+            assert(symbols.size() == expected.length());
+            assert(pulled == symbols);
+            for (size_t pos = 0; pos < expected.length(); pos++) {
+                assert(symbols[pos] == expected.read_symbol(pos));
+            }
+            assert(push.length() == expected.length());
+            assert(push.cardinality() == expected.cardinality());
+            assert(push.size() == expected.size());
+            assert(push.bytes() == text.size());
+            if (!expected.empty()) {
+                auto a = push.get_statistics();
+                auto b = expected.get_statistics();
+                assert(a.min_context_length == b.min_context_length);
+                assert(a.max_context_length == b.max_context_length);
+                assert(a.avg_context_length == b.avg_context_length);
+                assert(a.num_degenerate_symbols == b.num_degenerate_symbols);
+                assert(a.num_common_chars == b.num_common_chars);
+                assert(a.total_change_size == b.total_change_size);
+                assert(a.num_empty_strings == b.num_empty_strings);
+            }
+        }
+    }
+
+    // Malformed input fails with the message of the file parser
+    for (std::string text : {"{A}{C,G", "ACG}T", "{A,{C}"}) {
+        std::string expected_message;
+        try {
+            edsparser::EDS eds(text);
+        } catch (const std::runtime_error& e) {
+            expected_message = e.what();
+        }
+        std::string message;
+        try {
+            edsparser::EDSStreamParser parser([](const edsparser::StreamedSymbol&) {});
+            for (char ch : text) {
+                parser.feed(&ch, 1);
+            }
+            parser.finish();
+        } catch (const std::runtime_error& e) {
+            message = e.what();
+        }
+        assert(!message.empty());
+        assert(message == expected_message);
+    }
+
+    // Binary containers cannot be streamed
+    std::stringstream edz;
+    edsparser::EDS("{A}{C,G}").save(edz, edsparser::EDS::OutputFormat::BINARY);
+    bool caught = false;
+    try {
+        edsparser::EDSStreamParser parser;
+        parser.feed(edz.str());
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    assert(caught);
+
+    // Buffers follow the largest symbol, not the stream
+    edsparser::EDSStreamParser parser([](const edsparser::StreamedSymbol&) {});
+    std::string block;
+    for (int i = 0; i < 200; i++) {
+        block += "ACGTACGTAC{A,C,GT}";
+    }
+    for (int i = 0; i < 500; i++) {
+        parser.feed(block);
+    }
+    parser.finish();
+    assert(parser.length() == 200000);
+    assert(parser.peak_buffer_bytes() < 1024);
+
+    std::cout << "PASSED\n";
+}
+
 void test_load_sources_string() {
     std::cout << "Test 24: Load sources from string... ";
 
@@ -609,6 +1467,7 @@ void test_generate_patterns_metadata_only() {
     assert(count == 5);
 
     std::filesystem::remove(temp_file);
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(temp_file));
     std::cout << "PASSED\n";
 }
 
@@ -839,6 +1698,7 @@ void test_extract_metadata_only() {
     assert(threw);
 
     std::filesystem::remove(temp_file);
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(temp_file));
     std::cout << "PASSED\n";
 }
 
@@ -956,6 +1816,7 @@ void test_check_position_metadata_only() {
     assert(eds.check_position(0, {}, "XYZ") == false);
 
     std::filesystem::remove(temp_file);
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(temp_file));
     std::cout << "PASSED\n";
 }
 
@@ -1141,8 +2002,190 @@ void test_check_position_sources_metadata_only() {
     assert(eds.check_position(4, {1, 2}, "ACACGTT") == false); // Empty intersection
 
     std::filesystem::remove(temp_eds);
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(temp_eds));
+    std::filesystem::remove(temp_seds);
+
+    std::cout << "PASSED\n";
+}
+
+void test_check_positions_batch() {
+    std::cout << "Test 45: Batch check_positions and extract... ";
+
+    // Degenerate strings: symbol 1 -> 0,1; symbol 3 -> 2,3; symbol 5 -> 4,5,6
+    std::string eds_str = "{ACGT}{A,ACA}{CGT}{T,TG}{AC}{G,GA,C}{TT}";
+    std::string seds_str = "{0}{1,3}{2}{0}{1}{2,3}{0}{1}{3}{2}{0}";
+
+    // Every start, every choice of degenerate strings after it, a few patterns
+    std::vector<edsparser::EDS::PositionQuery> queries;
+    const std::vector<std::string> patterns = {
+        "A", "ACGTA", "ACGTACACG", "CGTTG", "CGTTAC", "TTGACG", "TACGA", "GTTGACCTT", "CT", "ACGATT"
+    };
+    for (edsparser::Position pos = 0; pos < 12; pos++) {
+        for (int d1 = 0; d1 < 2; d1++) {
+            for (int d3 = 2; d3 < 4; d3++) {
+                for (int d5 = 4; d5 < 7; d5++) {
+                    std::vector<int> degs = pos < 4 ? std::vector<int>{d1, d3, d5}
+                                          : pos < 7 ? std::vector<int>{d3, d5}
+                                          : std::vector<int>{d5};
+                    for (const auto& pattern : patterns) {
+                        queries.push_back({pos, degs, pattern});
+                    }
+                }
+            }
+        }
+    }
+    queries.push_back({3, {0}, ""});  // Empty pattern
+
+    edsparser::EDS eds(eds_str, seds_str);
+
+    // Single calls (their warnings about extra degenerate strings silenced)
+    std::vector<bool> expected;
+    std::streambuf* err = std::cerr.rdbuf(nullptr);
+    for (const auto& q : queries) {
+        try {
+            expected.push_back(eds.check_position(q.common_pos, q.degenerate_strings, q.pattern));
+        } catch (const std::exception&) {
+            expected.push_back(false);  // Too few strings for the pattern: dropped below
+        }
+    }
+    std::cerr.rdbuf(err);
+
+    std::vector<edsparser::EDS::PositionQuery> valid;
+    std::vector<bool> valid_expected;
+    for (size_t i = 0; i < queries.size(); i++) {
+        try {
+            eds.check_positions(std::vector<edsparser::EDS::PositionQuery>{queries[i]});
+            valid.push_back(queries[i]);
+            valid_expected.push_back(expected[i]);
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    assert(valid.size() > 100);
+    size_t matches = std::count(valid_expected.begin(), valid_expected.end(), true);
+    assert(matches > 10 && matches < valid.size());
+
+    for (size_t threads : {1, 3}) {
+        assert(eds.check_positions(valid, threads) == valid_expected);
+    }
+
+    // Same answers on disk, with cached symbols and sources decoded on demand
+    auto temp_eds = std::filesystem::temp_directory_path() / "test_check_positions.eds";
+    auto temp_seds = std::filesystem::temp_directory_path() / "test_check_positions.seds";
+    std::ofstream(temp_eds) << eds_str;
+    std::ofstream(temp_seds) << seds_str;
+    auto lazy = edsparser::EDS::load(temp_eds, temp_seds, edsparser::EDS::StoringMode::METADATA_ONLY);
+    assert(lazy.has_lazy_sources());
+    assert(lazy.check_positions(valid, 2) == valid_expected);
+    std::filesystem::remove(temp_eds);
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(temp_eds));
     std::filesystem::remove(temp_seds);
 
+    // Raw form, and the first failing query (in input order) is reported
+    std::unique_ptr<bool[]> out(new bool[valid.size()]);
+    eds.check_positions(valid.data(), valid.size(), out.get(), 2);
+    for (size_t i = 0; i < valid.size(); i++) {
+        assert(out[i] == valid_expected[i]);
+    }
+    std::vector<edsparser::EDS::PositionQuery> failing = valid;
+    failing.push_back({0, {}, "ACGTA"});       // Not enough degenerate strings
+    failing.insert(failing.begin(), {0, {5}, "ACGTA"});  // String of symbol 5 given for symbol 1
+    try {
+        eds.check_positions(failing, 3);
+        assert(false);
+    } catch (const std::invalid_argument& e) {
+        assert(std::string(e.what()).find("mismatch") != std::string::npos);
+    }
+
+    // Batch extract
+    std::vector<edsparser::EDS::ExtractQuery> extracts = {
+        {2, 3, {0, 1, 0}}, {0, 7, {0, 1, 0, 1, 0, 2, 0}}, {5, 4, {1, 0}}, {1, 1, {1}}, {3, 0, {}}
+    };
+    std::vector<edsparser::String> extracted = eds.extract(extracts, 2);
+    assert(extracted.size() == extracts.size());
+    for (size_t i = 0; i < extracts.size(); i++) {
+        assert(extracted[i] == eds.extract(extracts[i].pos, extracts[i].len, extracts[i].changes));
+    }
+    assert(extracted[1] == "ACGTACACGTTGACCTT");
+    extracts.push_back({1, 1, {2}});
+    try {
+        eds.extract(extracts, 2);
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+
+    std::cout << "PASSED\n";
+}
+
+void test_check_position_in_place() {
+    std::cout << "Test 46: check_position compares in place... ";
+
+    edsparser::EDS eds("{ACGT}{A,ACA}{CGT}{T,TG}");
+
+    // Choices past the symbols the pattern covers are ignored
+    assert(eds.check_position(0, {999}, "ACGA") == false);
+    assert(eds.check_position(0, {}, "T") == false);
+    bool threw = false;
+    try {
+        eds.check_position(0, {999}, "ACGTA");
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Choices are validated before the text: a mismatch does not hide a missing one
+    threw = false;
+    try {
+        eds.check_position(0, {}, "TTTTT");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Pattern longer than the rest of the EDS
+    assert(eds.check_position(4, {2}, "CGTTA") == false);
+
+    // With sources, a pattern ending inside a degenerate symbol followed by
+    // another one needs no choice for the second
+    edsparser::EDS sourced("{ACGT}{A,C}{G,T}", "{1,2}{1}{2}{1}{2}");
+    assert(sourced.check_position(0, {0}, "ACGTA") == true);
+    assert(sourced.check_position(0, {1}, "ACGTA") == false);
+    assert(sourced.check_position(0, {0, 2}, "ACGTAG") == true);
+    assert(sourced.check_position(0, {0, 3}, "ACGTAT") == false);
+
+    // Patterns walking more symbols than the METADATA_ONLY view window
+    std::string text;
+    std::string path;
+    std::vector<int> choices;
+    int degenerate_strings = 0;
+    for (int i = 0; i < 150; i++) {
+        text += "{AC}{G,TT}";
+        path += (i % 3 == 0) ? "ACTT" : "ACG";
+        choices.push_back(degenerate_strings + ((i % 3 == 0) ? 1 : 0));
+        degenerate_strings += 2;
+    }
+    auto temp_file = std::filesystem::temp_directory_path() / "test_check_in_place.eds";
+    std::ofstream(temp_file) << text;
+    edsparser::EDS full(text);
+    auto lazy = edsparser::EDS::load(temp_file, edsparser::EDS::StoringMode::METADATA_ONLY, 1);
+
+    std::string wrong = path;
+    wrong[wrong.size() - 2] = 'A';
+    for (const edsparser::EDS* e : {&full, &lazy}) {
+        assert(e->check_position(0, choices, path) == true);
+        assert(e->check_position(0, choices, wrong) == false);
+    }
+
+    std::vector<edsparser::EDS::PositionQuery> queries;
+    for (int k = 0; k < 20; k++) {
+        queries.push_back({0, choices, path.substr(0, path.size() - k)});
+        queries.push_back({0, choices, wrong.substr(0, wrong.size() - k)});
+    }
+    std::vector<bool> expected = full.check_positions(queries);
+    assert(expected[0] && !expected[1] && !expected[3] && expected[5]);
+    assert(lazy.check_positions(queries, 2) == expected);
+
+    std::filesystem::remove(temp_file);
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(temp_file));
     std::cout << "PASSED\n";
 }
 
@@ -1160,6 +2203,7 @@ int main() {
         test_invalid_format_missing_close();
         test_save_to_file();
         test_load_from_file();
+        test_mapped_file_parsing();
         test_roundtrip_file();
         test_load_nonexistent_file();
         test_statistics_simple();
@@ -1173,6 +2217,17 @@ int main() {
         test_compact_format_parsing();
         test_compact_format_output();
         test_roundtrip_compact();
+        test_long_and_wrapped_strings();
+        test_string_views();
+        test_binary_edz_roundtrip();
+        test_sidecar_index();
+        test_random_access_all_formats();
+        test_symbol_views();
+        test_concurrent_reads();
+        test_block_cache();
+        test_succinct_metadata();
+        test_parallel_parse();
+        test_stream_parser();
         test_load_sources_string();
         test_generate_patterns();
         test_generate_patterns_metadata_only();
@@ -1197,6 +2252,8 @@ int main() {
         test_check_position_sources_all_paths();
         test_check_position_sources_disjoint();
         test_check_position_sources_metadata_only();
+        test_check_positions_batch();
+        test_check_position_in_place();
 
         std::cout << "\n✓ All tests passed!\n";
         return 0;
@@ -1,7 +1,14 @@
 #include "formats/eds.hpp"
+#include "transforms/eds_transforms.hpp"
+#include "transforms/leds_profile.hpp"
+#include "transforms/leds_view.hpp"
 #include <iostream>
 #include <cassert>
 #include <sstream>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
 
 using namespace edsparser;
 
@@ -370,6 +377,592 @@ void test_merge_resulting_in_nondegenerate() {
     pass();
 }
 
+void test_merge_symbols_kernel() {
+    test("merge_symbols matches merge_adjacent without rebuilding the EDS");
+
+    std::string eds_str = "{ACGT}{A,ACA}{CGT}{T,TG}{A,C,}{GG}";
+    std::string seds_str = "{0}{1,3}{2}{0}{1}{2,3}{1}{2}{3}{0}";
+
+    EDS plain(eds_str);
+    EDS sourced(eds_str, seds_str);
+
+    auto temp_eds = std::filesystem::temp_directory_path() / "test_merge_symbols.eds";
+    auto temp_seds = std::filesystem::temp_directory_path() / "test_merge_symbols.seds";
+    std::ofstream(temp_eds) << eds_str;
+    std::ofstream(temp_seds) << seds_str;
+    EDS lazy = EDS::load(temp_eds, temp_seds, EDS::StoringMode::METADATA_ONLY);
+
+    for (size_t pos = 0; pos + 1 < plain.length(); pos++) {
+        // Cartesian
+        EDS::MergedSymbol merged = plain.merge_symbols(pos, pos + 1);
+        assert(merged.strings == plain.merge_adjacent(pos, pos + 1).get_sets()[pos]);
+        assert(merged.sources.empty());
+
+        // Linear, with sources in memory and read on demand
+        EDS full_merge = sourced.merge_adjacent(pos, pos + 1);
+        std::vector<std::set<int>> expected_sources = full_merge.get_sources();
+        for (const EDS* e : {&sourced, &lazy}) {
+            EDS::MergedSymbol linear = e->merge_symbols(pos, pos + 1);
+            assert(linear.strings == full_merge.get_sets()[pos]);
+            assert(linear.sources.size() == linear.strings.size());
+            size_t first = full_merge.get_metadata().cum_set_sizes[pos];
+            for (size_t k = 0; k < linear.sources.size(); k++) {
+                std::set<int> paths;
+                sourced.get_source_table().for_each_path(linear.sources[k], [&](int id) { paths.insert(id); });
+                assert(paths == expected_sources[first + k]);
+            }
+        }
+    }
+
+    bool threw = false;
+    try {
+        plain.merge_symbols(1, 3);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::filesystem::remove(temp_eds);
+    std::filesystem::remove(eds_index::sidecar_path(temp_eds));
+    std::filesystem::remove(temp_seds);
+    pass();
+}
+
+void test_streaming_leds() {
+    test("Streaming l-EDS transform (text, binary and sEDS encodings)");
+
+    std::string eds_str = "{ACGT}{A,C}{G}{T,TG}{AAAA}{C,G}{T}";
+    std::string seds_str = "{0}{1,2}{3}{0}{1}{2,3}{0}{1,3}{2}{0}";
+
+    // Cartesian: the window between ACGT and T is collapsed in one merge
+    std::istringstream in1(eds_str);
+    std::ostringstream out1;
+    eds_to_leds_cartesian(in1, out1, 5);
+    assert(out1.str() == "ACGT{AGTAAAAC,AGTAAAAG,AGTGAAAAC,AGTGAAAAG,"
+                         "CGTAAAAC,CGTAAAAG,CGTGAAAAC,CGTGAAAAG}T\n");
+
+    // Linear: only combinations sharing a path
+    std::istringstream in2(eds_str), seds2(seds_str);
+    std::ostringstream out2, sources2;
+    eds_to_leds_linear(in2, out2, 5, &seds2, &sources2);
+    assert(out2.str() == "ACGT{AGTAAAAC,AGTGAAAAG,CGTGAAAAC}T\n");
+    assert(sources2.str() == "{0}{1}{2}{3}{0}\n");
+
+    // Every length gives an l-EDS, whatever the sEDS encoding or the EDS container
+    EDS sourced(eds_str, seds_str);
+    for (Length l = 1; l <= 6; l++) {
+        std::string expected_eds, expected_seds;
+        for (auto format : {EDS::SourcesFormat::TEXT, EDS::SourcesFormat::RANGES, EDS::SourcesFormat::BINARY}) {
+            std::ostringstream encoded;
+            sourced.save_sources(encoded, format);
+            std::istringstream in(eds_str), seds(encoded.str());
+            std::ostringstream out, sources;
+            eds_to_leds_linear(in, out, l, &seds, &sources, 1, false);
+            if (expected_eds.empty()) {
+                expected_eds = out.str();
+                expected_seds = sources.str();
+            }
+            assert(out.str() == expected_eds);
+            assert(sources.str() == expected_seds);
+        }
+
+        // Binary .edz is loaded whole, with the sources it carries
+        std::ostringstream edz;
+        sourced.save(edz, EDS::OutputFormat::BINARY);
+        std::istringstream edz_in(edz.str());
+        std::ostringstream out, sources;
+        eds_to_leds_linear(edz_in, out, l, nullptr, &sources, 1, false);
+        assert(out.str() == expected_eds);
+        assert(sources.str() == expected_seds);
+
+        EDS leds(expected_eds, expected_seds);
+        assert(is_leds(leds, l));
+    }
+
+    // Cartesian merging cannot take an .edz carrying sources
+    std::ostringstream edz;
+    sourced.save(edz, EDS::OutputFormat::BINARY);
+    std::istringstream edz_in(edz.str());
+    std::ostringstream sink;
+    bool threw = false;
+    try {
+        eds_to_leds_cartesian(edz_in, sink, 3);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Source count must match the EDS cardinality
+    std::istringstream in3(eds_str), seds3("{0}{1,2}{3}");
+    threw = false;
+    try {
+        eds_to_leds_linear(in3, sink, 3, &seds3, nullptr);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    pass();
+}
+
+void test_streaming_leds_universal_paths() {
+    test("Streaming l-EDS treats any path set containing 0 as universal");
+
+    // {0,1} is universal, as for merge_adjacent: the path-2 variant is kept
+    std::istringstream in("ACGTAC{A,C}G{T,A}ACGTAC"), seds("{0}{1}{2}{0,1}{1}{2}{0}");
+    std::ostringstream out, sources;
+    eds_to_leds_linear(in, out, 3, &seds, &sources);
+    assert(out.str() == "ACGTAC{AGT,CGA}ACGTAC\n");
+    assert(sources.str() == "{0}{1}{2}{0}\n");
+
+    EDS eds("ACGTAC{A,C}G{T,A}ACGTAC", "{0}{1}{2}{0,1}{1}{2}{0}");
+    EDS merged = eds.merge_adjacent(1, 2).merge_adjacent(1, 2);
+    assert(merged.read_symbol(1) == StringSet({"AGT", "CGA"}));
+    pass();
+}
+
+void test_parallel_leds_matches_sequential() {
+    test("Chunked parallel l-EDS matches the sequential transform");
+
+    // Random EDS with sources partitioning paths 1-4 among the alternatives
+    // (no linear merge runs empty), adjacent common and degenerate symbols
+    // included; over 2 MiB of symbols so that two threads cut more than one batch
+    std::mt19937 rng(42);
+    const char* bases = "ACGT";
+    auto random_string = [&](size_t max_length) {
+        std::string str(rng() % (max_length + 1), 'A');
+        for (auto& c : str) c = bases[rng() % 4];
+        return str;
+    };
+    std::string eds_str, seds_str;
+    while (eds_str.size() < (size_t(3) << 20)) {
+        if (rng() % 3 != 0) {
+            eds_str += "{" + random_string(12) + "}";
+            seds_str += (rng() % 2) ? "{0}" : "{1,2,3,4}";
+        } else {
+            size_t alternatives = 2 + rng() % 2;
+            std::vector<std::string> paths(alternatives);
+            for (int path = 1; path <= 4; path++) {
+                std::string& set = paths[rng() % alternatives];
+                set += (set.empty() ? "" : ",") + std::to_string(path);
+            }
+            eds_str += "{";
+            for (size_t k = 0; k < alternatives; k++) {
+                eds_str += (k > 0 ? "," : "") + random_string(3);
+                seds_str += "{" + (paths[k].empty() ? "0" : paths[k]) + "}";
+            }
+            eds_str += "}";
+        }
+    }
+
+    for (Length l : {1, 6}) {
+        std::istringstream in1(eds_str), seds1(seds_str);
+        std::ostringstream out1, sources1;
+        eds_to_leds_linear(in1, out1, l, &seds1, &sources1, 1);
+        std::istringstream in4(eds_str), seds4(seds_str);
+        std::ostringstream out4, sources4;
+        eds_to_leds_linear(in4, out4, l, &seds4, &sources4, 2);
+        assert(out1.str() == out4.str());
+        assert(sources1.str() == sources4.str());
+
+        std::istringstream cin1(eds_str), cin4(eds_str);
+        std::ostringstream cout1, cout4;
+        eds_to_leds_cartesian(cin1, cout1, l, 1, false);
+        eds_to_leds_cartesian(cin4, cout4, l, 2, false);
+        assert(cout1.str() == cout4.str());
+    }
+
+    // Errors are those of the sequential transform
+    std::string bad_eds = "{A,C}{G}{T,A}{ACGTACGT}{A,C}{G}{T,A}";
+    std::string bad_seds = "{1}{2}{0}{1}{2}{0}{1}{1}{0}{2}{2}";
+    std::string messages[2];
+    for (size_t threads : {1, 4}) {
+        std::istringstream in(bad_eds), seds(bad_seds);
+        std::ostringstream out;
+        try {
+            eds_to_leds_linear(in, out, 3, &seds, nullptr, threads);
+        } catch (const std::runtime_error& e) {
+            messages[threads == 4] = e.what();
+        }
+    }
+    assert(messages[0].find("Merging symbols 4 to 6") != std::string::npos);
+    assert(messages[0] == messages[1]);
+
+    pass();
+}
+
+void test_leds_dedup_and_merge_limit() {
+    test("Cartesian l-EDS drops repeated strings and honours the merge limit");
+
+    // {A,AA}{A,AA} gives AAA twice
+    std::istringstream dup_in("{A,AA}{A,AA}{ACGTAC}");
+    std::ostringstream dup_out;
+    eds_to_leds_cartesian(dup_in, dup_out, 3);
+    assert(dup_out.str() == "{AA,AAA,AAAA}ACGTAC\n");
+
+    // The first window merges into 8 strings of 5 characters
+    std::string eds_str = "{A,C}{G}{A,C}{G}{A,C}ACGTACGT{A,C}";
+    for (size_t threads : {1, 2}) {
+        MergeLimit limit;
+        limit.max_strings = 4;
+        std::istringstream in(eds_str);
+        std::ostringstream out;
+        std::string message;
+        try {
+            eds_to_leds_cartesian(in, out, 3, threads, true, limit);
+        } catch (const std::runtime_error& e) {
+            message = e.what();
+        }
+        assert(message.find("Merging symbols 0 to 4 exceeds the merge limit (4 strings)") != std::string::npos);
+
+        limit = MergeLimit();
+        limit.max_bytes = 10;
+        limit.policy = MergeLimit::Policy::KEEP_UNMERGED;
+        std::istringstream keep_in(eds_str);
+        std::ostringstream keep_out;
+        auto unmerged = eds_to_leds_cartesian(keep_in, keep_out, 3, threads, true, limit);
+        assert(keep_out.str() == "{A,C}G{A,C}G{A,C}ACGTACGT{A,C}\n");
+        assert(unmerged.size() == 1 && unmerged[0].first == 0 && unmerged[0].last == 4);
+
+        // Within the limit nothing is reported
+        limit.max_bytes = 40;
+        std::istringstream fit_in(eds_str);
+        std::ostringstream fit_out;
+        assert(eds_to_leds_cartesian(fit_in, fit_out, 3, threads, true, limit).empty());
+        assert(fit_out.str() == "{AGAGA,AGAGC,AGCGA,AGCGC,CGAGA,CGAGC,CGCGA,CGCGC}ACGTACGT{A,C}\n");
+    }
+
+    // A byte cap alone stops a huge product early, without room for all of it
+    LedsBuilder::Symbol left, right, merged;
+    for (int i = 0; i < 20000; i++) {
+        left.strings.push_back("A" + std::to_string(i));
+        right.strings.push_back("C" + std::to_string(i));
+    }
+    MergeLimit bytes_only;
+    bytes_only.max_bytes = 1000;
+    assert(!LedsBuilder::concatenate(left, right, false, bytes_only, merged));
+    assert(merged.strings.size() < 1000 && merged.strings.capacity() < 1000);
+
+    pass();
+}
+
+void test_leds_profile_predicts_transform() {
+    test("l-EDS profile predicts the transform from metadata and sources");
+
+    // Random EDS whose sources partition paths 1-3 among the alternatives
+    std::mt19937 rng(7);
+    std::string eds_str, seds_str;
+    for (int pos = 0; pos < 400; pos++) {
+        if (pos % 2 == 0) {
+            eds_str += "{" + std::string(rng() % 9, 'A') + "}";
+            seds_str += "{0}";
+        } else {
+            std::vector<std::string> paths(2);
+            for (int path = 1; path <= 3; path++) {
+                std::string& set = paths[rng() % 2];
+                set += (set.empty() ? "" : ",") + std::to_string(path);
+            }
+            eds_str += "{" + std::string(rng() % 3, 'C') + "," + std::string(rng() % 3, 'G') + "}";
+            for (const auto& set : paths) {
+                seds_str += "{" + (set.empty() ? "0" : set) + "}";
+            }
+        }
+    }
+
+    auto temp_eds = std::filesystem::temp_directory_path() / "test_leds_profile.eds";
+    auto temp_seds = std::filesystem::temp_directory_path() / "test_leds_profile.seds";
+    std::ofstream(temp_eds) << eds_str;
+    std::ofstream(temp_seds) << seds_str;
+
+    // Linear: exact, with sources in memory or read on demand
+    EDS sourced(eds_str, seds_str);
+    EDS lazy = EDS::load(temp_eds, temp_seds, EDS::StoringMode::METADATA_ONLY);
+    std::vector<LedsProfile> profiles = profile_leds(sourced, 1, 8, 2);
+    assert(profiles.size() == 8);
+    std::vector<LedsProfile> lazy_profiles = profile_leds(lazy, 1, 8);
+    for (const LedsProfile& p : profiles) {
+        std::istringstream in(eds_str), seds(seds_str);
+        std::ostringstream out, sources;
+        eds_to_leds_linear(in, out, p.context_length, &seds, &sources);
+        EDS leds(out.str(), sources.str());
+        assert(p.error.empty());
+        assert(p.n == leds.length() && p.N == leds.size() && p.m == leds.cardinality());
+        assert(p.memory_bytes > 0 && p.peak_window > 0);
+
+        const LedsProfile& q = lazy_profiles[p.context_length - 1];
+        assert(q.n == p.n && q.N == p.N && q.m == p.m && q.peak_cardinality == p.peak_cardinality);
+    }
+
+    // Cartesian: full products, exact when no concatenation repeats
+    EDS plain("{A,C}{G}{A,C,T}{ACGTACGT}{A,}");
+    LedsProfile cartesian = profile_leds(plain, 3, 3)[0];
+    assert(cartesian.n == 3 && cartesian.m == 6 + 1 + 2 && cartesian.N == 6 * 3 + 8 + 1);
+    assert(cartesian.peak_cardinality == 6 && cartesian.peak_window == 3);
+
+    // A path set containing 0 is universal, as in the transform (2 strings in the window)
+    EDS universal("ACGTAC{A,C}G{T,A}ACGTAC", "{0}{1}{2}{0,1}{1}{2}{0}");
+    LedsProfile widened = profile_leds(universal, 3, 3)[0];
+    assert(widened.error.empty() && widened.n == 3 && widened.m == 4);
+
+    // The failure of a linear merge is predicted with the transform's message
+    EDS failing("{A,C}{G}{T,A}{ACGTACGT}", "{1}{2}{0}{3}{3}{0}");
+    LedsProfile failed = profile_leds(failing, 3, 3)[0];
+    assert(failed.error.find("Merging symbols 0 to 2 results in empty set") != std::string::npos);
+
+    bool threw = false;
+    try {
+        profile_leds(plain, 0, 3);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::filesystem::remove(temp_eds);
+    std::filesystem::remove(eds_index::sidecar_path(temp_eds));
+    std::filesystem::remove(temp_seds);
+    pass();
+}
+
+void test_leds_ladder() {
+    test("l-EDS ladder builds each length in one pass, as direct transforms");
+
+    std::mt19937 rng(11);
+    std::string eds_str, seds_str;
+    for (int pos = 0; pos < 300; pos++) {
+        if (pos % 2 == 0) {
+            eds_str += "{" + std::string(rng() % 12, 'A') + "}";
+            seds_str += "{0}";
+        } else {
+            eds_str += "{" + std::string(rng() % 3, 'C') + "," + std::string(rng() % 3, 'G') + "}";
+            seds_str += rng() % 2 ? "{1,2}{3}" : "{1}{2,3}";
+        }
+    }
+    std::vector<Length> lengths = {2, 4, 8};
+
+    for (size_t threads : {size_t(1), size_t(2)}) {
+        std::istringstream in(eds_str), seds(seds_str);
+        std::vector<std::ostringstream> out(lengths.size()), sources(lengths.size());
+        std::vector<std::ostream*> outputs, sources_outputs;
+        for (size_t k = 0; k < lengths.size(); k++) {
+            outputs.push_back(&out[k]);
+            sources_outputs.push_back(&sources[k]);
+        }
+        auto unmerged = eds_to_leds_ladder(in, lengths, outputs, &seds, sources_outputs, threads);
+        assert(unmerged.size() == lengths.size());
+
+        // Every level is the direct transform of the input
+        for (size_t k = 0; k < lengths.size(); k++) {
+            std::istringstream level_in(eds_str), level_seds(seds_str);
+            std::ostringstream expected, expected_sources;
+            eds_to_leds_linear(level_in, expected, lengths[k], &level_seds, &expected_sources);
+            assert(out[k].str() == expected.str());
+            assert(sources[k].str() == expected_sources.str());
+            assert(is_leds(EDS(out[k].str(), sources[k].str()), lengths[k]));
+        }
+    }
+
+    // A window a lower level merges into one string still belongs to the
+    // windows of the higher levels (here {A,A} and {C,C} at l=2)
+    for (const std::string& input : {std::string("T{C,G}AAA{A,A}G{C,C}AAA{C,G}T"), eds_str}) {
+        for (size_t threads : {size_t(1), size_t(2)}) {
+            std::vector<Length> ladder = {2, 5};
+            std::istringstream in(input);
+            std::vector<std::ostringstream> out(ladder.size());
+            std::vector<std::ostream*> outputs = {&out[0], &out[1]};
+            eds_to_leds_ladder(in, ladder, outputs, nullptr, {}, threads);
+            for (size_t k = 0; k < ladder.size(); k++) {
+                std::istringstream level_in(input);
+                std::ostringstream expected;
+                eds_to_leds_cartesian(level_in, expected, ladder[k]);
+                assert(out[k].str() == expected.str());
+            }
+        }
+    }
+
+    // Lengths must be non-zero and increasing, with one output per length
+    std::ostringstream a, b;
+    for (const std::vector<Length>& bad : {std::vector<Length>{4, 2}, std::vector<Length>{0, 2},
+                                          std::vector<Length>{2, 2}, std::vector<Length>{2}}) {
+        std::istringstream in(eds_str);
+        bool threw = false;
+        try {
+            eds_to_leds_ladder(in, bad, {&a, &b});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    pass();
+}
+
+void test_leds_view() {
+    test("Lazy l-EDS view yields the transform's symbols");
+
+    std::string eds_str = "{A,C}{G}{A,C,T}{ACGTACGT}{A,}{TT}{C,G}{GGGGGGGG}{A,T}";
+    std::string seds_str = "{1}{2}{0}{1}{2}{0}{0}{1,2}{0}{0}{1}{2}{0}{1}{2}";
+    auto temp_eds = std::filesystem::temp_directory_path() / "test_leds_view.eds";
+    auto temp_seds = std::filesystem::temp_directory_path() / "test_leds_view.seds";
+    std::ofstream(temp_eds) << eds_str;
+    std::ofstream(temp_seds) << seds_str;
+
+    for (Length l : {Length(1), Length(3), Length(9)}) {
+        // Linear, in both storage modes
+        std::istringstream in(eds_str), seds(seds_str);
+        std::ostringstream out, sources;
+        eds_to_leds_linear(in, out, l, &seds, &sources);
+        EDS expected(out.str(), sources.str());
+
+        EDS loaded(eds_str, seds_str);
+        EDS lazy = EDS::load(temp_eds, temp_seds, EDS::StoringMode::METADATA_ONLY);
+        for (const EDS* eds : {&loaded, &lazy}) {
+            LedsView view(*eds, l);
+            size_t pos = 0, string_id = 0;
+            for (const LedsView::Symbol& symbol : view) {
+                assert(pos < expected.length());
+                assert(symbol.strings == expected.read_symbol(pos));
+                for (const auto& paths : symbol.sources) {
+                    assert(paths == expected.get_string_sources(string_id++));
+                }
+                pos++;
+            }
+            assert(pos == expected.length() && string_id == expected.cardinality());
+        }
+
+        // Cartesian
+        std::istringstream plain_in(eds_str);
+        std::ostringstream plain_out;
+        eds_to_leds_cartesian(plain_in, plain_out, l);
+        EDS plain(eds_str);
+        EDS plain_expected(plain_out.str());
+        LedsView plain_view(plain, l);
+        assert(static_cast<size_t>(std::distance(plain_view.begin(), plain_view.end())) == plain_expected.length());
+        size_t pos = 0;
+        for (const auto& symbol : plain_view) {
+            assert(symbol.sources.empty() && symbol.strings == plain_expected.read_symbol(pos++));
+        }
+    }
+
+    // Copies advance independently
+    EDS plain(eds_str);
+    LedsView view(plain, 3);
+    LedsView::iterator it = view.begin();
+    LedsView::iterator first = it;
+    ++it;
+    LedsView::iterator second = it;
+    ++it;
+    assert(first != second && second != it);
+    assert(first->strings == view.begin()->strings);
+    ++first;
+    assert(first == second && first->strings == second->strings);
+
+    // An empty intersection throws when the iterator reaches it
+    EDS failing("{A,C}{G}{T,A}{ACGTACGT}", "{1}{2}{0}{3}{3}{0}");
+    bool threw = false;
+    try {
+        LedsView failing_view(failing, 3);
+        for (auto iter = failing_view.begin(); iter != failing_view.end(); ++iter) {
+        }
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        LedsView(plain, 0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::filesystem::remove(temp_eds);
+    std::filesystem::remove(eds_index::sidecar_path(temp_eds));
+    std::filesystem::remove(temp_seds);
+    pass();
+}
+
+void test_leds_merge_plan() {
+    test("DP merge plan minimizes the l-EDS cost and runs to an l-EDS");
+
+    // Merging through the anchor leaves 4 strings instead of 5, but 20 characters instead of 7
+    EDS small("{A,C}{GGG}{A,T}");
+    LedsPlan fewer_strings = plan_leds(small, 3, PlanCost::STRINGS);
+    assert(fewer_strings.group_starts == std::vector<Position>({0}));
+    assert(fewer_strings.cost == 4 && fewer_strings.greedy_cost == 5);
+    std::ostringstream merged;
+    eds_to_leds_planned(small, merged, fewer_strings);
+    assert(merged.str() == "{AGGGA,AGGGT,CGGGA,CGGGT}\n");
+
+    LedsPlan fewer_chars = plan_leds(small, 3, PlanCost::CHARACTERS);
+    assert(fewer_chars.group_starts == std::vector<Position>({0, 1, 2}));
+    assert(fewer_chars.cost == 7 && fewer_chars.greedy_cost == 7);
+
+    // Linear: exact costs, never above the streaming transform
+    std::mt19937 rng(5);
+    std::string eds_str, seds_str;
+    for (int pos = 0; pos < 400; pos++) {
+        if (pos % 2 == 0) {
+            eds_str += "{" + std::string(1 + rng() % 10, 'A') + "}";
+            seds_str += "{0}";
+        } else {
+            eds_str += "{" + std::string(rng() % 3, 'C') + "," + std::string(rng() % 3, 'G') + "}";
+            seds_str += rng() % 2 ? "{1,2}{3}" : "{1}{2,3}";
+        }
+    }
+    auto temp_eds = std::filesystem::temp_directory_path() / "test_leds_plan.eds";
+    auto temp_seds = std::filesystem::temp_directory_path() / "test_leds_plan.seds";
+    std::ofstream(temp_eds) << eds_str;
+    std::ofstream(temp_seds) << seds_str;
+    EDS sourced(eds_str, seds_str);
+    EDS lazy = EDS::load(temp_eds, temp_seds, EDS::StoringMode::METADATA_ONLY);
+
+    for (Length l : {Length(4), Length(8)}) {
+        std::istringstream in(eds_str), seds(seds_str);
+        std::ostringstream streamed, streamed_sources;
+        eds_to_leds_linear(in, streamed, l, &seds, &streamed_sources);
+        EDS greedy(streamed.str(), streamed_sources.str());
+
+        // Absorbing no anchor is the streaming transform
+        LedsPlan keep_all = plan_leds(sourced, l, PlanCost::STRINGS, 0);
+        assert(keep_all.cost == keep_all.greedy_cost && keep_all.cost == greedy.cardinality());
+        std::ostringstream out, sources;
+        eds_to_leds_planned(sourced, out, keep_all, &sources);
+        assert(out.str() == streamed.str() && sources.str() == streamed_sources.str());
+
+        for (PlanCost cost : {PlanCost::STRINGS, PlanCost::CHARACTERS}) {
+            LedsPlan plan = plan_leds(sourced, l, cost);
+            LedsPlan lazy_plan = plan_leds(lazy, l, cost);
+            assert(plan.group_starts == lazy_plan.group_starts && plan.cost == lazy_plan.cost);
+            assert(plan.greedy_cost == (cost == PlanCost::STRINGS ? greedy.cardinality() : greedy.size()));
+            assert(plan.cost <= plan.greedy_cost);
+
+            std::ostringstream planned, planned_sources;
+            eds_to_leds_planned(lazy, planned, plan, &planned_sources);
+            EDS leds(planned.str(), planned_sources.str());
+            assert(is_leds(leds, l));
+            assert(plan.cost == (cost == PlanCost::STRINGS ? leds.cardinality() : leds.size()));
+        }
+        assert(plan_leds(sourced, l).cost < greedy.cardinality());
+    }
+
+    // Plans must cover the EDS
+    bool threw = false;
+    try {
+        LedsPlan bad = fewer_strings;
+        bad.group_starts = {1, 2};
+        std::ostringstream out;
+        eds_to_leds_planned(small, out, bad);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::filesystem::remove(temp_eds);
+    std::filesystem::remove(eds_index::sidecar_path(temp_eds));
+    std::filesystem::remove(temp_seds);
+    pass();
+}
+
 // ===== MAIN =====
 
 int main() {
@@ -399,6 +992,15 @@ int main() {
     test_merge_at_end();
     test_immutability();
     test_merge_resulting_in_nondegenerate();
+    test_merge_symbols_kernel();
+    test_streaming_leds();
+    test_streaming_leds_universal_paths();
+    test_parallel_leds_matches_sequential();
+    test_leds_dedup_and_merge_limit();
+    test_leds_profile_predicts_transform();
+    test_leds_ladder();
+    test_leds_view();
+    test_leds_merge_plan();
 
     std::cout << "\n===========================================\n";
     std::cout << "All " << test_num << " tests PASSED!\n";
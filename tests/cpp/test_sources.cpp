@@ -5,6 +5,10 @@
 #include <cassert>
 #include <filesystem>
 #include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
 
 void test_simple_sources() {
     std::cout << "Test 1: Simple sEDS parsing... ";
@@ -372,6 +376,256 @@ void test_load_sources_nonexistent_file() {
     std::cout << "PASSED\n";
 }
 
+void test_source_table() {
+    std::cout << "Test 16: Source table (sorted/bitset sets, intersection)... ";
+
+    // 2000 paths: wide sets take the bitset layout, narrow ones stay sorted
+    std::mt19937 rng(13);
+    std::vector<std::set<int>> sets;
+    for (int k = 0; k < 64; k++) {
+        std::set<int> set;
+        size_t target = (k % 2 == 0) ? 1000 + rng() % 800 : 1 + rng() % 20;
+        while (set.size() < target) {
+            set.insert(1 + static_cast<int>(rng() % 2000));
+        }
+        sets.push_back(set);
+    }
+    sets.push_back({0});
+    sets.push_back({0, 5});
+
+    edsparser::SourceTable table(sets);
+    assert(table.size() == sets.size());
+    assert(table.to_sets() == sets);
+    assert(table[0].is_dense());
+    assert(!table[1].is_dense());
+    assert(table[sets.size() - 2].is_universal());
+
+    // Reference semantics: {0} is the identity, {0} ∩ {0} = {0}
+    auto reference = [](const std::set<int>& a, const std::set<int>& b) {
+        if (a.count(0) && b.count(0)) return std::set<int>{0};
+        if (a.count(0)) return b;
+        if (b.count(0)) return a;
+        std::set<int> out;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(out, out.end()));
+        return out;
+    };
+
+    for (size_t a = 0; a < sets.size(); a++) {
+        for (size_t b = 0; b < sets.size(); b++) {
+            edsparser::SourceSet result = table.intersect(table[a], table[b]);
+            std::set<int> expected = reference(sets[a], sets[b]);
+            assert(result.size() == expected.size());
+            std::set<int> got;
+            table.for_each_path(result, [&](int path_id) { got.insert(path_id); });
+            assert(got == expected);
+        }
+    }
+
+    // Flattened construction sorts and drops duplicates
+    edsparser::SourceTable flat({2, 3}, {7, 3, 9, 9, 3});
+    assert(flat.to_set(0) == (std::set<int>{3, 7}));
+    assert(flat.to_set(1) == (std::set<int>{3, 9}));
+    assert(flat.num_paths() == 3);
+
+    bool caught = false;
+    try {
+        edsparser::SourceTable bad({4}, {1, 2});
+    } catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    assert(caught);
+
+    // Merging keeps only combinations with shared paths, sources stay in ID form
+    std::stringstream eds_ss("{A,C,G}{T,TT}{G}");
+    std::stringstream seds_ss("{1,2}{0}{1500,3}{2,1500}{3}{0}");
+    edsparser::EDS eds(eds_ss, seds_ss);
+    edsparser::EDS merged = eds.merge_adjacent(0, 1);
+    assert(merged.get_symbol_size(0) == 5);  // A+TT has no shared path
+    assert(merged.symbol_view(0).to_set() == (edsparser::StringSet{"AT", "CT", "CTT", "GT", "GTT"}));
+    const auto& merged_sources = merged.get_sources();
+    assert(merged_sources.size() == 6);
+    assert(merged_sources[0] == (std::set<int>{2}));
+    assert(merged_sources[1] == (std::set<int>{2, 1500}));
+    assert(merged_sources[2] == (std::set<int>{3}));
+    assert(merged_sources[3] == (std::set<int>{1500}));
+    assert(merged_sources[4] == (std::set<int>{3}));
+    assert(merged_sources[5] == (std::set<int>{0}));
+
+    std::cout << "PASSED\n";
+}
+
+void test_compact_source_formats() {
+    std::cout << "Test 17: Range and binary sEDS formats... ";
+
+    // Runs of consecutive IDs: 1-500 and 502, a pair, singletons and the {0} marker
+    std::stringstream eds_ss("{ACGT}{A,C,G}{T}");
+    std::stringstream seds_ss("{0}{1-500,502}{501, 503-504}{7,9}{0}");
+    edsparser::EDS eds(eds_ss, seds_ss);
+
+    const auto& sources = eds.get_sources();
+    assert(sources[1].size() == 501);
+    assert(sources[1].count(1) && sources[1].count(500) && sources[1].count(502) && !sources[1].count(501));
+    assert(sources[2] == (std::set<int>{501, 503, 504}));
+
+    // Plain text stays one ID per entry; ranges collapse runs of 3 or more
+    std::ostringstream text;
+    eds.save_sources(text);
+    assert(text.str().find("{1,2,3,") != std::string::npos);
+
+    std::ostringstream ranges;
+    eds.save_sources(ranges, edsparser::EDS::SourcesFormat::RANGES);
+    assert(ranges.str() == "{0}{1-500,502}{501,503,504}{7,9}{0}\n");
+
+    std::ostringstream binary;
+    eds.save_sources(binary, edsparser::EDS::SourcesFormat::BINARY);
+    assert(binary.str().size() < ranges.str().size() + sizeof(edsparser::seds::Header));
+    assert(edsparser::seds::is_binary(binary.str().data(), binary.str().size()));
+
+    // Every encoding loads back to the same sets
+    for (const std::string& encoded : {text.str(), ranges.str(), binary.str()}) {
+        edsparser::EDS reloaded("{ACGT}{A,C,G}{T}");
+        reloaded.load_sources(encoded);
+        assert(reloaded.get_sources() == sources);
+    }
+
+    // .sedz paths are written as binary and detected on load
+    std::filesystem::path temp_dir = std::filesystem::temp_directory_path();
+    std::filesystem::path sedz_path = temp_dir / "test_sources_compact.sedz";
+    eds.save_sources(sedz_path);
+    {
+        std::ifstream in(sedz_path, std::ios::binary);
+        std::string bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        assert(bytes == binary.str());
+    }
+    edsparser::EDS from_file("{ACGT}{A,C,G}{T}");
+    from_file.load_sources(sedz_path);
+    assert(from_file.get_sources() == sources);
+    std::filesystem::remove(sedz_path);
+
+    // Malformed ranges and truncated binary input are rejected
+    auto rejects = [](const std::string& encoded) {
+        edsparser::EDS target("{ACGT}{A,C,G}{T}");
+        try {
+            target.load_sources(encoded);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(rejects("{0}{5-3}{1}{2}{0}"));
+    assert(rejects("{0}{1-}{1}{2}{0}"));
+    assert(rejects("{0}{1--3}{1}{2}{0}"));
+    assert(rejects(binary.str().substr(0, binary.str().size() - 1)));
+
+    bool caught = false;
+    try {
+        edsparser::seds::parse_format("gzip");
+    } catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    assert(caught);
+
+    std::cout << "PASSED\n";
+}
+
+void test_lazy_sources_metadata_only() {
+    std::cout << "Test 18: On-demand sources in METADATA_ONLY mode... ";
+
+    // {ACGT}{A,C} repeated; path p (1..3) takes A at site k when (p + k) % 3 != 0,
+    // so some pairs of adjacent choices share no path
+    const size_t sites = 6000;
+    std::string eds_text;
+    std::string seds_text;
+    for (size_t k = 0; k < sites; k++) {
+        eds_text += "{ACGT}{A,C}";
+        std::string a;
+        std::string c;
+        for (int path = 1; path <= 3; path++) {
+            std::string& target = ((path + k) % 3 != 0) ? a : c;
+            target += (target.empty() ? "" : ",") + std::to_string(path);
+        }
+        seds_text += "{0}{" + a + "}{" + c + "}";
+    }
+
+    std::filesystem::path temp_dir = std::filesystem::temp_directory_path();
+    std::filesystem::path eds_path = temp_dir / "test_lazy_sources.eds";
+    std::filesystem::path seds_path = temp_dir / "test_lazy_sources.seds";
+    std::filesystem::path sedz_path = temp_dir / "test_lazy_sources.sedz";
+    std::ofstream(eds_path) << eds_text;
+    std::ofstream(seds_path) << seds_text;
+
+    auto full = edsparser::EDS::load(eds_path, seds_path, edsparser::EDS::StoringMode::FULL);
+    full.save_sources(sedz_path);
+    assert(!full.has_lazy_sources());
+
+    for (const auto& sources_path : {seds_path, sedz_path}) {
+        // A 1-byte budget keeps one block per shard, so blocks are decoded again and again
+        auto lazy = edsparser::EDS::load(eds_path, sources_path, edsparser::EDS::StoringMode::METADATA_ONLY, 1);
+        assert(lazy.has_lazy_sources());
+
+        auto full_stats = full.get_statistics();
+        auto lazy_stats = lazy.get_statistics();
+        assert(lazy_stats.num_paths == full_stats.num_paths);
+        assert(lazy_stats.max_paths_per_string == full_stats.max_paths_per_string);
+        assert(lazy_stats.avg_paths_per_string == full_stats.avg_paths_per_string);
+
+        // Path-aware check_position agrees with the loaded sources everywhere
+        size_t valid = 0;
+        for (size_t k = 0; k + 1 < sites; k++) {
+            for (int c1 = 0; c1 < 2; c1++) {
+                for (int c2 = 0; c2 < 2; c2++) {
+                    std::vector<int> choices = {static_cast<int>(2 * k) + c1, static_cast<int>(2 * k + 2) + c2};
+                    std::string pattern = std::string("ACGT") + "AC"[c1] + "ACGT" + "AC"[c2];
+                    bool expected = full.check_position(4 * k, choices, pattern);
+                    assert(lazy.check_position(4 * k, choices, pattern) == expected);
+                    valid += expected ? 1 : 0;
+                }
+            }
+        }
+        assert(valid > 0 && valid < 4 * (sites - 1));
+        assert(lazy.get_source_cache_stats().evictions > 0);
+
+        // Whole-table operations decode everything
+        assert(lazy.get_sources() == full.get_sources());
+        std::ostringstream full_out;
+        std::ostringstream lazy_out;
+        full.save_sources(full_out);
+        lazy.save_sources(lazy_out);
+        assert(lazy_out.str() == full_out.str());
+        assert(lazy.merge_adjacent(1, 2).get_sources() == full.merge_adjacent(1, 2).get_sources());
+
+        bool caught = false;
+        try {
+            lazy.get_source_table();
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        assert(caught);
+    }
+
+    // load_sources on a METADATA_ONLY instance indexes too, and checks the cardinality
+    auto metadata_only = edsparser::EDS::load(eds_path, edsparser::EDS::StoringMode::METADATA_ONLY);
+    metadata_only.load_sources(sedz_path);
+    assert(metadata_only.has_lazy_sources());
+    assert(metadata_only.get_sources() == full.get_sources());
+
+    std::ofstream(seds_path) << "{0}{1}";
+    bool caught = false;
+    try {
+        metadata_only.load_sources(seds_path);
+    } catch (const std::runtime_error& e) {
+        caught = std::string(e.what()).find("does not match EDS cardinality") != std::string::npos;
+    }
+    assert(caught);
+
+    std::filesystem::remove(eds_path);
+    std::filesystem::remove(edsparser::eds_index::sidecar_path(eds_path));
+    std::filesystem::remove(seds_path);
+    std::filesystem::remove(sedz_path);
+
+    std::cout << "PASSED\n";
+}
+
 int main() {
     std::cout << "Running sEDS (source) parsing tests...\n\n";
 
@@ -391,6 +645,9 @@ int main() {
         test_load_sources_from_file();
         test_roundtrip_sources_file();
         test_load_sources_nonexistent_file();
+        test_source_table();
+        test_compact_source_formats();
+        test_lazy_sources_metadata_only();
 
         std::cout << "\n✓ All source tests passed!\n";
         return 0;
@@ -90,6 +90,7 @@ void test_metadata_statistics() {
 
     // Cleanup
     std::filesystem::remove(temp_file);
+    std::filesystem::remove(eds_index::sidecar_path(temp_file));
 
     std::cout << "PASSED\n";
 }